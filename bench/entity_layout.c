@@ -0,0 +1,226 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/entity_layout.c — AoS vs hot/cold SoA entity storage.
+ *
+ * Replays the two per-tick access patterns of the game loop against the
+ * old 14-int Ent record and the EntHot/EntCold split main.c stores its
+ * entities in (entity.h):
+ *
+ *   scan  — nearest-enemy linear scan (alive, civ, x, y only)
+ *   tick  — unit bookkeeping (cooldowns, age, flee check against max_hp)
+ *
+ * Build:  make bench
+ * Run:    ./bench/entity_layout
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../entity.h"
+
+#define NCIV      4
+#define PROBES   64      /* searchers per scan pass */
+#define MIN_TIME 0.25    /* seconds of repetitions per measurement */
+
+/* The pre-SoA record from main.c. */
+typedef struct {
+    int alive, kind, civ, x, y, hp, max_hp, atk;
+    int state, target, move_cd, atk_cd, spawn_timer, age;
+} EntAoS;
+
+static volatile long sink;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *xcalloc(size_t n, size_t size)
+{
+    void *p = calloc(n, size);
+    if (!p) { fprintf(stderr, "entity_layout: out of memory\n"); exit(1); }
+    return p;
+}
+
+/* ---- AoS kernels ---------------------------------------------------- */
+static long scan_aos(const EntAoS *e, int n)
+{
+    long acc = 0;
+    for (int p = 0; p < PROBES; p++) {
+        const EntAoS *me = &e[(p * 7919) % n];
+        int best = -1, bd = 1 << 30;
+        for (int i = 0; i < n; i++) {
+            if (!e[i].alive || e[i].civ == me->civ) continue;
+            int dx = e[i].x - me->x, dy = e[i].y - me->y;
+            int d = dx * dx + dy * dy;
+            if (d < bd) { bd = d; best = i; }
+        }
+        acc += best;
+    }
+    return acc;
+}
+
+static long tick_aos(EntAoS *e, int n)
+{
+    long flee = 0;
+    for (int i = 0; i < n; i++) {
+        if (!e[i].alive) continue;
+        if (e[i].move_cd > 0) e[i].move_cd--;
+        if (e[i].atk_cd  > 0) e[i].atk_cd--;
+        e[i].age++;
+        if (e[i].hp < e[i].max_hp / 4) { e[i].state = 3; flee++; }
+    }
+    return flee;
+}
+
+/* ---- SoA kernels ---------------------------------------------------- */
+static long scan_soa(const EntHot *h, int n)
+{
+    long acc = 0;
+    for (int p = 0; p < PROBES; p++) {
+        int me = (p * 7919) % n;
+        int mx = h->x[me], my = h->y[me], mc = h->civ[me];
+        int best = -1, bd = 1 << 30;
+        for (int i = 0; i < n; i++) {
+            if (!h->alive[i] || h->civ[i] == mc) continue;
+            int dx = h->x[i] - mx, dy = h->y[i] - my;
+            int d = dx * dx + dy * dy;
+            if (d < bd) { bd = d; best = i; }
+        }
+        acc += best;
+    }
+    return acc;
+}
+
+/* uint8_t stores may alias anything, so the arrays are hoisted into
+   restrict locals or every store would force the others to reload. */
+static long tick_soa(EntHot *h, EntCold *c, int n)
+{
+    const uint8_t *restrict alive   = h->alive;
+    uint8_t       *restrict move_cd = h->move_cd;
+    uint8_t       *restrict atk_cd  = h->atk_cd;
+    uint8_t       *restrict state   = h->state;
+    const int16_t *restrict hp      = h->hp;
+    const int16_t *restrict max_hp  = c->max_hp;
+    int32_t       *restrict age     = c->age;
+    long flee = 0;
+    for (int i = 0; i < n; i++) {
+        if (!alive[i]) continue;
+        if (move_cd[i] > 0) move_cd[i]--;
+        if (atk_cd[i]  > 0) atk_cd[i]--;
+        age[i]++;
+        if (hp[i] < max_hp[i] / 4) { state[i] = 3; flee++; }
+    }
+    return flee;
+}
+
+/* ---- driver ----------------------------------------------------------- */
+typedef struct {
+    EntAoS  *aos;
+    EntHot   hot;
+    EntCold  cold;
+    int      n;
+} Layouts;
+
+static void layouts_init(Layouts *L, int n)
+{
+    L->n   = n;
+    L->aos = xcalloc((size_t)n, sizeof(*L->aos));
+    L->hot.alive   = xcalloc((size_t)n, 1);
+    L->hot.kind    = xcalloc((size_t)n, 1);
+    L->hot.state   = xcalloc((size_t)n, 1);
+    L->hot.move_cd = xcalloc((size_t)n, 1);
+    L->hot.atk_cd  = xcalloc((size_t)n, 1);
+    L->hot.civ     = xcalloc((size_t)n, sizeof(int8_t));
+    L->hot.x       = xcalloc((size_t)n, sizeof(int16_t));
+    L->hot.y       = xcalloc((size_t)n, sizeof(int16_t));
+    L->hot.hp      = xcalloc((size_t)n, sizeof(int16_t));
+    L->hot.target  = xcalloc((size_t)n, sizeof(EntRef));
+    L->hot.gen     = xcalloc((size_t)n, sizeof(uint16_t));
+    L->cold.max_hp      = xcalloc((size_t)n, sizeof(int16_t));
+    L->cold.atk         = xcalloc((size_t)n, sizeof(int16_t));
+    L->cold.spawn_timer = xcalloc((size_t)n, sizeof(int16_t));
+    L->cold.age         = xcalloc((size_t)n, sizeof(int32_t));
+
+    /* Same world density as the default 120x55 map with 1500 slots */
+    int side = 8;
+    while ((long)side * side < (long)n * 4) side *= 2;
+    if (side > 4096) side = 4096;
+    srand(12345);
+    for (int i = 0; i < n; i++) {
+        int alive = rand() % 10 != 0;
+        int civ   = rand() % (NCIV + 1) - 1;
+        int x = rand() % side, y = rand() % side;
+        int hp = 1 + rand() % 40, move_cd = rand() % 4, atk_cd = rand() % 6;
+        EntAoS *a = &L->aos[i];
+        a->alive = alive; a->civ = civ; a->x = x; a->y = y;
+        a->hp = hp; a->max_hp = 40; a->atk = 8;
+        a->move_cd = move_cd; a->atk_cd = atk_cd; a->target = -1;
+        L->hot.alive[i] = (uint8_t)alive;  L->hot.civ[i] = (int8_t)civ;
+        L->hot.x[i] = (int16_t)x;          L->hot.y[i] = (int16_t)y;
+        L->hot.hp[i] = (int16_t)hp;        L->cold.max_hp[i] = 40;
+        L->cold.atk[i] = 8;
+        L->hot.move_cd[i] = (uint8_t)move_cd;
+        L->hot.atk_cd[i]  = (uint8_t)atk_cd;
+    }
+}
+
+static void layouts_free(Layouts *L)
+{
+    free(L->aos);
+    free(L->hot.alive); free(L->hot.kind); free(L->hot.state);
+    free(L->hot.move_cd); free(L->hot.atk_cd); free(L->hot.civ);
+    free(L->hot.x); free(L->hot.y); free(L->hot.hp);
+    free(L->hot.target); free(L->hot.gen);
+    free(L->cold.max_hp); free(L->cold.atk);
+    free(L->cold.spawn_timer); free(L->cold.age);
+}
+
+/* Nanoseconds per entity visited by one pass of `kernel`. */
+enum { K_SCAN_AOS, K_SCAN_SOA, K_TICK_AOS, K_TICK_SOA };
+static double measure(Layouts *L, int kernel)
+{
+    long reps = 0;
+    double t0 = now_sec(), el;
+    do {
+        switch (kernel) {
+            case K_SCAN_AOS: sink += scan_aos(L->aos, L->n);             break;
+            case K_SCAN_SOA: sink += scan_soa(&L->hot, L->n);            break;
+            case K_TICK_AOS: sink += tick_aos(L->aos, L->n);             break;
+            case K_TICK_SOA: sink += tick_soa(&L->hot, &L->cold, L->n);  break;
+        }
+        reps++;
+        el = now_sec() - t0;
+    } while (el < MIN_TIME);
+    long visits = (kernel == K_SCAN_AOS || kernel == K_SCAN_SOA)
+                  ? (long)PROBES * L->n : (long)L->n;
+    return el * 1e9 / ((double)reps * (double)visits);
+}
+
+int main(void)
+{
+    static const int sizes[] = { 1500, 100000 };
+    printf("%-8s %-6s %12s %12s %8s\n", "entities", "kernel", "AoS ns/ent", "SoA ns/ent", "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        Layouts L;
+        layouts_init(&L, sizes[s]);
+        double sa = measure(&L, K_SCAN_AOS), ss = measure(&L, K_SCAN_SOA);
+        double ta = measure(&L, K_TICK_AOS), ts = measure(&L, K_TICK_SOA);
+        printf("%-8d %-6s %12.3f %12.3f %7.2fx\n", L.n, "scan", sa, ss, sa / ss);
+        printf("%-8d %-6s %12.3f %12.3f %7.2fx\n", L.n, "tick", ta, ts, ta / ts);
+        layouts_free(&L);
+    }
+    printf("bytes/entity: AoS %zu, SoA hot %zu + cold %zu\n",
+           sizeof(EntAoS),
+           5 * sizeof(uint8_t) + sizeof(int8_t) + 3 * sizeof(int16_t)
+             + sizeof(uint32_t) + sizeof(uint16_t),
+           3 * sizeof(int16_t) + sizeof(int32_t));
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/flock_grid.c — All-pairs flocking vs the cell-sorted grid, and
+ * three flocking kernels vs move_flock_combined.
+ *
+ * Scatters agents uniformly over a square sized for a fixed density (the
+ * same as bench/sim_world.h: 2048 agents on 256 x 256), then runs one
+ * flocking tick each way on its own copy and checks every copy's
+ * accelerations match the first bit for bit.  Grid times include the
+ * build.
+ *
+ * Build:  make bench
+ * Run:    ./bench/flock_grid [agents] [radius]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../simulation.h"
+
+#define DENSITY (2048.0 / (256.0 * 256.0))
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fill(float *a, int n, float lo, float hi)
+{
+    for (int i = 0; i < n; i++)
+        a[i] = lo + (hi - lo) * (float)rand() / ((float)RAND_MAX + 1.0f);
+}
+
+static MoveSoA *agents(int n)
+{
+    MoveSoA *m = move_soa_create(n);
+    if (!m) {
+        fprintf(stderr, "flock_grid: out of memory\n");
+        exit(1);
+    }
+    float side = (float)sqrt(n / DENSITY);
+    srand(99);
+    fill(m->pos_x, n, 0, side);
+    fill(m->pos_y, n, 0, side);
+    fill(m->vel_x, n, -1, 1);
+    fill(m->vel_y, n, -1, 1);
+    return m;
+}
+
+/* Per-term radii: separation is the short-range term. */
+#define SEP_R(r) ((r) * 0.5f)
+
+static double flock(MoveSoA *m, MoveGrid *g, float radius, int combined)
+{
+    double t0 = now_sec();
+    if (g) move_grid_build(g, m, radius);
+    if (combined) {
+        move_flock_combined(m, g, SEP_R(radius), 0.1f, radius, 0.05f, radius, 0.01f);
+    } else {
+        move_flock_separation(m, g, SEP_R(radius), 0.1f);
+        move_flock_alignment(m, g, radius, 0.05f);
+        move_flock_cohesion(m, g, radius, 0.01f);
+    }
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv)
+{
+    int   n      = argc > 1 ? atoi(argv[1]) : 50000;
+    float radius = argc > 2 ? (float)atof(argv[2]) : 6.0f;
+    if (n < 1 || !(radius > 0.0f)) {
+        fprintf(stderr, "usage: %s [agents] [radius]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct { const char *search, *kernels; int grid, combined; } runs[] = {
+        { "all pairs", "separate", 0, 0 },
+        { "all pairs", "combined", 0, 1 },
+        { "grid",      "separate", 1, 0 },
+        { "grid",      "combined", 1, 1 },
+    };
+    MoveSoA *ref = NULL;
+    MoveGrid grid = { 0 };
+    double   t0   = 0.0;
+    int      same = 1;
+    printf("%d agents, radius %.1f (separation %.1f), %s vector path\n", n, radius,
+           SEP_R(radius), sim_isa_name(sim_isa_active()));
+    printf("%-10s %-9s %12s\n", "search", "kernels", "ms/tick");
+    for (int r = 0; r < 4; r++) {
+        MoveSoA *m = agents(n);
+        double   t = flock(m, runs[r].grid ? &grid : NULL, radius, runs[r].combined);
+        int      ok = 1;
+        if (!ref) {
+            ref = m;
+            t0  = t;
+        } else {
+            ok = memcmp(ref->acc_x, m->acc_x, (size_t)n * sizeof(float)) == 0 &&
+                 memcmp(ref->acc_y, m->acc_y, (size_t)n * sizeof(float)) == 0;
+            move_soa_destroy(m);
+        }
+        printf("%-10s %-9s %12.3f  (%.1fx)%s\n", runs[r].search, runs[r].kernels,
+               t * 1e3, t0 / t, ok ? "" : "  DIFFER");
+        same &= ok;
+    }
+    printf("results   %s\n", same ? "identical" : "DIFFER");
+
+    move_grid_free(&grid);
+    move_soa_destroy(ref);
+    return same ? 0 : 1;
+}
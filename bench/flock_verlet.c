@@ -0,0 +1,135 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/flock_verlet.c — Rebuilding the flocking grid every tick vs
+ * Verlet neighbour lists kept by move_grid_update.
+ *
+ * Scatters agents at the same density as bench/flock_grid, then runs the
+ * same ticks (grid, move_flock_combined, one AoE strike, integrate) on a
+ * copy per run.  Every run must end with positions and hit points
+ * identical to the first bit for bit; the time per tick includes the grid
+ * or list upkeep.
+ *
+ * Build:  make bench
+ * Run:    ./bench/flock_verlet [agents] [ticks] [radius] [skin]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../simulation.h"
+
+#define DENSITY (2048.0 / (256.0 * 256.0))
+#define DT      0.05f
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fill(float *a, int n, float lo, float hi)
+{
+    for (int i = 0; i < n; i++)
+        a[i] = lo + (hi - lo) * (float)rand() / ((float)RAND_MAX + 1.0f);
+}
+
+static void setup(int n, float *side, MoveSoA **mp, CombatSoA **cp)
+{
+    MoveSoA   *m = move_soa_create(n);
+    CombatSoA *c = combat_soa_create(n);
+    if (!m || !c) {
+        fprintf(stderr, "flock_verlet: out of memory\n");
+        exit(1);
+    }
+    *side = (float)sqrt(n / DENSITY);
+    srand(99);
+    fill(m->pos_x, n, 0, *side);
+    fill(m->pos_y, n, 0, *side);
+    fill(m->vel_x, n, -1, 1);
+    fill(m->vel_y, n, -1, 1);
+    fill(m->max_speed, n, 1, 2);
+    fill(c->max_hp, n, 50, 100);
+    memcpy(c->hp, c->max_hp, (size_t)n * sizeof(float));
+    *mp = m;
+    *cp = c;
+}
+
+/* One tick; skin <= 0 rebuilds the grid from scratch. */
+static void tick(MoveSoA *m, CombatSoA *c, MoveGrid *g, float radius, float skin,
+                 float side, int t)
+{
+    if (skin > 0.0f)
+        move_grid_update(g, m, radius, skin);
+    else
+        move_grid_build(g, m, radius);
+    memset(m->acc_x, 0, (size_t)m->count * sizeof(float));
+    memset(m->acc_y, 0, (size_t)m->count * sizeof(float));
+    move_flock_combined(m, g, radius * 0.5f, 0.1f, radius, 0.05f, radius, 0.01f);
+    float f = (float)(t % 17) / 17.0f;
+    combat_aoe_damage(c, m->pos_x, m->pos_y, g, side * f, side * (1.0f - f), 12.0f, 3.0f);
+    move_velocity_verlet(m, DT);
+    move_clamp_speed(m);
+}
+
+int main(int argc, char **argv)
+{
+    int   n      = argc > 1 ? atoi(argv[1]) : 50000;
+    int   ticks  = argc > 2 ? atoi(argv[2]) : 100;
+    float radius = argc > 3 ? (float)atof(argv[3]) : 6.0f;
+    float skin   = argc > 4 ? (float)atof(argv[4]) : 1.0f;
+    if (n < 1 || ticks < 1 || !(radius > 0.0f) || !(skin > 0.0f)) {
+        fprintf(stderr, "usage: %s [agents] [ticks] [radius] [skin]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct { const char *name; int verlet; } runs[] = {
+        { "rebuild",     0 },
+        { "verlet list", 1 },
+    };
+    MoveSoA   *ref_m = NULL;
+    CombatSoA *ref_c = NULL;
+    double     t0    = 0.0;
+    int        same  = 1;
+    printf("%d agents, %d ticks, radius %.1f, skin %.2f, %s vector path\n", n, ticks,
+           radius, skin, sim_isa_name(sim_isa_active()));
+    printf("%-12s %12s %9s\n", "neighbours", "ms/tick", "builds");
+    for (int r = 0; r < 2; r++) {
+        MoveSoA   *m;
+        CombatSoA *c;
+        MoveGrid   g = { 0 };
+        float      side;
+        setup(n, &side, &m, &c);
+        double start = now_sec();
+        for (int t = 0; t < ticks; t++)
+            tick(m, c, &g, radius, runs[r].verlet ? skin : 0.0f, side, t);
+        double dt = (now_sec() - start) / ticks;
+        int    ok = 1;
+        if (!ref_m) {
+            ref_m = m;
+            ref_c = c;
+            t0    = dt;
+        } else {
+            ok = memcmp(ref_m->pos_x, m->pos_x, (size_t)n * sizeof(float)) == 0 &&
+                 memcmp(ref_m->pos_y, m->pos_y, (size_t)n * sizeof(float)) == 0 &&
+                 memcmp(ref_c->hp, c->hp, (size_t)n * sizeof(float)) == 0;
+            move_soa_destroy(m);
+            combat_soa_destroy(c);
+        }
+        printf("%-12s %12.3f %9d  (%.1fx)%s\n", runs[r].name, dt * 1e3,
+               runs[r].verlet ? g.builds : ticks, t0 / dt, ok ? "" : "  DIFFER");
+        same &= ok;
+        move_grid_free(&g);
+    }
+    printf("results      %s\n", same ? "identical" : "DIFFER");
+
+    move_soa_destroy(ref_m);
+    combat_soa_destroy(ref_c);
+    return same ? 0 : 1;
+}
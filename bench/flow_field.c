@@ -0,0 +1,184 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/flow_field.c — Incremental flow-field updates vs rebuilding, and
+ * one field vs an A* search per walker.
+ *
+ * Builds a map of walls and round lakes with a few dozen sources, then
+ * applies a stream of random edits (sources added and removed, tiles
+ * blocked and opened).  After every edit the incrementally updated field
+ * must hold exactly the distances of a field rebuilt from scratch, and
+ * every direction must lead one step closer.  Then times answering the
+ * same walkers with the field against planning each with path_find.
+ *
+ * Build:  make bench
+ * Run:    ./bench/flow_field [side] [edits] [sources]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../path.h"
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void build_map(PathMap *pm, int side)
+{
+    for (int y = 0; y < side; y++)
+        for (int x = 0; x < side; x++)
+            path_map_set(pm, x, y, rand() % 100 >= 20);
+    for (int l = 0; l < side / 8; l++) {
+        int cx = rand() % side, cy = rand() % side, r = 3 + rand() % 12;
+        for (int y = cy - r; y <= cy + r; y++)
+            for (int x = cx - r; x <= cx + r; x++)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    path_map_set(pm, x, y, 0);
+    }
+}
+
+/* Whether field 0 of `got` matches `want` and every direction steps one
+   closer. */
+static int check(const FlowSet *got, const FlowSet *want, const PathMap *pm)
+{
+    int side = pm->w;
+    for (int y = 0; y < side; y++)
+        for (int x = 0; x < side; x++) {
+            int d = flow_dist(got, 0, x, y);
+            if (d != flow_dist(want, 0, x, y)) return 0;
+            if (d == 0 || d == FLOW_FAR) continue;
+            int k = flow_dir(got, 0, x, y);
+            if (k == FLOW_NO_DIR) return 0;
+            int nx = x + path_dx[k], ny = y + path_dy[k];
+            if (nx < 0 || nx >= side || ny < 0 || ny >= side) return 0;
+            if (flow_dist(got, 0, nx, ny) != d - 1) return 0;
+        }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int side  = argc > 1 ? atoi(argv[1]) : 256;
+    int edits = argc > 2 ? atoi(argv[2]) : 400;
+    int nsrc  = argc > 3 ? atoi(argv[3]) : 24;
+    if (side < 16 || side > 4096 || edits < 1 || nsrc < 1) {
+        fprintf(stderr, "usage: %s [side] [edits] [sources]\n", argv[0]);
+        return 2;
+    }
+
+    PathMap pm;
+    FlowSet fs, ref;
+    int    *src = malloc((size_t)(nsrc + edits) * 2 * sizeof(int));
+    if (!src || path_map_init(&pm, side, side) != 0 || flow_init(&fs, side, side, 1) != 0) {
+        fprintf(stderr, "flow_field: out of memory\n");
+        return 1;
+    }
+    srand(23);
+    build_map(&pm, side);
+    int n = 0;
+    while (n < nsrc) {
+        int x = rand() % side, y = rand() % side;
+        if (flow_dist(&fs, 0, x, y) == 0) continue;
+        flow_add_source(&fs, &pm, 0, x, y);
+        src[2 * n]     = x;
+        src[2 * n + 1] = y;
+        n++;
+    }
+
+    double t_inc = 0.0, t_full = 0.0;
+    int    ok    = 1;
+    for (int e = 0; e < edits && ok; e++) {
+        int    kind = rand() % 4, x = rand() % side, y = rand() % side;
+        double t0   = now_sec();
+        if (kind == 0 && flow_dist(&fs, 0, x, y) != 0) {
+            flow_add_source(&fs, &pm, 0, x, y);
+            src[2 * n] = x;
+            src[2 * n + 1] = y;
+            n++;
+        } else if (kind == 1 && n > 0) {
+            int k = rand() % n;
+            flow_remove_source(&fs, &pm, 0, src[2 * k], src[2 * k + 1]);
+            src[2 * k]     = src[2 * (n - 1)];
+            src[2 * k + 1] = src[2 * (n - 1) + 1];
+            n--;
+        } else if (path_map_set(&pm, x, y, !path_walkable(&pm, x, y))) {
+            flow_tile_changed(&fs, &pm, x, y);
+        }
+        t_inc += now_sec() - t0;
+
+        t0 = now_sec();
+        if (flow_init(&ref, side, side, 1) != 0) {
+            fprintf(stderr, "flow_field: out of memory\n");
+            return 1;
+        }
+        for (int k = 0; k < n; k++) flow_add_source(&ref, &pm, 0, src[2 * k], src[2 * k + 1]);
+        t_full += now_sec() - t0;
+        ok = check(&fs, &ref, &pm);
+        flow_free(&ref);
+    }
+
+    /* Walkers on every fourth tile each want their next step home */
+    PathPool    *pool = path_pool_create(1);
+    PathScratch *ps   = pool ? path_pool_acquire(pool) : NULL;
+    int         *who  = malloc((size_t)side * side * sizeof(int));
+    if (!ps || !who) {
+        fprintf(stderr, "flow_field: out of memory\n");
+        return 1;
+    }
+    int walkers = 0;
+    for (int y = 0; y < side; y += 4)
+        for (int x = 0; x < side; x += 4)
+            if (path_walkable(&pm, x, y)) who[walkers++] = y * side + x;
+
+    double t0 = now_sec();
+    int    reached = 0;
+    for (int k = 0; k < walkers; k++) {
+        int x = who[k] % side, y = who[k] / side;
+        reached += flow_dir(&fs, 0, x, y) != FLOW_NO_DIR;
+    }
+    double t_field = now_sec() - t0;
+
+    /* A* needs a goal: the nearest source in a straight line */
+    t0 = now_sec();
+    for (int k = 0; k < walkers; k++) {
+        int  x = who[k] % side, y = who[k] / side, best = -1, nd;
+        long bd = 0;
+        for (int q = 0; q < n; q++) {
+            long dx = src[2 * q] - x, dy = src[2 * q + 1] - y, d2 = dx * dx + dy * dy;
+            if (best < 0 || d2 < bd) {
+                best = q;
+                bd   = d2;
+            }
+        }
+        uint8_t step;
+        if (best >= 0)
+            path_find(&pm, ps, x, y, src[2 * best], src[2 * best + 1], 0, &step, 1, &nd);
+    }
+    double t_astar = now_sec() - t0;
+    path_pool_release(pool, ps);
+
+    printf("%dx%d map, %d edits, %d sources at the end\n", side, side, edits, n);
+    printf("%-12s %12s\n", "upkeep", "us/edit");
+    printf("%-12s %12.2f\n", "rebuild", t_full / edits * 1e6);
+    printf("%-12s %12.2f  (%.1fx)\n", "incremental", t_inc / edits * 1e6, t_full / t_inc);
+    printf("%-12s %12s  (%d walkers, %d with a way home)\n", "next step", "us/walker",
+           walkers, reached);
+    printf("%-12s %12.3f\n", "a*", t_astar / walkers * 1e6);
+    printf("%-12s %12.3f\n", "flow field", t_field / walkers * 1e6);
+    printf("fields       %s\n", ok ? "identical" : "DIFFER");
+
+    path_pool_destroy(pool);
+    flow_free(&fs);
+    path_map_free(&pm);
+    free(who);
+    free(src);
+    return ok ? 0 : 1;
+}
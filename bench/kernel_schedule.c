@@ -0,0 +1,84 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/kernel_schedule.c — Serial vs scheduled simulation.c ticks.
+ *
+ * Builds two identical worlds, runs every registered kernel for a number
+ * of ticks on one with plain in-order calls and on the other through the
+ * dependency-graph scheduler on N threads, then checks that the two
+ * worlds are bit-identical.  Last, one scheduled run of the whole list
+ * REPEATS times over, far longer than the registry, must match calling
+ * the same kernels one at a time.
+ *
+ * Build:  make bench
+ * Run:    ./bench/kernel_schedule [threads] [elements] [movers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../jobs.h"
+#include "sim_world.h"
+
+#define TICKS   20
+#define REPEATS  3
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Seconds per tick over TICKS scheduled ticks. */
+static double run(World *W)
+{
+    double t0 = now_sec();
+    for (int i = 0; i < TICKS; i++) sim_schedule_tick(&W->w, &W->p);
+    return (now_sec() - t0) / TICKS;
+}
+
+int main(int argc, char **argv)
+{
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    int n       = argc > 2 ? atoi(argv[2]) : 1 << 18;
+    int movers  = argc > 3 ? atoi(argv[3]) : 2048;
+    if (threads < 1 || n < 1 || movers < 1) {
+        fprintf(stderr, "usage: %s [threads] [elements] [movers]\n", argv[0]);
+        return 2;
+    }
+
+    World *A = malloc(sizeof(*A)), *B = malloc(sizeof(*B));
+    if (!A || !B) return 1;
+    world_init(A, n, movers);
+    world_init(B, n, movers);
+
+    double serial = run(A);           /* pool not started: plain calls */
+    threads = jobs_init(threads);
+    double sched = run(B);
+
+    int  nk   = sim_kernel_count();
+    int *list = malloc((size_t)nk * REPEATS * sizeof(*list));
+    if (!list) return 1;
+    for (int i = 0; i < nk * REPEATS; i++) list[i] = i % nk;
+    sim_schedule_run(&B->w, &B->p, list, nk * REPEATS);
+    jobs_shutdown();
+    for (int i = 0; i < nk * REPEATS; i++) sim_schedule_run(&A->w, &A->p, &list[i], 1);
+    free(list);
+
+    int same = world_same(A, B);
+
+    printf("%d kernels, %d elements, %d movers, %d ticks, then the list %d times over\n",
+           nk, n, movers, TICKS, REPEATS);
+    printf("serial    %9.3f ms/tick\n", serial * 1e3);
+    printf("%2d thread %9.3f ms/tick  (%.2fx)\n", threads, sched * 1e3, serial / sched);
+    printf("results   %s\n", same ? "identical" : "DIFFER");
+    world_free(A);
+    world_free(B);
+    free(A);
+    free(B);
+    return same ? 0 : 1;
+}
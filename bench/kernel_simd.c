@@ -0,0 +1,137 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/kernel_simd.c — Scalar reference vs vector paths, per kernel.
+ *
+ * For every vector path the CPU supports, builds two identical worlds and
+ * runs each registered kernel REPS times on both: the scalar loops on one,
+ * the vector path on the other.  The kernels with a vector path that the
+ * scheduler does not run (the fused ones and those taking per-call
+ * arguments) are called directly the same way.  Reports ns per element for
+ * each side and fails if the two worlds ever stop being bit-identical.
+ *
+ * Build:  make bench
+ * Run:    ./bench/kernel_simd [elements] [movers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim_world.h"
+
+#define REPS 10
+
+/* Kernels with a vector path outside the registry, called directly */
+static float *aoe_x, *aoe_y;            /* n positions for combat_aoe_damage */
+
+static void d_pop_tick(World *W)          { pop_tick(W->pop, 0.01f, 0.05f); }
+static void d_econ_supply_shock(World *W) { econ_supply_shock(W->econ, 0.1f); }
+static void d_combat_aoe_damage(World *W)
+{
+    combat_aoe_damage(W->combat, aoe_x, aoe_y, NULL, 128.0f, 128.0f, 40.0f, 5.0f);
+}
+static void d_move_flock_combined(World *W)
+{
+    move_flock_combined(W->move, NULL, 3.0f, 0.1f, 6.0f, 0.05f, 6.0f, 0.01f);
+}
+
+static const struct {
+    const char *name;
+    void      (*run)(World *W);
+    int         movers;                 /* sweeps the movers rather than n */
+} DIRECT[] = {
+    { "pop_tick",            d_pop_tick,            0 },
+    { "combat_aoe_damage",   d_combat_aoe_damage,   0 },
+    { "econ_supply_shock",   d_econ_supply_shock,   0 },
+    { "move_flock_combined", d_move_flock_combined, 1 },
+};
+#define NDIRECT ((int)(sizeof(DIRECT) / sizeof(DIRECT[0])))
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Seconds for REPS calls of kernel k on W with `isa` active: registered
+   kernel k, or DIRECT[k - sim_kernel_count()] past the registry. */
+static double run(World *W, SimIsa isa, int k)
+{
+    int nk = sim_kernel_count();
+    sim_isa_select(isa);
+    double t0 = now_sec();
+    for (int r = 0; r < REPS; r++) {
+        if (k < nk) sim_schedule_run(&W->w, &W->p, &k, 1);
+        else        DIRECT[k - nk].run(W);
+    }
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv)
+{
+    int n      = argc > 1 ? atoi(argv[1]) : 1 << 20;
+    int movers = argc > 2 ? atoi(argv[2]) : 2048;
+    if (n < 1 || movers < 1) {
+        fprintf(stderr, "usage: %s [elements] [movers]\n", argv[0]);
+        return 2;
+    }
+
+    SimIsa best = sim_isa_best();
+    printf("%d elements, %d movers, best path %s\n", n, movers, sim_isa_name(best));
+    if (best == SIM_ISA_SCALAR) {
+        printf("no vector path on this CPU\n");
+        return 0;
+    }
+
+    World *A = malloc(sizeof(*A)), *B = malloc(sizeof(*B));
+    aoe_x = malloc((size_t)n * sizeof(*aoe_x));
+    aoe_y = malloc((size_t)n * sizeof(*aoe_y));
+    if (!A || !B || !aoe_x || !aoe_y) return 1;
+    srand(99);
+    for (int i = 0; i < n; i++) {
+        aoe_x[i] = 256.0f * (float)rand() / ((float)RAND_MAX + 1.0f);
+        aoe_y[i] = 256.0f * (float)rand() / ((float)RAND_MAX + 1.0f);
+    }
+    int nk = sim_kernel_count(), ok = 1;
+    for (SimIsa isa = SIM_ISA_SSE42; isa <= best; isa++) {
+        world_init(A, n, movers);
+        world_init(B, n, movers);
+        printf("\n%-28s %12s %12s %8s\n", "kernel", "scalar ns/el", "vector ns/el", "speedup");
+        double tot_s = 0, tot_v = 0;
+        for (int k = 0; k < nk + NDIRECT; k++) {
+            double ts = run(A, SIM_ISA_SCALAR, k);
+            double tv = run(B, isa, k);
+            int same  = world_same(A, B);
+            /* The flocking kernels sweep the movers, everything else n */
+            const char *name = k < nk ? sim_kernel_info(k)->name : DIRECT[k - nk].name;
+            int on_movers    = k < nk ? strncmp(name, "move_", 5) == 0 : DIRECT[k - nk].movers;
+            double els = (double)REPS * (on_movers ? movers : n);
+            printf("%-28s %12.3f %12.3f %7.2fx%s\n", name,
+                   ts * 1e9 / els, tv * 1e9 / els, ts / tv, same ? "" : "  DIFFER");
+            tot_s += ts;
+            tot_v += tv;
+            if (!same) {
+                ok = 0;
+                world_free(A);          /* restart in step for the next kernel */
+                world_free(B);
+                world_init(A, n, movers);
+                world_init(B, n, movers);
+            }
+        }
+        printf("%-28s %12.3f %12.3f %7.2fx  (%s, ms per pass)\n", "all kernels",
+               tot_s * 1e3 / REPS, tot_v * 1e3 / REPS, tot_s / tot_v, sim_isa_name(isa));
+        world_free(A);
+        world_free(B);
+    }
+    free(aoe_y);
+    free(aoe_x);
+    free(A);
+    free(B);
+    printf("\nresults   %s\n", ok ? "identical" : "DIFFER");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/path_astar.c — path_find against a breadth-first search.
+ *
+ * Builds a PATH_WIN x PATH_WIN map (so A* sees all of it) strewn with
+ * walls and round lakes, then plans between random walkable tiles.  A
+ * breadth-first flood from each start gives the true step count to the
+ * goal; every A* path must be exactly that long, walk only on walkable
+ * tiles and end beside the goal, and A* must report PATH_NONE exactly
+ * when the flood never gets there.
+ *
+ * Build:  make bench
+ * Run:    ./bench/path_astar [queries] [wall%]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../path.h"
+
+#define SIDE PATH_WIN
+#define NEAR 1
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void build_map(PathMap *pm, int wall_pct)
+{
+    srand(17);
+    for (int y = 0; y < SIDE; y++)
+        for (int x = 0; x < SIDE; x++)
+            path_map_set(pm, x, y, rand() % 100 >= wall_pct);
+    for (int l = 0; l < 24; l++) {
+        int cx = rand() % SIDE, cy = rand() % SIDE, r = 3 + rand() % 10;
+        for (int y = cy - r; y <= cy + r; y++)
+            for (int x = cx - r; x <= cx + r; x++)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    path_map_set(pm, x, y, 0);
+    }
+}
+
+static void random_tile(const PathMap *pm, int *x, int *y)
+{
+    do {
+        *x = rand() % SIDE;
+        *y = rand() % SIDE;
+    } while (!path_walkable(pm, *x, *y));
+}
+
+/* Fewest steps from (sx, sy) to within NEAR of (gx, gy), or -1. */
+static int bfs(const PathMap *pm, int *dist, int *queue, int sx, int sy, int gx, int gy)
+{
+    for (int i = 0; i < SIDE * SIDE; i++) dist[i] = -1;
+    int head = 0, tail = 0;
+    dist[sy * SIDE + sx] = 0;
+    queue[tail++] = sy * SIDE + sx;
+    while (head < tail) {
+        int c = queue[head++], x = c % SIDE, y = c / SIDE;
+        if (abs(x - gx) <= NEAR && abs(y - gy) <= NEAR) return dist[c];
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (!path_walkable(pm, nx, ny) || dist[ny * SIDE + nx] >= 0) continue;
+            dist[ny * SIDE + nx] = dist[c] + 1;
+            queue[tail++] = ny * SIDE + nx;
+        }
+    }
+    return -1;
+}
+
+/* Whether dirs[0..n) walks from (x, y) on walkable tiles to within NEAR of (gx, gy). */
+static int valid(const PathMap *pm, const uint8_t *dirs, int n, int x, int y, int gx, int gy)
+{
+    for (int k = 0; k < n; k++) {
+        x += path_dx[dirs[k]];
+        y += path_dy[dirs[k]];
+        if (!path_walkable(pm, x, y)) return 0;
+    }
+    return abs(x - gx) <= NEAR && abs(y - gy) <= NEAR;
+}
+
+int main(int argc, char **argv)
+{
+    int queries  = argc > 1 ? atoi(argv[1]) : 20000;
+    int wall_pct = argc > 2 ? atoi(argv[2]) : 25;
+    if (queries < 1 || wall_pct < 0 || wall_pct > 90) {
+        fprintf(stderr, "usage: %s [queries] [wall%%]\n", argv[0]);
+        return 2;
+    }
+
+    PathMap   pm;
+    PathPool *pool  = path_pool_create(1);
+    int      *sx    = malloc((size_t)queries * 4 * sizeof(int));
+    int      *plen  = malloc((size_t)queries * sizeof(int));
+    int      *dist  = malloc((size_t)SIDE * SIDE * sizeof(int));
+    int      *queue = malloc((size_t)SIDE * SIDE * sizeof(int));
+    uint8_t  *dirs  = malloc((size_t)SIDE * SIDE);
+    if (path_map_init(&pm, SIDE, SIDE) != 0 || !pool || !sx || !plen || !dist || !queue ||
+        !dirs) {
+        fprintf(stderr, "path_astar: out of memory\n");
+        return 1;
+    }
+    build_map(&pm, wall_pct);
+    for (int q = 0; q < queries; q++) {
+        random_tile(&pm, &sx[4 * q], &sx[4 * q + 1]);
+        random_tile(&pm, &sx[4 * q + 2], &sx[4 * q + 3]);
+    }
+
+    /* Timed: A* only */
+    PathScratch *ps = path_pool_acquire(pool);
+    int found = 0, none = 0;
+    double t0 = now_sec();
+    for (int q = 0; q < queries; q++) {
+        const int *s = &sx[4 * q];
+        PathStatus st = path_find(&pm, ps, s[0], s[1], s[2], s[3], NEAR, dirs, SIDE * SIDE,
+                                  &plen[q]);
+        if (st == PATH_NONE) plen[q] = -1;
+        found += st == PATH_FOUND;
+        none  += st == PATH_NONE;
+    }
+    double t_astar = now_sec() - t0;
+
+    t0 = now_sec();
+    int ok = 1;
+    for (int q = 0; q < queries && ok; q++) {
+        const int *s = &sx[4 * q];
+        ok = bfs(&pm, dist, queue, s[0], s[1], s[2], s[3]) == plen[q];
+    }
+    double t_bfs = now_sec() - t0;
+
+    /* Untimed: replay each path and check it */
+    for (int q = 0; q < queries && ok; q++) {
+        const int *s = &sx[4 * q];
+        int n;
+        if (path_find(&pm, ps, s[0], s[1], s[2], s[3], NEAR, dirs, SIDE * SIDE, &n) != PATH_NONE)
+            ok = valid(&pm, dirs, n, s[0], s[1], s[2], s[3]);
+    }
+    path_pool_release(pool, ps);
+
+    printf("%dx%d map, %d%% walls, %d queries (%d found, %d unreachable)\n", SIDE, SIDE,
+           wall_pct, queries, found, none);
+    printf("%-10s %12s\n", "search", "us/query");
+    printf("%-10s %12.2f\n", "bfs", t_bfs / queries * 1e6);
+    printf("%-10s %12.2f  (%.1fx)\n", "a*", t_astar / queries * 1e6, t_bfs / t_astar);
+    printf("paths      %s\n", ok ? "shortest" : "WRONG");
+
+    free(dirs);
+    free(queue);
+    free(dist);
+    free(plen);
+    free(sx);
+    path_pool_destroy(pool);
+    path_map_free(&pm);
+    return ok ? 0 : 1;
+}
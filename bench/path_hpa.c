@@ -0,0 +1,208 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/path_hpa.c — Long searches over the cluster graph vs a breadth-
+ * first search of the whole map, and cluster upkeep vs rebuilding.
+ *
+ * Builds a map of walls, round lakes and one walled-in block, far bigger
+ * than the A* window, and plans whole paths between random walkable tiles
+ * at least a window apart.
+ * Every path must walk only on walkable tiles and end beside its goal; a
+ * breadth-first flood gives the true step count, against which the excess
+ * length is reported, and the graph must find a way exactly when the
+ * flood does.  Then flips random tiles, keeping the graph up to date with
+ * hpa_tile_changed/hpa_sync, and checks it against one built from scratch.
+ *
+ * Build:  make bench
+ * Run:    ./bench/path_hpa [side] [queries] [edits]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../path.h"
+
+#define NEAR 1
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void build_map(PathMap *pm, int side)
+{
+    for (int y = 0; y < side; y++)
+        for (int x = 0; x < side; x++)
+            path_map_set(pm, x, y, rand() % 100 >= 20);
+    for (int l = 0; l < side / 8; l++) {
+        int cx = rand() % side, cy = rand() % side, r = 3 + rand() % 12;
+        for (int y = cy - r; y <= cy + r; y++)
+            for (int x = cx - r; x <= cx + r; x++)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    path_map_set(pm, x, y, 0);
+    }
+    /* A walled-in block in the middle, for goals nothing reaches */
+    int lo = side / 2 - side / 12, hi = side / 2 + side / 12;
+    for (int y = lo; y <= hi; y++)
+        for (int x = lo; x <= hi; x++)
+            if (x < lo + 2 || x > hi - 2 || y < lo + 2 || y > hi - 2) path_map_set(pm, x, y, 0);
+}
+
+static void random_tile(const PathMap *pm, int *x, int *y)
+{
+    do {
+        *x = rand() % pm->w;
+        *y = rand() % pm->h;
+    } while (!path_walkable(pm, *x, *y));
+}
+
+/* Fewest steps from (sx, sy) to within NEAR of (gx, gy), or -1. */
+static int bfs(const PathMap *pm, int *dist, int *queue, int sx, int sy, int gx, int gy)
+{
+    for (int i = 0; i < pm->w * pm->h; i++) dist[i] = -1;
+    int head = 0, tail = 0;
+    dist[sy * pm->w + sx] = 0;
+    queue[tail++] = sy * pm->w + sx;
+    while (head < tail) {
+        int c = queue[head++], x = c % pm->w, y = c / pm->w;
+        if (abs(x - gx) <= NEAR && abs(y - gy) <= NEAR) return dist[c];
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (!path_walkable(pm, nx, ny) || dist[ny * pm->w + nx] >= 0) continue;
+            dist[ny * pm->w + nx] = dist[c] + 1;
+            queue[tail++] = ny * pm->w + nx;
+        }
+    }
+    return -1;
+}
+
+/* Whether dirs[0..n) walks from (x, y) on walkable tiles to within NEAR of (gx, gy). */
+static int valid(const PathMap *pm, const uint8_t *dirs, int n, int x, int y, int gx, int gy)
+{
+    for (int k = 0; k < n; k++) {
+        x += path_dx[dirs[k]];
+        y += path_dy[dirs[k]];
+        if (!path_walkable(pm, x, y)) return 0;
+    }
+    return abs(x - gx) <= NEAR && abs(y - gy) <= NEAR;
+}
+
+static int same_graph(const HpaGraph *a, const HpaGraph *b)
+{
+    for (int k = 0; k < a->cw * a->ch; k++) {
+        const HpaCluster *p = &a->cl[k], *q = &b->cl[k];
+        if (p->n != q->n || a->base[k] != b->base[k]) return 0;
+        if (memcmp(p->tile, q->tile, (size_t)p->n * sizeof(*p->tile)) != 0) return 0;
+        if (memcmp(p->dist, q->dist, (size_t)p->n * p->n * sizeof(*p->dist)) != 0) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int side    = argc > 1 ? atoi(argv[1]) : 1024;
+    int queries = argc > 2 ? atoi(argv[2]) : 300;
+    int edits   = argc > 3 ? atoi(argv[3]) : 2000;
+    if (side < 2 * PATH_WIN || side > 4096 || queries < 1 || edits < 1) {
+        fprintf(stderr, "usage: %s [side >= %d] [queries] [edits]\n", argv[0], 2 * PATH_WIN);
+        return 2;
+    }
+
+    PathMap   pm;
+    HpaGraph  hg, ref;
+    PathPool *pool  = path_pool_create(1);
+    size_t    tiles = (size_t)side * side;
+    int      *dist  = malloc(tiles * sizeof(int));
+    int      *queue = malloc(tiles * sizeof(int));
+    uint8_t  *dirs  = malloc(tiles);
+    if (!pool || !dist || !queue || !dirs || path_map_init(&pm, side, side) != 0 ||
+        hpa_init(&hg, side, side) != 0) {
+        fprintf(stderr, "path_hpa: out of memory\n");
+        return 1;
+    }
+    srand(31);
+    build_map(&pm, side);
+    double t0 = now_sec();
+    hpa_sync(&hg, &pm);
+    double t_build = now_sec() - t0;
+
+    PathScratch *ps = path_pool_acquire(pool);
+    double t_hpa = 0.0, t_bfs = 0.0, excess = 0.0, worst = 0.0;
+    int    ok = 1, found = 0, reachable = 0, missed = 0;
+    for (int q = 0; q < queries && ok; q++) {
+        int sx, sy, gx, gy, n;
+        do {
+            random_tile(&pm, &sx, &sy);
+            random_tile(&pm, &gx, &gy);
+        } while (abs(gx - sx) < PATH_WIN && abs(gy - sy) < PATH_WIN);
+
+        t0 = now_sec();
+        PathStatus st = hpa_find(&hg, &pm, ps, sx, sy, gx, gy, NEAR, dirs, (int)tiles, &n);
+        t_hpa += now_sec() - t0;
+        t0 = now_sec();
+        int best = bfs(&pm, dist, queue, sx, sy, gx, gy);
+        t_bfs += now_sec() - t0;
+
+        reachable += best >= 0;
+        if (st != PATH_FOUND) {
+            missed += best >= 0;
+            ok = st == PATH_NONE;
+            continue;
+        }
+        found++;
+        ok = best >= 0 && n >= best && valid(&pm, dirs, n, sx, sy, gx, gy);
+        double over = best > 0 ? (double)(n - best) / best : 0.0;
+        excess += over;
+        if (over > worst) worst = over;
+    }
+    path_pool_release(pool, ps);
+
+    /* Flip tiles one at a time, keeping the graph in step */
+    double t_inc = 0.0;
+    int    rebuilt = 0;
+    for (int e = 0; e < edits; e++) {
+        int x = rand() % side, y = rand() % side;
+        path_map_set(&pm, x, y, !path_walkable(&pm, x, y));
+        t0 = now_sec();
+        hpa_tile_changed(&hg, x, y);
+        rebuilt += hpa_sync(&hg, &pm);
+        t_inc += now_sec() - t0;
+    }
+    if (hpa_init(&ref, side, side) != 0) {
+        fprintf(stderr, "path_hpa: out of memory\n");
+        return 1;
+    }
+    hpa_sync(&ref, &pm);
+    int same = same_graph(&hg, &ref);
+
+    printf("%dx%d map, %d clusters, %d nodes\n", side, side, hg.cw * hg.ch,
+           hg.base[hg.cw * hg.ch]);
+    printf("%d far queries: %d found, %d reachable, %d missed\n", queries, found, reachable,
+           missed);
+    printf("%-10s %12s\n", "search", "us/query");
+    printf("%-10s %12.1f\n", "bfs", t_bfs / queries * 1e6);
+    printf("%-10s %12.1f  (%.1fx)\n", "hpa*", t_hpa / queries * 1e6, t_bfs / t_hpa);
+    printf("length     %.2f%% over shortest on average, %.1f%% at worst\n",
+           found ? 100.0 * excess / found : 0.0, 100.0 * worst);
+    printf("%-10s %12s\n", "upkeep", "us/edit");
+    printf("%-10s %12.1f\n", "rebuild", t_build * 1e6);
+    printf("%-10s %12.1f  (%.2f clusters/edit)\n", "dirty", t_inc / edits * 1e6,
+           (double)rebuilt / edits);
+    printf("paths      %s\n", ok && !missed ? "valid" : "WRONG");
+    printf("graph      %s\n", same ? "identical" : "DIFFER");
+
+    hpa_free(&ref);
+    hpa_free(&hg);
+    path_pool_destroy(pool);
+    path_map_free(&pm);
+    free(dirs);
+    free(queue);
+    free(dist);
+    return ok && same && !missed ? 0 : 1;
+}
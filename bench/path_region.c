@@ -0,0 +1,198 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/path_region.c — Region labels kept tile by tile vs relabelling the
+ * whole map, and rejecting unreachable goals by label vs by search.
+ *
+ * Builds an archipelago of round, overlapping islands dotted with rocks, then
+ * applies a stream of edits: single tiles flipped, and whole causeways
+ * and island-splitting walls drawn or erased a tile at a time.  After
+ * every edit the labels must split the walkable tiles exactly as a flood
+ * fill from scratch does.  Then times asking, for random pairs on
+ * different islands, whether one reaches the other: by label, and by a
+ * search over the cluster graph.
+ *
+ * Build:  make bench
+ * Run:    ./bench/path_region [side] [edits] [queries]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../path.h"
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void set_tile(PathMap *pm, RegionMap *rm, int x, int y, int walkable, double *t)
+{
+    if (!path_map_set(pm, x, y, walkable)) return;
+    double t0 = now_sec();
+    region_tile_changed(rm, pm, x, y);
+    *t += now_sec() - t0;
+}
+
+/* A straight line of tiles from (x0, y0) to (x1, y1), two tiles thick. */
+static void draw_line(PathMap *pm, RegionMap *rm, int x0, int y0, int x1, int y1, int walkable,
+                      double *t)
+{
+    int n = abs(x1 - x0) > abs(y1 - y0) ? abs(x1 - x0) : abs(y1 - y0);
+    for (int i = 0; i <= n; i++) {
+        int x = x0 + (n ? (x1 - x0) * i / n : 0), y = y0 + (n ? (y1 - y0) * i / n : 0);
+        set_tile(pm, rm, x, y, walkable, t);
+        set_tile(pm, rm, x + 1, y, walkable, t);
+        set_tile(pm, rm, x, y + 1, walkable, t);
+    }
+}
+
+/* Flood-fill components from scratch into comp[], -1 where blocked. */
+static void label_all(const PathMap *pm, int *comp, int *queue)
+{
+    int w = pm->w, tiles = pm->w * pm->h, ncomp = 0;
+    for (int t = 0; t < tiles; t++) comp[t] = -1;
+    for (int t = 0; t < tiles; t++) {
+        if (comp[t] >= 0 || !pm->pass[t]) continue;
+        int head = 0, tail = 0;
+        comp[t] = ncomp;
+        queue[tail++] = t;
+        while (head < tail) {
+            int c = queue[head++], x = c % w, y = c / w;
+            for (int d = 0; d < 8; d++) {
+                int nx = x + path_dx[d], ny = y + path_dy[d];
+                if (!path_walkable(pm, nx, ny) || comp[ny * w + nx] >= 0) continue;
+                comp[ny * w + nx] = ncomp;
+                queue[tail++] = ny * w + nx;
+            }
+        }
+        ncomp++;
+    }
+}
+
+/* Whether the labels split the tiles as comp[] does (label l maps to one
+   component and back) and every tile lies in its label's box. */
+static int same_split(const RegionMap *rm, const PathMap *pm, const int *comp, int *l2c,
+                      int *c2l)
+{
+    int tiles = pm->w * pm->h;
+    for (int i = 0; i < tiles; i++) l2c[i] = c2l[i] = -1;
+    for (int t = 0; t < tiles; t++) {
+        if ((rm->label[t] != 0) != (comp[t] >= 0)) return 0;
+        if (comp[t] < 0) continue;
+        int l = (int)rm->label[t];
+        if (l >= tiles) return 0;
+        if (l2c[l] < 0 && c2l[comp[t]] < 0) {
+            l2c[l]       = comp[t];
+            c2l[comp[t]] = l;
+        }
+        if (l2c[l] != comp[t] || c2l[comp[t]] != l) return 0;
+        const int16_t *b = &rm->box[4 * (size_t)l];
+        int x = t % pm->w, y = t / pm->w;
+        if (x < b[0] || x > b[2] || y < b[1] || y > b[3]) return 0;
+    }
+    for (int t = 0; t < tiles; t++)
+        if (comp[t] >= 0 && rm->size[rm->label[t]] <= 0) return 0;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int side    = argc > 1 ? atoi(argv[1]) : 512;
+    int edits   = argc > 2 ? atoi(argv[2]) : 300;
+    int queries = argc > 3 ? atoi(argv[3]) : 300;
+    if (side < 2 * PATH_WIN || side > 4096 || edits < 1 || queries < 1) {
+        fprintf(stderr, "usage: %s [side >= %d] [edits] [queries]\n", argv[0], 2 * PATH_WIN);
+        return 2;
+    }
+
+    PathMap   pm;
+    RegionMap rm;
+    HpaGraph  hg;
+    size_t    tiles = (size_t)side * side;
+    int      *comp  = malloc(tiles * sizeof(int));
+    int      *queue = malloc(tiles * sizeof(int));
+    int      *l2c   = malloc(tiles * sizeof(int));
+    int      *c2l   = malloc(tiles * sizeof(int));
+    PathPool *pool  = path_pool_create(1);
+    if (!comp || !queue || !l2c || !c2l || !pool || path_map_init(&pm, side, side) != 0 ||
+        region_init(&rm, side, side) != 0 || hpa_init(&hg, side, side) != 0) {
+        fprintf(stderr, "path_region: out of memory\n");
+        return 1;
+    }
+
+    /* Islands, dotted with rocks */
+    double t_inc = 0.0;
+    srand(41);
+    for (int i = 0; i < side / 6; i++) {
+        int cx = rand() % side, cy = rand() % side, r = 6 + rand() % 30;
+        for (int y = cy - r; y <= cy + r; y++)
+            for (int x = cx - r; x <= cx + r; x++)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    set_tile(&pm, &rm, x, y, rand() % 100 >= 8, &t_inc);
+    }
+    t_inc = 0.0;
+
+    double t_full = 0.0;
+    int    ok = 1;
+    for (int e = 0; e < edits && ok; e++) {
+        int x = rand() % side, y = rand() % side, kind = rand() % 4;
+        if (kind == 0) {
+            set_tile(&pm, &rm, x, y, !path_walkable(&pm, x, y), &t_inc);
+        } else {
+            int len = 20 + rand() % 80, dx = rand() % 3 - 1, dy = rand() % 3 - 1;
+            draw_line(&pm, &rm, x, y, x + dx * len, y + dy * len, kind == 1, &t_inc);
+        }
+        double t0 = now_sec();
+        label_all(&pm, comp, queue);
+        t_full += now_sec() - t0;
+        ok = same_split(&rm, &pm, comp, l2c, c2l);
+    }
+
+    /* Pairs on different islands, far enough apart to need the graph */
+    hpa_sync(&hg, &pm);
+    PathScratch *ps = path_pool_acquire(pool);
+    double t_label = 0.0, t_graph = 0.0;
+    int    agree = 1, asked = 0;
+    uint8_t step;
+    while (asked < queries) {
+        int sx = rand() % side, sy = rand() % side, gx = rand() % side, gy = rand() % side, n;
+        if (!path_walkable(&pm, sx, sy) || !path_walkable(&pm, gx, gy)) continue;
+        if (region_of(&rm, sx, sy) == region_of(&rm, gx, gy)) continue;
+        if (abs(gx - sx) < PATH_WIN && abs(gy - sy) < PATH_WIN) continue;
+        double t0 = now_sec();
+        int    by_label = region_connected(&rm, sx, sy, gx, gy, 1);
+        t_label += now_sec() - t0;
+        t0 = now_sec();
+        PathStatus st = hpa_find(&hg, &pm, ps, sx, sy, gx, gy, 1, &step, 1, &n);
+        t_graph += now_sec() - t0;
+        agree &= by_label == (st != PATH_NONE);
+        asked++;
+    }
+    path_pool_release(pool, ps);
+
+    printf("%dx%d archipelago, %d edits\n", side, side, edits);
+    printf("%-12s %12s\n", "labels", "us/edit");
+    printf("%-12s %12.1f\n", "relabel all", t_full / edits * 1e6);
+    printf("%-12s %12.1f  (%.0fx)\n", "incremental", t_inc / edits * 1e6, t_full / t_inc);
+    printf("%-12s %12s  (%d pairs on different islands)\n", "reachable?", "us/query", queries);
+    printf("%-12s %12.1f\n", "hpa* search", t_graph / queries * 1e6);
+    printf("%-12s %12.3f\n", "label", t_label / queries * 1e6);
+    printf("regions      %s\n", ok && agree ? "identical" : "DIFFER");
+
+    hpa_free(&hg);
+    region_free(&rm);
+    path_map_free(&pm);
+    path_pool_destroy(pool);
+    free(c2l);
+    free(l2c);
+    free(queue);
+    free(comp);
+    return ok && agree ? 0 : 1;
+}
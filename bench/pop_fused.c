@@ -0,0 +1,158 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/pop_fused.c — Eight population kernels in sequence vs pop_tick.
+ *
+ * Runs the chain pop_logistic_growth .. pop_recovery_bonus on one PopSoA
+ * and the fused pop_tick on an identical copy, for the scalar reference
+ * and the best vector path, and checks the copies stay bit-identical.
+ * "Bytes moved" counts 4 bytes per array element each kernel reads or
+ * writes (a read-modify-write array counts twice); the effective rate is
+ * that traffic over the measured time.
+ *
+ * Build:  make bench
+ * Run:    ./bench/pop_fused [groups]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../simulation.h"
+
+#define TICKS     5
+#define NARRAYS   13
+#define MORTALITY 0.01f
+#define DT        0.05f
+
+/* Arrays read + arrays written per element, per kernel of the chain. */
+static const int chain_traffic[] = {
+    3 + 1,  /* logistic:  population, carrying_cap, growth_rate -> population */
+    6 + 3,  /* sir:       population, s, i, r, beta, gamma_rec -> s, i, r */
+    4 + 1,  /* starvation: food_threshold, food_supply, population, carrying_cap */
+    3 + 3,  /* age:       young, adult, elder -> young, adult, elder */
+    4 + 2,  /* birth:     adult, population, young, carrying_cap -> young, population */
+    3 + 1,  /* death:     elder, population, carrying_cap -> population */
+    3 + 1,  /* epidemic:  infected, population, carrying_cap -> population */
+    3 + 1,  /* recovery:  recovered, population, carrying_cap -> population */
+};
+static const int fused_traffic = 13 + 7;   /* every array once, seven written back */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fill(float *a, int n, float lo, float hi)
+{
+    for (int i = 0; i < n; i++)
+        a[i] = lo + (hi - lo) * (float)rand() / ((float)RAND_MAX + 1.0f);
+}
+
+static PopSoA *pop_init(int n)
+{
+    PopSoA *p = pop_soa_create(n);
+    if (!p) {
+        fprintf(stderr, "pop_fused: out of memory\n");
+        exit(1);
+    }
+    srand(777);
+    fill(p->population,     n, 0, 5000);
+    fill(p->carrying_cap,   n, 5000, 9000);
+    fill(p->growth_rate,    n, 0, 0.05f);
+    fill(p->susceptible,    n, 0.5f, 1);
+    fill(p->infected,       n, 0, 0.1f);
+    fill(p->recovered,      n, 0, 0.1f);
+    fill(p->beta,           n, 0, 0.3f);
+    fill(p->gamma_rec,      n, 0, 0.1f);
+    fill(p->food_supply,    n, 0, 1000);
+    fill(p->food_threshold, n, 0, 800);
+    fill(p->age_young,      n, 0, 0.4f);
+    fill(p->age_adult,      n, 0, 0.4f);
+    fill(p->age_elder,      n, 0, 0.2f);
+    return p;
+}
+
+static void pop_arrays(const PopSoA *p, float *a[NARRAYS])
+{
+    float *list[NARRAYS] = {
+        p->population, p->carrying_cap, p->growth_rate, p->susceptible, p->infected,
+        p->recovered, p->beta, p->gamma_rec, p->food_supply, p->food_threshold,
+        p->age_young, p->age_adult, p->age_elder,
+    };
+    memcpy(a, list, sizeof(list));
+}
+
+static int pop_same(const PopSoA *a, const PopSoA *b)
+{
+    float *x[NARRAYS], *y[NARRAYS];
+    pop_arrays(a, x);
+    pop_arrays(b, y);
+    for (int k = 0; k < NARRAYS; k++)
+        if (memcmp(x[k], y[k], (size_t)a->count * sizeof(float)) != 0) return 0;
+    return 1;
+}
+
+static double run_chain(PopSoA *p)
+{
+    double t0 = now_sec();
+    for (int t = 0; t < TICKS; t++) {
+        pop_logistic_growth(p, DT);
+        pop_sir_step(p, DT);
+        pop_starvation(p, DT);
+        pop_age_cohort_shift(p, DT);
+        pop_birth_rate(p, DT);
+        pop_death_rate(p, DT);
+        pop_epidemic_mortality(p, MORTALITY, DT);
+        pop_recovery_bonus(p, DT);
+    }
+    return (now_sec() - t0) / TICKS;
+}
+
+static double run_fused(PopSoA *p)
+{
+    double t0 = now_sec();
+    for (int t = 0; t < TICKS; t++) pop_tick(p, MORTALITY, DT);
+    return (now_sec() - t0) / TICKS;
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 22;
+    if (n < 1) {
+        fprintf(stderr, "usage: %s [groups]\n", argv[0]);
+        return 2;
+    }
+    int chain = 0;
+    for (size_t k = 0; k < sizeof(chain_traffic) / sizeof(chain_traffic[0]); k++)
+        chain += chain_traffic[k];
+    double chain_mb = (double)chain * 4.0 * n / 1e6;
+    double fused_mb = (double)fused_traffic * 4.0 * n / 1e6;
+
+    printf("%d groups, %d ticks\n", n, TICKS);
+    printf("%-8s %-6s %10s %10s %8s\n", "path", "kernel", "ms/tick", "MB/tick", "GB/s");
+    int ok = 1;
+    SimIsa paths[] = { SIM_ISA_SCALAR, sim_isa_best() };
+    for (int k = 0; k < 2; k++) {
+        if (k == 1 && paths[1] == SIM_ISA_SCALAR) break;
+        sim_isa_select(paths[k]);
+        PopSoA *a = pop_init(n), *b = pop_init(n);
+        double tc = run_chain(a), tf = run_fused(b);
+        int same = pop_same(a, b);
+        const char *name = sim_isa_name(paths[k]);
+        printf("%-8s %-6s %10.3f %10.1f %8.2f\n", name, "chain", tc * 1e3, chain_mb,
+               chain_mb / 1e3 / tc);
+        printf("%-8s %-6s %10.3f %10.1f %8.2f  (%.2fx)%s\n", name, "fused", tf * 1e3,
+               fused_mb, fused_mb / 1e3 / tf, tc / tf, same ? "" : "  DIFFER");
+        ok &= same;
+        pop_soa_destroy(a);
+        pop_soa_destroy(b);
+    }
+    printf("results   %s\n", ok ? "identical" : "DIFFER");
+    return ok ? 0 : 1;
+}
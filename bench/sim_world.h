@@ -0,0 +1,200 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * bench/sim_world.h — Synthetic world for the simulation.c benches.
+ *
+ * Creates every SoA and allocates every caller-owned buffer of a
+ * SimWorld/SimParams pair, and fills them from a fixed random stream, so
+ * two worlds built with the same sizes start bit-identical and can be
+ * compared with memcmp.
+ */
+
+#ifndef BENCH_SIM_WORLD_H
+#define BENCH_SIM_WORLD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../sim_schedule.h"
+
+#define MAX_ARRAYS 128
+
+typedef struct {
+    PopSoA *pop; FaithSoA *faith; CombatSoA *combat; EconSoA *econ; EnvSoA *env;
+    MoveSoA *move; DivineSoA *divine; PsychSoA *psych; TechSoA *tech; EngineSoA *engine;
+    int   *miracle, *rout, *drought, *flood, *defect, *unlock, *end;
+    float *scarcity, *dmg, *taxpop;
+    MoveGrid grid;
+    void  *arrays[MAX_ARRAYS];      /* every array, for comparing */
+    size_t bytes[MAX_ARRAYS];
+    char   owned[MAX_ARRAYS];       /* 1 if malloced here, 0 if in a SoA arena */
+    int    narrays;
+    SimWorld  w;
+    SimParams p;
+} World;
+
+static void *need(void *a)
+{
+    if (!a) {
+        fprintf(stderr, "bench: out of memory\n");
+        exit(1);
+    }
+    return a;
+}
+
+static void *track(World *W, void *a, size_t bytes, int owned)
+{
+    if (W->narrays == MAX_ARRAYS) {
+        fprintf(stderr, "bench: too many arrays\n");
+        exit(1);
+    }
+    W->arrays[W->narrays] = a;
+    W->owned[W->narrays]  = (char)owned;
+    W->bytes[W->narrays++] = bytes;
+    return a;
+}
+
+/* Uniform floats in [lo, hi) from a fixed stream, so both worlds match. */
+static void fill(World *W, float *a, int n, float lo, float hi)
+{
+    track(W, a, (size_t)n * sizeof(float), 0);
+    for (int i = 0; i < n; i++)
+        a[i] = lo + (hi - lo) * (float)rand() / ((float)RAND_MAX + 1.0f);
+}
+
+/* A caller-owned buffer of n elements, filled like fill(). */
+static float *farr(World *W, int n, float lo, float hi)
+{
+    float *a = need(malloc((size_t)n * sizeof(float)));
+    fill(W, a, n, lo, hi);
+    W->owned[W->narrays - 1] = 1;
+    return a;
+}
+
+static int *iarr(World *W, int n)
+{
+    return track(W, need(calloc((size_t)n, sizeof(int))), (size_t)n * sizeof(int), 1);
+}
+
+static void world_init(World *W, int n, int movers)
+{
+    memset(W, 0, sizeof(*W));
+    srand(4242);
+    PopSoA *p = W->pop = need(pop_soa_create(n));
+    fill(W, p->population, n, 100, 5000);    fill(W, p->carrying_cap, n, 5000, 9000);
+    fill(W, p->growth_rate, n, 0, 0.05f);    fill(W, p->susceptible, n, 0.5f, 1);
+    fill(W, p->infected, n, 0, 0.1f);        fill(W, p->recovered, n, 0, 0.1f);
+    fill(W, p->beta, n, 0, 0.3f);            fill(W, p->gamma_rec, n, 0, 0.1f);
+    fill(W, p->food_supply, n, 0, 1000);     fill(W, p->food_threshold, n, 0, 800);
+    fill(W, p->age_young, n, 0, 0.4f);       fill(W, p->age_adult, n, 0, 0.4f);
+    fill(W, p->age_elder, n, 0, 0.2f);
+    FaithSoA *f = W->faith = need(faith_soa_create(n));
+    fill(W, f->faith_level, n, 0, 1);        fill(W, f->mana, n, 0, 500);
+    fill(W, f->mana_regen, n, 0, 2);         fill(W, f->heresy_rate, n, 0, 0.1f);
+    fill(W, f->miracle_chance, n, 0, 0.1f);  fill(W, f->devotee_count, n, 0, 1000);
+    fill(W, f->temple_count, n, 0, 10);      fill(W, f->schism_risk, n, 0, 0.5f);
+    fill(W, f->conversion_rate, n, 0, 0.1f); fill(W, f->divine_favor, n, 0, 1);
+    CombatSoA *c = W->combat = need(combat_soa_create(n));
+    fill(W, c->base_atk, n, 1, 20);          fill(W, c->armor, n, 0, 50);
+    fill(W, c->hp, n, 1, 100);               fill(W, c->max_hp, n, 100, 200);
+    fill(W, c->morale, n, 0, 1);             fill(W, c->morale_decay, n, 0, 0.01f);
+    fill(W, c->hit_chance, n, 0, 1);         fill(W, c->crit_chance, n, 0, 0.2f);
+    fill(W, c->crit_mult, n, 1, 3);          fill(W, c->rout_threshold, n, 0, 0.3f);
+    EconSoA *e = W->econ = need(econ_soa_create(n));
+    fill(W, e->resource, n, 0, 500);         fill(W, e->max_resource, n, 500, 1000);
+    fill(W, e->gather_rate, n, 0, 5);        fill(W, e->depletion_rate, n, 0, 2);
+    fill(W, e->price, n, 1, 10);             fill(W, e->demand, n, 0, 100);
+    fill(W, e->supply, n, 0, 100);           fill(W, e->tax_rate, n, 0, 0.3f);
+    fill(W, e->tax_collected, n, 0, 1);      fill(W, e->trade_volume, n, 0, 1);
+    EnvSoA *v = W->env = need(env_soa_create(n));
+    fill(W, v->temperature, n, -10, 40);     fill(W, v->temp_target, n, -10, 40);
+    fill(W, v->rainfall, n, 0, 50);          fill(W, v->humidity, n, 0, 1);
+    fill(W, v->wind_x, n, -5, 5);            fill(W, v->wind_y, n, -5, 5);
+    fill(W, v->fire_intensity, n, 0, 1);     fill(W, v->fuel, n, 0, 1);
+    fill(W, v->elevation, n, 0, 3);          fill(W, v->pressure, n, 1000, 1030);
+    MoveSoA *m = W->move = need(move_soa_create(movers));
+    fill(W, m->pos_x, movers, 0, 256);       fill(W, m->pos_y, movers, 0, 256);
+    fill(W, m->vel_x, movers, -1, 1);        fill(W, m->vel_y, movers, -1, 1);
+    fill(W, m->acc_x, movers, 0, 0);         fill(W, m->acc_y, movers, 0, 0);
+    fill(W, m->heading, movers, 0, 6);       fill(W, m->speed, movers, 0, 1);
+    fill(W, m->max_speed, movers, 1, 3);     fill(W, m->h_cost, movers, 0, 1);
+    DivineSoA *d = W->divine = need(divine_soa_create(n));
+    fill(W, d->energy, n, 0, 100);           fill(W, d->energy_cap, n, 100, 200);
+    fill(W, d->regen_rate, n, 0, 2);         fill(W, d->meteor_cost, n, 10, 50);
+    fill(W, d->heal_amount, n, 1, 20);       fill(W, d->heal_decay, n, 0, 0.1f);
+    fill(W, d->terraform_cost, n, 1, 5);     fill(W, d->smite_power, n, 5, 30);
+    fill(W, d->blessing_mult, n, 1, 1.5f);   fill(W, d->cooldown, n, 0, 10);
+    PsychSoA *s = W->psych = need(psych_soa_create(n));
+    fill(W, s->happiness, n, 0, 1);          fill(W, s->fear, n, 0, 1);
+    fill(W, s->loyalty, n, 0, 1);            fill(W, s->aggression, n, 0, 1);
+    fill(W, s->utility_work, n, 0, 1);       fill(W, s->utility_fight, n, 0, 1);
+    fill(W, s->utility_flee, n, 0, 1);       fill(W, s->threat_level, n, 0, 1);
+    fill(W, s->memory_decay, n, 0, 0.1f);    fill(W, s->social_bond, n, 0, 1);
+    TechSoA *t = W->tech = need(tech_soa_create(n));
+    fill(W, t->research_pts, n, 0, 100);     fill(W, t->research_rate, n, 0, 5);
+    fill(W, t->tech_cost, n, 100, 200);      fill(W, t->tech_level, n, 0, 20);
+    fill(W, t->golden_age_mult, n, 1, 2);    fill(W, t->golden_age_timer, n, 0, 10);
+    fill(W, t->culture, n, 0, 500);          fill(W, t->culture_spread, n, 0, 0.05f);
+    fill(W, t->era, n, 0, 2);                fill(W, t->pop_bonus, n, 0, 1);
+    EngineSoA *g = W->engine = need(engine_soa_create(n));
+    fill(W, g->entropy, n, 0, 1);            fill(W, g->entropy_rate, n, 0, 0.01f);
+    fill(W, g->grid_x, n, 0, 0);             fill(W, g->grid_y, n, 0, 0);
+    fill(W, g->inv_sqrt_val, n, 1, 100);     fill(W, g->inv_sqrt_out, n, 0, 0);
+    fill(W, g->stability, n, 0, 1);          fill(W, g->end_timer, n, 0, 100);
+    fill(W, g->victory_pts, n, 0, 10);       fill(W, g->chaos_mult, n, 1, 2);
+    track(W, g->rng_state, (size_t)n * sizeof(uint32_t), 0);
+
+    W->miracle  = iarr(W, n);
+    W->rout     = iarr(W, n);
+    W->drought  = iarr(W, n);
+    W->flood    = iarr(W, n);
+    W->defect   = iarr(W, n);
+    W->unlock   = iarr(W, n);
+    W->end      = iarr(W, n);
+    W->scarcity = farr(W, n, 0, 0);
+    W->dmg      = farr(W, n, 0, 50);
+    W->taxpop   = farr(W, n, 0, 5000);
+
+    W->w = (SimWorld){ W->pop, W->faith, W->combat, W->econ, W->env,
+                       W->move, W->divine, W->psych, W->tech, W->engine };
+    W->p = (SimParams){
+        .dt = 0.05f, .epidemic_mortality = 0.01f, .piety_delta = 0.001f,
+        .hp_regen_rate = 0.01f, .population_delta = 1.0f, .inflation_rate = 0.001f,
+        .temp_diffuse_rate = 0.1f, .fire_spread_prob = 0.2f,
+        .drought_threshold = 5.0f, .flood_threshold = 40.0f,
+        .flock_radius = 6.0f, .flock_skin = 1.0f, .separation_strength = 0.1f,
+        .alignment_strength = 0.05f, .cohesion_strength = 0.01f, .grid_cell = 8.0f,
+        .miracle_out = W->miracle, .rout_flags = W->rout, .dmg_inout = W->dmg,
+        .scarcity_mult = W->scarcity, .tax_population = W->taxpop,
+        .drought_flags = W->drought, .flood_flags = W->flood,
+        .defect_flags = W->defect, .unlock_flags = W->unlock, .end_flags = W->end,
+        .move_grid = &W->grid,
+    };
+}
+
+static void world_free(World *W)
+{
+    for (int i = 0; i < W->narrays; i++)
+        if (W->owned[i]) free(W->arrays[i]);
+    pop_soa_destroy(W->pop);       faith_soa_destroy(W->faith);
+    combat_soa_destroy(W->combat); econ_soa_destroy(W->econ);
+    env_soa_destroy(W->env);       move_soa_destroy(W->move);
+    divine_soa_destroy(W->divine); psych_soa_destroy(W->psych);
+    tech_soa_destroy(W->tech);     engine_soa_destroy(W->engine);
+    move_grid_free(&W->grid);
+}
+
+/* 1 if every array of A matches B bit for bit. */
+static int world_same(const World *A, const World *B)
+{
+    if (A->narrays != B->narrays) return 0;
+    for (int i = 0; i < A->narrays; i++)
+        if (memcmp(A->arrays[i], B->arrays[i], A->bytes[i]) != 0) return 0;
+    return 1;
+}
+
+#endif /* BENCH_SIM_WORLD_H */
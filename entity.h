@@ -0,0 +1,63 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * entity.h — Entity handles and the hot/cold entity store
+ *
+ * The layout main.c keeps its entities in, shared with the layout bench so
+ * both measure and run the same arrays.
+ */
+
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <stdint.h>
+
+/* Generational entity handle: slot index in the low ENT_IDX_BITS, the
+   slot's generation above.  Generations start at 1, so 0 is never a live
+   handle. */
+typedef uint32_t EntRef;
+#define ENT_IDX_BITS  20
+#define ENT_IDX_MASK  ((1u << ENT_IDX_BITS) - 1u)
+#define ENT_GEN_MAX   ((1u << (32 - ENT_IDX_BITS)) - 1u)
+#define ENT_NONE      0u
+
+typedef enum { E_UNIT=0, E_VILLAGE=1, E_CITY=2, E_MONSTER=3 } EKind;
+typedef enum { S_IDLE=0, S_SEEK=1, S_ATTACK=2, S_FLEE=3 }    UState;
+
+/* Entity store, Structure of Arrays indexed by slot.  Fields read by the
+   per-tick hot loops (proximity queries, unit AI) are packed into narrow
+   arrays in EntHot; fields touched only on spawn, upgrade or attack live in
+   EntCold, so the hot loops stream nothing they do not use. */
+typedef struct {
+    uint8_t  *alive;
+    uint8_t  *kind;        /* EKind */
+    uint8_t  *state;       /* UState */
+    int8_t   *civ;         /* 0..NCIV-1 for civ units; -1 for monsters */
+    int16_t  *x, *y;
+    int16_t  *hp;
+    uint8_t  *move_cd;     /* movement cooldown counter */
+    uint8_t  *atk_cd;      /* attack cooldown counter */
+    EntRef   *target;      /* handle of current target, or ENT_NONE */
+    uint16_t *gen;         /* slot generation, bumped on every kill */
+} EntHot;
+
+typedef struct {
+    int16_t  *max_hp;
+    int16_t  *atk;
+    int16_t  *spawn_timer; /* buildings: ticks until next unit spawn */
+    int32_t  *age;         /* ticks this entity has been alive */
+    /* Cached A* path: steps path_dir[id*PATH_CACHE + path_pos .. path_len)
+       from tile (path_x, path_y), planned toward (path_gx, path_gy) */
+    uint8_t  *path_dir;    /* PATH_CACHE directions per slot */
+    uint8_t  *path_len;
+    uint8_t  *path_pos;
+    int16_t  *path_x, *path_y;
+    int16_t  *path_gx, *path_gy;
+    uint32_t *path_epoch;  /* pmap.epoch the path was planned at */
+    EntRef   *path_fail;   /* target found unreachable at path_epoch */
+    uint8_t  *path_wait;   /* a path request is queued in preq */
+} EntCold;
+
+#endif /* ENTITY_H */
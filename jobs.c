@@ -0,0 +1,287 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * jobs.c — Work-stealing worker pool on POSIX threads.
+ *
+ * Workers sleep on a condition variable between runs.  A run seeds the
+ * per-thread deques with the tasks that have no predecessors, round-robin,
+ * and bumps `epoch` to wake the workers.  Every thread, the caller
+ * included, then pops from the bottom of its own deque, steals from the
+ * top of the others when it runs dry, and pushes each successor whose
+ * last predecessor it just finished.  The run is over when `remaining`
+ * reaches zero; the last worker to notice signals the caller.  A thread
+ * that finds nothing to take JOBS_SPINS times in a row parks on `cv_work`
+ * until a task is pushed or the run ends, so threads with nothing to do
+ * leave the cores to those with work.
+ *
+ * Deques are short mutex-protected arrays: a task is a whole kernel range
+ * or world strip, so a lock per push/pop is noise next to the work.
+ */
+
+#include "jobs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define JOBS_MAX_THREADS 64
+#define JOBS_SPINS       16      /* empty rounds before an idle thread parks */
+
+typedef struct {
+    pthread_mutex_t mu;
+    int            *buf;        /* `cap` slots; tasks in [top, bottom) */
+    int             top, bottom;
+} Deque;
+
+static pthread_t       workers[JOBS_MAX_THREADS];
+static int             nworkers = 0;      /* threads besides the caller */
+static pthread_mutex_t mu       = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  cv_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  cv_done  = PTHREAD_COND_INITIALIZER;
+static unsigned        epoch    = 0;
+static int             busy     = 0;      /* workers still inside the run */
+static int             stopping = 0;
+
+/* Current run; set up before epoch is bumped */
+static Deque           deques[JOBS_MAX_THREADS];
+static int            *deque_mem;
+static atomic_int     *pending;           /* unfinished predecessors per task */
+static int             cap = 0;           /* tasks the buffers can hold */
+static const JobTask  *cur_tasks;         /* NULL: no edges */
+static JobFn           cur_fn;
+static void           *cur_ctx;
+static atomic_int      remaining;
+
+/* Parking: `pushes` counts pushes (and the end of the run), so a thread
+   that saw it unchanged under idle_mu cannot miss the wakeup */
+static pthread_mutex_t idle_mu  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  cv_work  = PTHREAD_COND_INITIALIZER;
+static atomic_uint     pushes;
+static atomic_int      sleepers;          /* threads parked on cv_work */
+
+/* ---- deques ------------------------------------------------------------ */
+static void deque_push(Deque *d, int t)
+{
+    pthread_mutex_lock(&d->mu);
+    d->buf[d->bottom++] = t;
+    pthread_mutex_unlock(&d->mu);
+}
+
+/* Owner end: newest task first. */
+static int deque_pop(Deque *d)
+{
+    int t = -1;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) t = d->buf[--d->bottom];
+    if (d->bottom == d->top) d->top = d->bottom = 0;
+    pthread_mutex_unlock(&d->mu);
+    return t;
+}
+
+/* Thief end: oldest task first. */
+static int deque_steal(Deque *d)
+{
+    int t = -1;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) t = d->buf[d->top++];
+    if (d->bottom == d->top) d->top = d->bottom = 0;
+    pthread_mutex_unlock(&d->mu);
+    return t;
+}
+
+/* ---- parking ------------------------------------------------------------ */
+/* Something changed for parked threads: one task to take, or (all) the
+   run is over. */
+static void wake_idle(int all)
+{
+    atomic_fetch_add(&pushes, 1);
+    if (atomic_load(&sleepers) == 0) return;
+    pthread_mutex_lock(&idle_mu);
+    if (all) pthread_cond_broadcast(&cv_work);
+    else     pthread_cond_signal(&cv_work);
+    pthread_mutex_unlock(&idle_mu);
+}
+
+/* Sleep until pushes moves on from `seen` or the run is over. */
+static void park(unsigned seen)
+{
+    pthread_mutex_lock(&idle_mu);
+    atomic_fetch_add(&sleepers, 1);
+    while (atomic_load(&pushes) == seen && atomic_load(&remaining) != 0)
+        pthread_cond_wait(&cv_work, &idle_mu);
+    atomic_fetch_sub(&sleepers, 1);
+    pthread_mutex_unlock(&idle_mu);
+}
+
+/* ---- execution ---------------------------------------------------------- */
+/* Work on the current run as thread `self` until every task has finished. */
+static void run_tasks(int self)
+{
+    int nthreads = nworkers + 1, idle = 0;
+    for (;;) {
+        unsigned seen = atomic_load(&pushes);
+        int t = deque_pop(&deques[self]);
+        for (int k = 1; t < 0 && k < nthreads; k++)
+            t = deque_steal(&deques[(self + k) % nthreads]);
+        if (t < 0) {
+            if (atomic_load(&remaining) == 0) return;
+            if (++idle < JOBS_SPINS) {
+                sched_yield();
+            } else {
+                park(seen);
+                idle = 0;
+            }
+            continue;
+        }
+        idle = 0;
+        cur_fn(cur_ctx, t);
+        if (cur_tasks) {
+            const JobTask *jt = &cur_tasks[t];
+            for (int s = 0; s < jt->nsucc; s++)
+                if (atomic_fetch_sub(&pending[jt->succ[s]], 1) == 1) {
+                    deque_push(&deques[self], jt->succ[s]);
+                    wake_idle(0);
+                }
+        }
+        if (atomic_fetch_sub(&remaining, 1) == 1) wake_idle(1);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    int self = (int)(size_t)arg;
+    unsigned seen = 0;
+    pthread_mutex_lock(&mu);
+    for (;;) {
+        while (!stopping && epoch == seen)
+            pthread_cond_wait(&cv_start, &mu);
+        if (stopping) break;
+        seen = epoch;
+        pthread_mutex_unlock(&mu);
+
+        run_tasks(self);
+
+        pthread_mutex_lock(&mu);
+        if (--busy == 0) pthread_cond_signal(&cv_done);
+    }
+    pthread_mutex_unlock(&mu);
+    return NULL;
+}
+
+/* Make room for `count` tasks; every deque may have to hold all of them. */
+static void reserve(int count)
+{
+    if (count <= cap) return;
+    int n = cap ? cap : 64;
+    while (n < count) n *= 2;
+    int        *dm = realloc(deque_mem, (size_t)n * (size_t)(nworkers + 1) * sizeof(*dm));
+    atomic_int *pd = dm ? realloc(pending, (size_t)n * sizeof(*pd)) : NULL;
+    if (!pd) {
+        fprintf(stderr, "jobs: cannot allocate a %d-task graph\n", count);
+        exit(1);
+    }
+    deque_mem = dm;
+    pending   = pd;
+    cap       = n;
+}
+
+void jobs_run_graph(int count, const JobTask *tasks, JobFn fn, void *ctx)
+{
+    if (count <= 0) return;
+    reserve(count);
+    int nthreads = nworkers + 1;
+    for (int d = 0; d < nthreads; d++) {
+        deques[d].buf = deque_mem + (size_t)d * (size_t)cap;
+        deques[d].top = deques[d].bottom = 0;
+    }
+    int seeded = 0;
+    for (int t = 0; t < count; t++) {
+        int npred = tasks ? tasks[t].npred : 0;
+        atomic_init(&pending[t], npred);
+        if (npred == 0) {
+            Deque *d = &deques[seeded++ % nthreads];
+            d->buf[d->bottom++] = t;
+        }
+    }
+    cur_tasks = tasks;
+    cur_fn    = fn;
+    cur_ctx   = ctx;
+    atomic_store(&remaining, count);
+
+    if (nworkers == 0) {
+        run_tasks(0);
+        return;
+    }
+    pthread_mutex_lock(&mu);
+    busy = nworkers;
+    epoch++;
+    pthread_cond_broadcast(&cv_start);
+    pthread_mutex_unlock(&mu);
+
+    run_tasks(0);
+
+    pthread_mutex_lock(&mu);
+    while (busy > 0)
+        pthread_cond_wait(&cv_done, &mu);
+    pthread_mutex_unlock(&mu);
+}
+
+void jobs_parallel_for(int count, JobFn fn, void *ctx)
+{
+    if (nworkers == 0 || count <= 1) {
+        for (int i = 0; i < count; i++) fn(ctx, i);
+        return;
+    }
+    jobs_run_graph(count, NULL, fn, ctx);
+}
+
+/* ---- lifecycle ---------------------------------------------------------- */
+int jobs_init(int nthreads)
+{
+    if (nthreads > JOBS_MAX_THREADS) nthreads = JOBS_MAX_THREADS;
+    static int deques_ready = 0;
+    if (!deques_ready) {
+        for (int d = 0; d < JOBS_MAX_THREADS; d++)
+            pthread_mutex_init(&deques[d].mu, NULL);
+        deques_ready = 1;
+    }
+    stopping = 0;
+    while (nworkers < nthreads - 1) {
+        if (pthread_create(&workers[nworkers], NULL, worker_main,
+                           (void *)(size_t)(nworkers + 1)) != 0)
+            break;
+        nworkers++;
+    }
+    /* Buffers were sized for the old thread count */
+    free(deque_mem);
+    free(pending);
+    deque_mem = NULL;
+    pending   = NULL;
+    cap       = 0;
+    return nworkers + 1;
+}
+
+void jobs_shutdown(void)
+{
+    pthread_mutex_lock(&mu);
+    stopping = 1;
+    pthread_cond_broadcast(&cv_start);
+    pthread_mutex_unlock(&mu);
+    for (int i = 0; i < nworkers; i++)
+        pthread_join(workers[i], NULL);
+    nworkers = 0;
+    free(deque_mem);
+    free(pending);
+    deque_mem = NULL;
+    pending   = NULL;
+    cap       = 0;
+}
+
+int jobs_threads(void)
+{
+    return nworkers + 1;
+}
@@ -0,0 +1,53 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * jobs.h — Work-stealing worker pool
+ *
+ * A fixed set of worker threads that run one task graph at a time.  Each
+ * thread owns a deque: it pushes the tasks it unblocks and pops them LIFO
+ * for locality, and an idle thread steals the oldest task from another
+ * thread's deque.  The calling thread takes part in every run, so a pool
+ * of N threads starts N-1 workers.  With one thread (or where threads are
+ * unavailable, such as the Emscripten build) every run simply executes
+ * inline in dependency order.
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+/* Body of a parallel loop or task graph: called once per index. */
+typedef void (*JobFn)(void *ctx, int index);
+
+/* One node of a task graph.  Task i may start once its npred predecessors
+   have finished; when it finishes, each task in succ[0..nsucc) loses one
+   predecessor. */
+typedef struct {
+    int        npred;
+    int        nsucc;
+    const int *succ;
+} JobTask;
+
+/* Start the pool with `nthreads` threads in total, counting the caller.
+   Returns the number actually running, which is 1 if no worker could be
+   started. */
+int  jobs_init(int nthreads);
+
+/* Stop and join every worker.  Safe to call when the pool never started. */
+void jobs_shutdown(void);
+
+/* Threads taking part in each loop, counting the caller. */
+int  jobs_threads(void);
+
+/* Run fn(ctx, i) for every i in [0, count) across the pool and return once
+   all of them have finished.  Indices are handed out dynamically, so fn
+   must not depend on which thread runs which index. */
+void jobs_parallel_for(int count, JobFn fn, void *ctx);
+
+/* Run fn(ctx, i) for every task i in [0, count), each after all of its
+   predecessors, and return once the whole graph has finished.  The graph
+   must be acyclic.  Not reentrant: fn must not start another run. */
+void jobs_run_graph(int count, const JobTask *tasks, JobFn fn, void *ctx);
+
+#endif /* JOBS_H */
@@ -5,12 +5,45 @@
 /*
  * god-casa — A Worldbox-like prototype in C using ncurses
  *
- * Build:  make          (or: gcc -O2 -o god-casa main.c -lncurses -lm)
+ * Build:  make          (or: gcc -O2 -pthread -o god-casa main.c jobs.c path.c sim_schedule.c simulation.c simulation_simd.c simulation_soa.c -lncurses -lm)
  * Run:    ./god-casa
  *
+ * === CONFIGURATION ===
+ *  --width N --height N   world size in tiles (16..4096, default 120x55)
+ *  --entities N           entity slots (up to 1048576, default 1500)
+ *  --civs N               civilisations (1..8, default 4)
+ *  --units N              unit cap per civilisation (default 60)
+ *  --villages N           starting villages per civilisation (default 1)
+ *  --threads N            simulation threads (1..64, default 1); any count
+ *                         gives the same world for the same seed
+ *  --config FILE          the same settings as "key = value" lines
+ *
+ * === HEADLESS BENCHMARK ===
+ *  ./god-casa --headless [--ticks N] [--seed S]
+ *  Skips ncurses entirely, runs the simulation flat out for N ticks and
+ *  prints ticks/sec, mean and p99 tick time, the final per-civ counts and
+ *  a hash of the final world state.
+ *
+ * === DISPLAY ===
+ *  --backend ncurses      draw through ncurses (the default)
+ *  --backend ansi         write VT100 sequences directly, one write(2) per
+ *                         frame
+ *  --backend null         compose and diff frames but show nothing
+ *  --frames N             render N frames back to back, one tick each, then
+ *                         report render time per frame on stderr; with
+ *                         ansi or null, stdout may go to a file or
+ *                         /dev/null (size from $LINES/$COLUMNS, else 80x24)
+ *  --verify               with --frames, check after every frame that the
+ *                         screen the backend was left with (pans included)
+ *                         matches the frame, and that each overview block
+ *                         matches a fresh sum of its tiles
+ *
  * === CONTROLS ===
  *  Arrow keys      Move cursor
  *  W/A/S/D         Scroll camera
+ *  Z / X           Zoom out / in  (1:1 up to 1:128; zoomed-out cells show
+ *                  the side with most units and towns there, else the
+ *                  terrain covering most of it)
  *  Tab             Cycle selected civilisation
  *  1-6             Select terrain power  (Plains/Water/Forest/Mountain/Lava/Sand)
  *  7               Select "Spawn Unit" power
@@ -19,6 +52,7 @@
  *  0               Select "Meteor Strike" power  (area destruction)
  *  Enter / F       Apply selected power at cursor
  *  Space           Pause / Resume simulation
+ *  + / -           Double / halve simulation speed (1x..64x)
  *  Q               Quit
  *
  * === LEGEND ===
@@ -29,26 +63,43 @@
  *  M  monster
  */
 
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
 #include <ncurses.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
+#include "entity.h"
+#include "jobs.h"
+#include "path.h"
 #include "simulation.h"
 
 /* ======================================================================
    CONSTANTS
    ====================================================================== */
-#define WW  120          /* world width  (tiles) */
-#define WH   55          /* world height (tiles) */
-#define MAX_E 1500       /* maximum entities */
-#define NCIV   4         /* number of civilisations */
+/* World size, entity capacity and civ count are chosen at startup (see
+   CONFIGURATION); these names read the live values. */
+#define WW    (cfg.world_w)   /* world width  (tiles) */
+#define WH    (cfg.world_h)   /* world height (tiles) */
+#define MAX_E (cfg.max_ents)  /* maximum entities */
+#define NCIV  (cfg.nciv)      /* number of civilisations */
+
+#define MAX_WORLD     4096    /* largest accepted world side (tiles) */
+#define MAX_CIV          8    /* largest accepted civ count */
+#define ARENA_ALIGN     64    /* alignment of every per-world array */
 
 /* Simulation tuning */
 #define UNIT_HP          40
@@ -60,10 +111,28 @@
 #define UNIT_SPAWN_INT   25   /* ticks between village unit spawns */
 #define CITY_SPAWN_INT   12
 #define VILLAGE_AGE_UP  300   /* ticks for village → city upgrade */
-#define MAX_UNITS_CIV    60   /* cap on units per civilisation */
+#define MAX_UNITS_CIV (cfg.units_per_civ) /* cap on units per civilisation */
 #define UNIT_MOVE_CD      3   /* ticks between unit moves */
 #define UNIT_ATK_CD       5   /* ticks between unit attacks */
 #define ENEMY_DETECT_R2 400   /* squared tile radius for enemy detection */
+#define PATH_CACHE       16   /* A* steps kept per unit before replanning */
+#define PATH_SLACK        2   /* tiles a goal may drift before replanning */
+#define PATH_SOLVES      64   /* queued path searches run per tick */
+#define PATH_SOLVE_CHUNK  4   /* searches per worker job */
+#define GRID_CELL         8   /* spatial grid bucket size (tiles per side) */
+#define MAX_THREADS      64   /* largest accepted worker-thread count */
+#define STRIPS_PER_THREAD 4   /* world strips per thread, for load balance */
+
+/* Timing */
+#define SIM_HZ          20    /* simulation ticks per second at 1x speed */
+#define FRAME_HZ        30    /* render rate of the interactive loop */
+#define SIM_BUDGET     0.8    /* max fraction of a frame spent simulating */
+#define MAX_SPEED       64    /* highest fast-forward multiplier */
+
+/* Overview zoom */
+#define ZOOM_MAX         7    /* most zoomed out: 2^7 tiles per cell side */
+#define PYR_MIN          3    /* coarsest zoom drawn straight from the tiles is PYR_MIN-1 */
+#define PYR_TOWN_WEIGHT 16    /* presence of a village or city, in units */
 
 /* ======================================================================
    TYPES
@@ -79,29 +148,56 @@ typedef enum {
     T_COUNT  = 7
 } Terrain;
 
-typedef enum { E_UNIT=0, E_VILLAGE=1, E_CITY=2, E_MONSTER=3 } EKind;
-typedef enum { S_IDLE=0, S_SEEK=1, S_ATTACK=2, S_FLEE=3 }    UState;
-
+/* What an entity decided to do this tick.  The think phase fills one per
+   entity from the tick-start state; the commit phase carries them out. */
+typedef enum { I_NONE=0, I_MOVE=1, I_ATTACK=2 } IKind;
+enum {
+    I_WON     = 1 << 0,  /* move: this entity claimed its destination */
+    I_HOME    = 1 << 1,  /* fleeing unit: heal if it ends up beside home */
+    I_UPGRADE = 1 << 2,  /* village: becomes a city */
+    I_SPAWN   = 1 << 3,  /* building: spawn timer fired */
+};
 typedef struct {
-    int    alive;
-    EKind  kind;
-    int    civ;          /* 0..NCIV-1 for civ units; -1 for monsters */
-    int    x, y;
-    int    hp, max_hp;
-    int    atk;
-    UState state;
-    int    target;       /* entity index of current target, or -1 */
-    int    move_cd;      /* movement cooldown counter */
-    int    atk_cd;       /* attack cooldown counter */
-    int    spawn_timer;  /* buildings: ticks until next unit spawn */
-    int    age;          /* ticks this entity has been alive */
-} Ent;
+    uint8_t kind;        /* IKind */
+    uint8_t flags;
+    int16_t nx, ny;      /* I_MOVE destination */
+    int32_t other;       /* I_ATTACK defender, or the home for I_HOME */
+} Intent;
+
+/* A path search asked for while thinking and run after the tick's moves:
+   from (sx, sy) to within a tile of (gx, gy), on the map at epoch. */
+typedef struct {
+    EntRef   who;
+    int16_t  sx, sy, gx, gy;
+    uint32_t epoch;
+    uint8_t  status;     /* PathStatus, once searched */
+    uint8_t  len;
+    uint8_t  dir[PATH_CACHE];
+} PathReq;
 
 typedef struct {
     Terrain t;
     int     eid;         /* entity index occupying this tile, or -1 */
 } Tile;
 
+/* Summary of one square block of tiles for the zoomed-out views. */
+typedef struct {
+    uint16_t    terrain[T_COUNT];   /* tiles of each terrain */
+    uint16_t    towns;              /* villages and cities */
+    atomic_uint civ[MAX_CIV + 1];   /* presence by side, civ + 1 (0 for
+                                       monsters): units, plus
+                                       PYR_TOWN_WEIGHT per town */
+} PyrBlock;
+
+typedef struct {
+    int world_w, world_h;   /* world size in tiles */
+    int max_ents;           /* entity slots */
+    int nciv;               /* civilisations, 1..MAX_CIV */
+    int units_per_civ;      /* unit cap per civilisation */
+    int villages_per_civ;   /* starting villages per civilisation */
+    int threads;            /* simulation threads, counting the main one */
+} Config;
+
 typedef struct {
     int  active;
     char name[24];
@@ -114,15 +210,92 @@ typedef struct {
 /* ======================================================================
    GLOBALS
    ====================================================================== */
-static Tile  W[WH][WW];
-static Ent   E[MAX_E];
-static Civ   C[NCIV];
+static Config cfg = {
+    .world_w = 120, .world_h = 55, .max_ents = 1500, .nciv = 4,
+    .units_per_civ = 60, .villages_per_civ = 1, .threads = 1,
+};
+
+/* Every per-world array below is carved out of one ARENA_ALIGN-aligned
+   block by world_alloc(). */
+static unsigned char *arena;
+static Tile  *W;                  /* WH rows of WW tiles */
+static EntHot  E;                 /* MAX_E slots each */
+static EntCold EC;
+static Civ    C[MAX_CIV];
+#define TILE(x, y) W[(size_t)(y) * (size_t)WW + (size_t)(x)]
+
+/* Walkability of every tile for the pathfinder and its connected regions,
+   kept in step with W by tile_set_terrain(), the cluster graph long
+   searches run over (brought up to date at the start of each tick), and
+   one search scratch per thread.  Field c of homes leads to civ c's
+   nearest village or city; ent_place, ent_kill and tile_set_terrain keep
+   it current. */
+static PathMap   pmap;
+static RegionMap regions;
+static HpaGraph  pgraph;
+static PathPool *ppool;
+static FlowSet   homes;
+
+/* Uniform bucket grid over the world for proximity queries.  Each bucket
+   heads an intrusive doubly-linked list threaded through grid_next/prev. */
+#define GW ((WW + GRID_CELL - 1) / GRID_CELL)
+#define GH ((WH + GRID_CELL - 1) / GRID_CELL)
+static int   *grid_head;          /* GH×GW: first entity in bucket, or -1 */
+static int   *grid_next;
+static int   *grid_prev;
+
+/* LIFO free list of dead entity slots, threaded through free_next. */
+static int   free_head = -1;
+static int   *free_next;
+
+/* Dense lists of live entity indices per kind, so per-tick loops never
+   touch dead slots.  Kills are queued in dead_q and swap-removed by
+   ent_reap() between passes; until then the slot stays listed (with
+   alive == 0) and off the free list, so iteration order is unaffected. */
+enum { L_UNIT, L_MONSTER, L_BUILDING, L_COUNT };
+static int   *live[L_COUNT];
+static int   live_n[L_COUNT];
+static int   *live_pos;           /* index of each entity in its list */
+static int   *dead_q;
+static int   dead_n = 0;
+
+/* Per-tick work partition: the world is cut into horizontal strips of
+   strip_rows grid-bucket rows, and strip s owns strip_ents[strip_off[s] ..
+   strip_off[s+1]).  Strip edges follow bucket edges, so a move that stays
+   inside its strip touches only that strip's buckets and tiles. */
+static Intent *intent;            /* MAX_E slots */
+static int   nstrips = 1;
+static int   strip_rows = 1;
+static int   *strip_off;          /* nstrips+1 offsets into strip_ents */
+static int   *strip_fill;
+static int   *strip_ents;
+static int   *strip_cross;        /* moves leaving their strip, per strip */
+static int   *strip_ncross;
+static uint32_t sim_seed = 0;     /* keys the per-entity random rolls */
+
+/* Queued path searches, oldest first: preq[0 .. preq_n) waited from
+   earlier ticks, and think appends after them, taking slots with one
+   atomic add.  The first preq_done were searched at the end of the last
+   tick and are handed out at the start of this one. */
+static PathReq   *preq;           /* MAX_E slots */
+static int        preq_n    = 0;
+static int        preq_done = 0;
+static atomic_int preq_add;
+
+/* Overview pyramid: level z, PYR_MIN..ZOOM_MAX, sums up every 2^z-tile
+   square block, pyr_w[z] blocks across and pyr_h[z] down.  Kept current
+   by tile_set_terrain, ent_place, ent_kill and ent_move; moves run on
+   every thread at once, hence the atomic presence counts. */
+static PyrBlock *pyr[ZOOM_MAX + 1];
+static int       pyr_w[ZOOM_MAX + 1], pyr_h[ZOOM_MAX + 1];
 
 static int cam_x = 0, cam_y = 0;
-static int cur_x = WW/2, cur_y = WH/2;
+static int cur_x = 0, cur_y = 0;
+static int zoom      = 0;  /* each map cell shows 2^zoom x 2^zoom tiles */
 static int sel_civ   = 0;
 static int sel_power = 1;  /* 1-6 terrain; 7 unit; 8 village; 9 lightning; 10 meteor */
 static int paused    = 0;
+static int sim_speed = 1;  /* fast-forward multiplier, 1..MAX_SPEED */
 static int tick      = 0;
 static int quitting  = 0;
 static int view_w    = 80; /* updated each frame */
@@ -143,11 +316,295 @@ static int view_h    = 40;
 #define CP_MON    12   /* Monster — bold red */
 #define CP_CUR    13   /* cursor highlight   */
 #define CP_UI     14   /* side panel / bars  */
+#define CP_CIV4   15   /* Goblins — green    */
+#define CP_CIV5   16   /* Trolls  — blue     */
+#define CP_CIV6   17   /* Giants  — white    */
+#define CP_CIV7   18   /* Gnomes  — cyan     */
+#define CP_COUNT  19
+
+/* Foreground and background of each colour pair, for every backend */
+static const short PAIR_COLORS[CP_COUNT][2] = {
+    [CP_DEEP]   = { COLOR_BLUE,    COLOR_BLACK },
+    [CP_WATER]  = { COLOR_CYAN,    COLOR_BLACK },
+    [CP_SAND]   = { COLOR_YELLOW,  COLOR_BLACK },
+    [CP_PLAIN]  = { COLOR_GREEN,   COLOR_BLACK },
+    [CP_FOREST] = { COLOR_GREEN,   COLOR_BLACK },
+    [CP_MOUNT]  = { COLOR_WHITE,   COLOR_BLACK },
+    [CP_LAVA]   = { COLOR_RED,     COLOR_BLACK },
+    [CP_CIV0]   = { COLOR_RED,     COLOR_BLACK },
+    [CP_CIV1]   = { COLOR_CYAN,    COLOR_BLACK },
+    [CP_CIV2]   = { COLOR_YELLOW,  COLOR_BLACK },
+    [CP_CIV3]   = { COLOR_MAGENTA, COLOR_BLACK },
+    [CP_MON]    = { COLOR_RED,     COLOR_BLACK },
+    [CP_CUR]    = { COLOR_WHITE,   COLOR_WHITE },
+    [CP_UI]     = { COLOR_WHITE,   COLOR_BLACK },
+    [CP_CIV4]   = { COLOR_GREEN,   COLOR_BLACK },
+    [CP_CIV5]   = { COLOR_BLUE,    COLOR_BLACK },
+    [CP_CIV6]   = { COLOR_WHITE,   COLOR_BLACK },
+    [CP_CIV7]   = { COLOR_CYAN,    COLOR_BLACK },
+};
+
+/* Where frames go and keys come from.  size() reports the screen in
+   cells, put() takes one run of changed cells (returning 0 if it could
+   not, so the run is drawn again next frame) and present() shows every
+   run put since the last call; key() returns the next waiting key (KEY_*
+   for the arrows) or ERR.  scroll_lines() and shift_cells() move what
+   the screen already shows, for camera pans. */
+typedef struct {
+    const char *name;
+    int         counted;         /* its output is counted in be_bytes */
+    int  (*init)(void);          /* 0 if the screen cannot be set up */
+    void (*shutdown)(void);
+    void (*size)(int *rows, int *cols);
+    int  (*key)(void);
+    int  (*put)(int y, int x, const chtype *cells, int n);
+    void (*present)(void);
+    /* Move lines [top, bot) up n lines (down if n < 0), blanking the
+       lines uncovered.  Returns 0 if the screen cannot. */
+    int  (*scroll_lines)(int top, int bot, int n);
+    /* Move the first width cells of lines [top, bot) left n cells (right
+       if n < 0), blanking the cells uncovered and leaving those from
+       width on in place.  Returns 0 if the screen cannot. */
+    int  (*shift_cells)(int top, int bot, int width, int n);
+} Backend;
+
+static const Backend *be;
+static long           be_bytes = 0;   /* written to the terminal, where counted */
+
+/* ======================================================================
+   CONFIGURATION & ALLOCATION
+   ====================================================================== */
+/* Apply one "key value" setting.  Returns 0 for an unknown key or an
+   out-of-range value. */
+static int config_set(const char *key, const char *val)
+{
+    char *end;
+    long v = strtol(val, &end, 10);
+    if (end == val || *end != '\0') return 0;
+    if      (strcmp(key, "width") == 0    && v >= 16 && v <= MAX_WORLD) cfg.world_w = (int)v;
+    else if (strcmp(key, "height") == 0   && v >= 16 && v <= MAX_WORLD) cfg.world_h = (int)v;
+    else if (strcmp(key, "entities") == 0 && v >= 16 && v <= (1L << ENT_IDX_BITS))
+        cfg.max_ents = (int)v;
+    else if (strcmp(key, "civs") == 0     && v >= 1 && v <= MAX_CIV) cfg.nciv = (int)v;
+    else if (strcmp(key, "units") == 0    && v >= 0 && v <= (1L << ENT_IDX_BITS))
+        cfg.units_per_civ = (int)v;
+    else if (strcmp(key, "villages") == 0 && v >= 1 && v <= 4096)
+        cfg.villages_per_civ = (int)v;
+    else if (strcmp(key, "threads") == 0  && v >= 1 && v <= MAX_THREADS)
+        cfg.threads = (int)v;
+    else return 0;
+    return 1;
+}
+
+/* Read "key = value" lines ('#' starts a comment).  Returns 0 on the first
+   bad line, after reporting it. */
+static int config_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "god-casa: cannot open %s\n", path);
+        return 0;
+    }
+    char line[256];
+    int  lineno = 0, ok = 1;
+    while (ok && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char key[64], val[64];
+        int n = sscanf(line, " %63[a-z_] = %63s", key, val);
+        if (n <= 0) continue;  /* blank or comment-only */
+        if (n != 2 || !config_set(key, val)) {
+            fprintf(stderr, "god-casa: %s:%d: bad setting\n", path, lineno);
+            ok = 0;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/* Reserve an ARENA_ALIGN-rounded slice of the arena; returns its offset. */
+static size_t arena_take(size_t *top, size_t bytes)
+{
+    size_t at = *top;
+    *top += (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    return at;
+}
+
+/* Allocate every per-world array for the current cfg in one zeroed block. */
+static int world_alloc(void)
+{
+    size_t ne = (size_t)MAX_E, top = 0;
+    size_t o_w    = arena_take(&top, (size_t)WW * WH * sizeof(*W));
+    /* Hot entity arrays are laid out back to back, cold ones after them */
+    size_t o_alive = arena_take(&top, ne * sizeof(*E.alive));
+    size_t o_kind  = arena_take(&top, ne * sizeof(*E.kind));
+    size_t o_state = arena_take(&top, ne * sizeof(*E.state));
+    size_t o_civ   = arena_take(&top, ne * sizeof(*E.civ));
+    size_t o_x     = arena_take(&top, ne * sizeof(*E.x));
+    size_t o_y     = arena_take(&top, ne * sizeof(*E.y));
+    size_t o_hp    = arena_take(&top, ne * sizeof(*E.hp));
+    size_t o_mcd   = arena_take(&top, ne * sizeof(*E.move_cd));
+    size_t o_acd   = arena_take(&top, ne * sizeof(*E.atk_cd));
+    size_t o_tgt   = arena_take(&top, ne * sizeof(*E.target));
+    size_t o_gen   = arena_take(&top, ne * sizeof(*E.gen));
+    size_t o_mhp   = arena_take(&top, ne * sizeof(*EC.max_hp));
+    size_t o_atk   = arena_take(&top, ne * sizeof(*EC.atk));
+    size_t o_spawn = arena_take(&top, ne * sizeof(*EC.spawn_timer));
+    size_t o_age   = arena_take(&top, ne * sizeof(*EC.age));
+    size_t o_pdir  = arena_take(&top, ne * PATH_CACHE * sizeof(*EC.path_dir));
+    size_t o_plen  = arena_take(&top, ne * sizeof(*EC.path_len));
+    size_t o_ppos  = arena_take(&top, ne * sizeof(*EC.path_pos));
+    size_t o_px    = arena_take(&top, ne * sizeof(*EC.path_x));
+    size_t o_py    = arena_take(&top, ne * sizeof(*EC.path_y));
+    size_t o_pgx   = arena_take(&top, ne * sizeof(*EC.path_gx));
+    size_t o_pgy   = arena_take(&top, ne * sizeof(*EC.path_gy));
+    size_t o_pep   = arena_take(&top, ne * sizeof(*EC.path_epoch));
+    size_t o_pfl   = arena_take(&top, ne * sizeof(*EC.path_fail));
+    size_t o_pwt   = arena_take(&top, ne * sizeof(*EC.path_wait));
+    size_t o_gh   = arena_take(&top, (size_t)GW * GH * sizeof(*grid_head));
+    size_t o_gn   = arena_take(&top, ne * sizeof(*grid_next));
+    size_t o_gp   = arena_take(&top, ne * sizeof(*grid_prev));
+    size_t o_fn   = arena_take(&top, ne * sizeof(*free_next));
+    size_t o_lp   = arena_take(&top, ne * sizeof(*live_pos));
+    size_t o_dq   = arena_take(&top, ne * sizeof(*dead_q));
+    size_t o_live[L_COUNT];
+    for (int l = 0; l < L_COUNT; l++)
+        o_live[l] = arena_take(&top, ne * sizeof(*live[l]));
+    size_t o_int  = arena_take(&top, ne * sizeof(*intent));
+    size_t o_soff = arena_take(&top, (size_t)(GH + 1) * sizeof(*strip_off));
+    size_t o_sfil = arena_take(&top, (size_t)GH * sizeof(*strip_fill));
+    size_t o_sent = arena_take(&top, ne * sizeof(*strip_ents));
+    size_t o_scr  = arena_take(&top, ne * sizeof(*strip_cross));
+    size_t o_sncr = arena_take(&top, (size_t)GH * sizeof(*strip_ncross));
+    size_t o_preq = arena_take(&top, ne * sizeof(*preq));
+    size_t o_pyr[ZOOM_MAX + 1];
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        pyr_w[z] = (WW + (1 << z) - 1) >> z;
+        pyr_h[z] = (WH + (1 << z) - 1) >> z;
+        o_pyr[z] = arena_take(&top, (size_t)pyr_w[z] * pyr_h[z] * sizeof(*pyr[z]));
+    }
+
+    arena = aligned_alloc(ARENA_ALIGN, top);
+    if (!arena || path_map_init(&pmap, WW, WH) != 0 || region_init(&regions, WW, WH) != 0 ||
+        hpa_init(&pgraph, WW, WH) != 0 || flow_init(&homes, WW, WH, NCIV) != 0) {
+        fprintf(stderr, "god-casa: cannot allocate %zu bytes for a %dx%d world\n",
+                top, WW, WH);
+        return 0;
+    }
+    memset(arena, 0, top);
+    W         = (Tile *)(arena + o_w);
+    E.alive   = (uint8_t  *)(arena + o_alive);
+    E.kind    = (uint8_t  *)(arena + o_kind);
+    E.state   = (uint8_t  *)(arena + o_state);
+    E.civ     = (int8_t   *)(arena + o_civ);
+    E.x       = (int16_t  *)(arena + o_x);
+    E.y       = (int16_t  *)(arena + o_y);
+    E.hp      = (int16_t  *)(arena + o_hp);
+    E.move_cd = (uint8_t  *)(arena + o_mcd);
+    E.atk_cd  = (uint8_t  *)(arena + o_acd);
+    E.target  = (EntRef   *)(arena + o_tgt);
+    E.gen     = (uint16_t *)(arena + o_gen);
+    EC.max_hp      = (int16_t *)(arena + o_mhp);
+    EC.atk         = (int16_t *)(arena + o_atk);
+    EC.spawn_timer = (int16_t *)(arena + o_spawn);
+    EC.age         = (int32_t *)(arena + o_age);
+    EC.path_dir    = (uint8_t  *)(arena + o_pdir);
+    EC.path_len    = (uint8_t  *)(arena + o_plen);
+    EC.path_pos    = (uint8_t  *)(arena + o_ppos);
+    EC.path_x      = (int16_t  *)(arena + o_px);
+    EC.path_y      = (int16_t  *)(arena + o_py);
+    EC.path_gx     = (int16_t  *)(arena + o_pgx);
+    EC.path_gy     = (int16_t  *)(arena + o_pgy);
+    EC.path_epoch  = (uint32_t *)(arena + o_pep);
+    EC.path_fail   = (EntRef   *)(arena + o_pfl);
+    EC.path_wait   = (uint8_t  *)(arena + o_pwt);
+    grid_head = (int  *)(arena + o_gh);
+    grid_next = (int  *)(arena + o_gn);
+    grid_prev = (int  *)(arena + o_gp);
+    free_next = (int  *)(arena + o_fn);
+    live_pos  = (int  *)(arena + o_lp);
+    dead_q    = (int  *)(arena + o_dq);
+    for (int l = 0; l < L_COUNT; l++)
+        live[l] = (int *)(arena + o_live[l]);
+    intent       = (Intent *)(arena + o_int);
+    strip_off    = (int *)(arena + o_soff);
+    strip_fill   = (int *)(arena + o_sfil);
+    strip_ents   = (int *)(arena + o_sent);
+    strip_cross  = (int *)(arena + o_scr);
+    strip_ncross = (int *)(arena + o_sncr);
+    preq         = (PathReq *)(arena + o_preq);
+    /* W starts out all deep water, and so does every block */
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        pyr[z] = (PyrBlock *)(arena + o_pyr[z]);
+        for (int by = 0; by < pyr_h[z]; by++) {
+            int bh = (by + 1 < pyr_h[z] ? 1 << z : WH - (by << z));
+            for (int bx = 0; bx < pyr_w[z]; bx++) {
+                int bw = (bx + 1 < pyr_w[z] ? 1 << z : WW - (bx << z));
+                pyr[z][(size_t)by * pyr_w[z] + bx].terrain[T_DEEP] = (uint16_t)(bw * bh);
+            }
+        }
+    }
+    return 1;
+}
+
+/* ======================================================================
+   OVERVIEW PYRAMID
+   ====================================================================== */
+static PyrBlock *pyr_block(int z, int x, int y)
+{
+    return &pyr[z][(size_t)(y >> z) * (size_t)pyr_w[z] + (size_t)(x >> z)];
+}
+
+/* How much entity id adds to its side's presence in a block. */
+static unsigned pyr_weight(int id)
+{
+    return E.kind[id] == E_VILLAGE || E.kind[id] == E_CITY ? PYR_TOWN_WEIGHT : 1;
+}
+
+/* Tile (x, y) turned from terrain `from` to `to`. */
+static void pyr_terrain(int x, int y, Terrain from, Terrain to)
+{
+    if (from == to) return;
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        PyrBlock *b = pyr_block(z, x, y);
+        b->terrain[from]--;
+        b->terrain[to]++;
+    }
+}
+
+/* Entity id appeared on (sign 1) or vanished from (sign -1) its tile. */
+static void pyr_occupy(int id, int sign)
+{
+    unsigned w    = pyr_weight(id);
+    int      town = w > 1;
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        PyrBlock    *b = pyr_block(z, E.x[id], E.y[id]);
+        atomic_uint *c = &b->civ[E.civ[id] + 1];
+        if (sign > 0) atomic_fetch_add_explicit(c, w, memory_order_relaxed);
+        else          atomic_fetch_sub_explicit(c, w, memory_order_relaxed);
+        b->towns = (uint16_t)(b->towns + sign * town);
+    }
+}
+
+/* Entity id is stepping from its tile to (nx, ny).  Blocks nest, so from
+   the first level where both tiles share a block on, nothing changes. */
+static void pyr_step(int id, int nx, int ny)
+{
+    int      ox = E.x[id], oy = E.y[id], side = E.civ[id] + 1;
+    unsigned w  = pyr_weight(id);
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        if ((ox >> z) == (nx >> z) && (oy >> z) == (ny >> z)) break;
+        atomic_fetch_sub_explicit(&pyr_block(z, ox, oy)->civ[side], w, memory_order_relaxed);
+        atomic_fetch_add_explicit(&pyr_block(z, nx, ny)->civ[side], w, memory_order_relaxed);
+    }
+}
 
 /* ======================================================================
    NOISE & WORLD GENERATION
    ====================================================================== */
-static float noise_grid[WH+2][WW+2];
+static float *noise_grid;   /* (WH+2) rows of WW+2; only live during world_gen */
+#define NOISE(x, y) noise_grid[(size_t)(y) * (size_t)(WW + 2) + (size_t)(x)]
 
 static float lerp_f(float a, float b, float t) { return a + t*(b-a); }
 static float smooth(float t) { return t*t*(3.0f - 2.0f*t); }
@@ -156,7 +613,7 @@ static void noise_init(void)
 {
     for (int y = 0; y <= WH; y++)
         for (int x = 0; x <= WW; x++)
-            noise_grid[y][x] = (float)rand() / (float)RAND_MAX;
+            NOISE(x, y) = (float)rand() / (float)RAND_MAX;
 }
 
 static float noise_at(float fx, float fy)
@@ -166,8 +623,8 @@ static float noise_at(float fx, float fy)
     ix = ((ix % WW) + WW) % WW;
     iy = ((iy % WH) + WH) % WH;
     int ix1 = (ix+1) % WW, iy1 = (iy+1) % WH;
-    float v00 = noise_grid[iy ][ix ],  v10 = noise_grid[iy ][ix1];
-    float v01 = noise_grid[iy1][ix ],  v11 = noise_grid[iy1][ix1];
+    float v00 = NOISE(ix, iy ),  v10 = NOISE(ix1, iy );
+    float v01 = NOISE(ix, iy1),  v11 = NOISE(ix1, iy1);
     return lerp_f(lerp_f(v00, v10, smooth(tx)),
                   lerp_f(v01, v11, smooth(tx)), smooth(ty));
 }
@@ -184,12 +641,40 @@ static float fbm(float x, float y, int oct)
     return val / maxv;
 }
 
-static void world_gen(void)
+static int terrain_walkable(Terrain t)
 {
+    return t != T_DEEP && t != T_WATER && t != T_MOUNT && t != T_LAVA;
+}
+
+/* Change a tile's terrain.  Every terrain write goes through here so the
+   pathfinder's map and the overview pyramid stay in step. */
+static void tile_set_terrain(int x, int y, Terrain t)
+{
+    pyr_terrain(x, y, TILE(x, y).t, t);
+    TILE(x, y).t = t;
+    if (path_map_set(&pmap, x, y, terrain_walkable(t))) {
+        region_tile_changed(&regions, &pmap, x, y);
+        flow_tile_changed(&homes, &pmap, x, y);
+        hpa_tile_changed(&pgraph, x, y);
+    }
+}
+
+static void grid_clear(void)
+{
+    for (int by = 0; by < GH; by++)
+        for (int bx = 0; bx < GW; bx++)
+            grid_head[by * GW + bx] = -1;
+}
+
+static int world_gen(void)
+{
+    noise_grid = malloc((size_t)(WW + 2) * (size_t)(WH + 2) * sizeof(*noise_grid));
+    if (!noise_grid) return 0;
     noise_init();
+    grid_clear();
     for (int y = 0; y < WH; y++) {
         for (int x = 0; x < WW; x++) {
-            W[y][x].eid = -1;
+            TILE(x, y).eid = -1;
             float h = fbm((float)x / 28.0f, (float)y / 18.0f, 6);
             /* bias toward islands by subtracting distance from centre */
             float cx = (float)x/WW - 0.5f;
@@ -203,93 +688,218 @@ static void world_gen(void)
             else if (h < 0.73f) t = T_FOREST;
             else if (h < 0.86f) t = T_MOUNT;
             else                t = T_LAVA;
-            W[y][x].t = t;
+            tile_set_terrain(x, y, t);
         }
     }
+    free(noise_grid);
+    noise_grid = NULL;
+    return 1;
+}
+
+/* ======================================================================
+   SPATIAL GRID
+   ====================================================================== */
+static void grid_insert(int id)
+{
+    int *head = &grid_head[(E.y[id] / GRID_CELL) * GW + E.x[id] / GRID_CELL];
+    grid_prev[id] = -1;
+    grid_next[id] = *head;
+    if (*head >= 0) grid_prev[*head] = id;
+    *head = id;
+}
+
+static void grid_remove(int id)
+{
+    if (grid_prev[id] >= 0)
+        grid_next[grid_prev[id]] = grid_next[id];
+    else
+        grid_head[(E.y[id] / GRID_CELL) * GW + E.x[id] / GRID_CELL] = grid_next[id];
+    if (grid_next[id] >= 0) grid_prev[grid_next[id]] = grid_prev[id];
 }
 
 /* ======================================================================
    ENTITY MANAGEMENT
    ====================================================================== */
+static void ent_pool_init(void)
+{
+    free_head = -1;
+    for (int i = MAX_E - 1; i >= 0; i--) {
+        E.gen[i]     = 1;
+        free_next[i] = free_head;
+        free_head    = i;
+    }
+}
+
 static int ent_alloc(void)
 {
-    for (int i = 0; i < MAX_E; i++)
-        if (!E[i].alive) return i;
-    return -1;
+    int id = free_head;
+    if (id >= 0) free_head = free_next[id];
+    return id;
+}
+
+static int ent_list(EKind kind)
+{
+    switch (kind) {
+        case E_UNIT:    return L_UNIT;
+        case E_MONSTER: return L_MONSTER;
+        default:        return L_BUILDING;  /* villages and cities */
+    }
+}
+
+/* Drop queued kills from the live lists and return their slots to the
+   free list. */
+static void ent_reap(void)
+{
+    for (int k = 0; k < dead_n; k++) {
+        int id = dead_q[k];
+        int l  = ent_list(E.kind[id]);
+        int p  = live_pos[id];
+        int last = live[l][--live_n[l]];
+        live[l][p]     = last;
+        live_pos[last] = p;
+        free_next[id] = free_head;
+        free_head     = id;
+    }
+    dead_n = 0;
+}
+
+static EntRef ent_ref(int id)
+{
+    return ((EntRef)E.gen[id] << ENT_IDX_BITS) | (EntRef)id;
+}
+
+/* Slot index behind a handle, or -1 if that entity has since died. */
+static int ent_deref(EntRef r)
+{
+    if (r == ENT_NONE) return -1;
+    int id = (int)(r & ENT_IDX_MASK);
+    return (E.gen[id] == (r >> ENT_IDX_BITS)) ? id : -1;
 }
 
 static void ent_kill(int id)
 {
-    if (id < 0 || id >= MAX_E || !E[id].alive) return;
-    Ent *e = &E[id];
-    if (e->x >= 0 && e->x < WW && e->y >= 0 && e->y < WH)
-        if (W[e->y][e->x].eid == id)
-            W[e->y][e->x].eid = -1;
-    if (e->civ >= 0 && e->civ < NCIV) {
-        if (e->kind == E_UNIT)                          C[e->civ].units--;
-        else if (e->kind == E_VILLAGE || e->kind == E_CITY) C[e->civ].villages--;
+    if (id < 0 || id >= MAX_E || !E.alive[id]) return;
+    if (E.x[id] >= 0 && E.x[id] < WW && E.y[id] >= 0 && E.y[id] < WH)
+        if (TILE(E.x[id], E.y[id]).eid == id)
+            TILE(E.x[id], E.y[id]).eid = -1;
+    grid_remove(id);
+    if (E.civ[id] >= 0 && E.civ[id] < NCIV) {
+        EKind k = (EKind)E.kind[id];
+        if (k == E_UNIT) {
+            C[E.civ[id]].units--;
+        } else if (k == E_VILLAGE || k == E_CITY) {
+            C[E.civ[id]].villages--;
+            flow_remove_source(&homes, &pmap, E.civ[id], E.x[id], E.y[id]);
+        }
     }
-    e->alive = 0;
+    pyr_occupy(id, -1);
+    E.alive[id] = 0;
+    E.gen[id]   = (E.gen[id] % ENT_GEN_MAX) + 1;
+    dead_q[dead_n++] = id;
 }
 
 static int ent_place(EKind kind, int civ, int x, int y)
 {
     if (x < 0 || x >= WW || y < 0 || y >= WH) return -1;
-    if (W[y][x].eid >= 0) return -1;
+    if (TILE(x, y).eid >= 0) return -1;
     int id = ent_alloc();
     if (id < 0) return -1;
-    Ent *e = &E[id];
-    memset(e, 0, sizeof(*e));
-    e->alive  = 1;
-    e->kind   = kind;
-    e->civ    = civ;
-    e->x = x; e->y = y;
-    e->target = -1;
-    e->state  = S_IDLE;
+    E.alive[id]   = 1;
+    E.kind[id]    = (uint8_t)kind;
+    E.civ[id]     = (int8_t)civ;
+    E.x[id] = (int16_t)x; E.y[id] = (int16_t)y;
+    E.target[id]  = ENT_NONE;
+    E.state[id]   = S_IDLE;
+    E.move_cd[id] = 0;
+    E.atk_cd[id]  = 0;
+    EC.path_len[id]  = 0;
+    EC.path_pos[id]  = 0;
+    EC.path_fail[id] = ENT_NONE;
+    EC.path_wait[id] = 0;
+    memset(&intent[id], 0, sizeof(intent[id]));
+    EC.spawn_timer[id] = 0;
+    EC.age[id]         = 0;
     switch (kind) {
         case E_UNIT:
-            e->max_hp = UNIT_HP;    e->atk = UNIT_ATK;   break;
+            EC.max_hp[id] = UNIT_HP;    EC.atk[id] = UNIT_ATK;    break;
         case E_VILLAGE:
-            e->max_hp = VILLAGE_HP; e->atk = 0;
-            e->spawn_timer = UNIT_SPAWN_INT;             break;
+            EC.max_hp[id] = VILLAGE_HP; EC.atk[id] = 0;
+            EC.spawn_timer[id] = UNIT_SPAWN_INT;                  break;
         case E_CITY:
-            e->max_hp = CITY_HP;    e->atk = 0;
-            e->spawn_timer = CITY_SPAWN_INT;             break;
+            EC.max_hp[id] = CITY_HP;    EC.atk[id] = 0;
+            EC.spawn_timer[id] = CITY_SPAWN_INT;                  break;
         case E_MONSTER:
-            e->max_hp = MONSTER_HP; e->atk = MONSTER_ATK;
-            e->civ = -1;                                  break;
+            EC.max_hp[id] = MONSTER_HP; EC.atk[id] = MONSTER_ATK;
+            E.civ[id] = -1;                                       break;
     }
-    e->hp = e->max_hp;
-    W[y][x].eid = id;
+    E.hp[id] = EC.max_hp[id];
+    TILE(x, y).eid = id;
+    grid_insert(id);
+    pyr_occupy(id, 1);
+    int l = ent_list(kind);
+    live_pos[id] = live_n[l];
+    live[l][live_n[l]++] = id;
     if (civ >= 0 && civ < NCIV) {
-        if (kind == E_UNIT)                          C[civ].units++;
-        else if (kind == E_VILLAGE || kind == E_CITY) C[civ].villages++;
+        if (kind == E_UNIT) {
+            C[civ].units++;
+        } else if (kind == E_VILLAGE || kind == E_CITY) {
+            C[civ].villages++;
+            flow_add_source(&homes, &pmap, civ, x, y);
+        }
     }
     return id;
 }
 
-/* Find a walkable (land) tile at or near (*ox, *oy). */
-static int find_nearby_land(int *ox, int *oy)
+/* Relocate a live entity to the free tile (nx, ny), keeping the tile
+   occupancy, the spatial grid and the overview pyramid in sync. */
+static void ent_move(int id, int nx, int ny)
 {
+    TILE(E.x[id], E.y[id]).eid = -1;
+    pyr_step(id, nx, ny);
+    if (E.x[id] / GRID_CELL != nx / GRID_CELL || E.y[id] / GRID_CELL != ny / GRID_CELL) {
+        grid_remove(id);
+        E.x[id] = nx; E.y[id] = ny;
+        grid_insert(id);
+    } else {
+        E.x[id] = nx; E.y[id] = ny;
+    }
+    TILE(nx, ny).eid = id;
+}
+
+/* Find a free land tile at or near (*ox, *oy) in the given region, or in
+   any if region is 0.  Nothing of a region lies outside its box, so the
+   search stays inside it. */
+static int find_nearby_land(int *ox, int *oy, uint32_t region)
+{
+    int x0 = 0, y0 = 0, x1 = WW - 1, y1 = WH - 1, rmax = WH/2;
+    if (region) {
+        const int16_t *b = &regions.box[4 * (size_t)region];
+        x0 = b[0]; y0 = b[1]; x1 = b[2]; y1 = b[3];
+        int far = *ox - x0;
+        if (x1 - *ox > far) far = x1 - *ox;
+        if (*oy - y0 > far) far = *oy - y0;
+        if (y1 - *oy > far) far = y1 - *oy;
+        if (far < rmax) rmax = far;
+    }
     /* Expanding ring search */
-    for (int r = 0; r <= WH/2; r++) {
+    for (int r = 0; r <= rmax; r++) {
         for (int attempt = 0; attempt < 25; attempt++) {
             int nx = *ox + (rand() % (2*r+3)) - (r+1);
             int ny = *oy + (rand() % (2*r+3)) - (r+1);
-            if (nx < 0 || nx >= WW || ny < 0 || ny >= WH) continue;
-            Terrain t = W[ny][nx].t;
+            if (nx < x0 || nx > x1 || ny < y0 || ny > y1) continue;
+            Terrain t = TILE(nx, ny).t;
             if ((t == T_PLAIN || t == T_FOREST || t == T_SAND) &&
-                W[ny][nx].eid < 0) {
+                TILE(nx, ny).eid < 0 && (!region || region_of(&regions, nx, ny) == region)) {
                 *ox = nx; *oy = ny; return 1;
             }
         }
     }
-    /* Full-world fallback */
-    for (int y = 0; y < WH; y++)
-        for (int x = 0; x < WW; x++) {
-            Terrain t = W[y][x].t;
+    /* Fallback: every tile of the world, or of the region's box */
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++) {
+            Terrain t = TILE(x, y).t;
             if ((t == T_PLAIN || t == T_FOREST || t == T_SAND) &&
-                W[y][x].eid < 0) {
+                TILE(x, y).eid < 0 && (!region || region_of(&regions, x, y) == region)) {
                 *ox = x; *oy = y; return 1;
             }
         }
@@ -299,29 +909,37 @@ static int find_nearby_land(int *ox, int *oy)
 /* ======================================================================
    CIVILISATION INITIALISATION
    ====================================================================== */
-static const char *CIV_NAMES[NCIV] = { "Humans", "Elves", "Dwarves", "Orcs" };
-static const int   CIV_CPAIRS[NCIV] = { CP_CIV0, CP_CIV1, CP_CIV2, CP_CIV3 };
+static const char *CIV_NAMES[MAX_CIV] = {
+    "Humans", "Elves", "Dwarves", "Orcs", "Goblins", "Trolls", "Giants", "Gnomes"
+};
+static const int   CIV_CPAIRS[MAX_CIV] = {
+    CP_CIV0, CP_CIV1, CP_CIV2, CP_CIV3, CP_CIV4, CP_CIV5, CP_CIV6, CP_CIV7
+};
 
 static void civs_init(void)
 {
-    /* Starting positions in the four quadrants */
-    int starts[NCIV][2] = {
-        { WW/4,    WH/4   },
-        { 3*WW/4,  WH/4   },
-        { WW/4,    3*WH/4 },
-        { 3*WW/4,  3*WH/4 }
-    };
+    /* Each civ starts at the centre of its own sector of a cols×rows
+       layout (the four quadrants for the default four civs). */
+    int cols = 1;
+    while (cols * cols < NCIV) cols++;
+    int rows = (NCIV + cols - 1) / cols;
+    int sec_w = WW / cols, sec_h = WH / rows;
     for (int i = 0; i < NCIV; i++) {
         C[i].active = 1;
         strncpy(C[i].name, CIV_NAMES[i], 23);
         C[i].cpair = CIV_CPAIRS[i];
-        int sx = starts[i][0], sy = starts[i][1];
-        if (!find_nearby_land(&sx, &sy)) continue;
-        ent_place(E_VILLAGE, i, sx, sy);
-        for (int j = 0; j < 3; j++) {
-            int ux = sx, uy = sy;
-            if (find_nearby_land(&ux, &uy))
-                ent_place(E_UNIT, i, ux, uy);
+        int col = i % cols, row = i / cols;
+        for (int v = 0; v < cfg.villages_per_civ; v++) {
+            /* First village at the sector centre, extras anywhere in it */
+            int sx = v == 0 ? (2*col + 1) * WW / (2*cols) : col * sec_w + rand() % sec_w;
+            int sy = v == 0 ? (2*row + 1) * WH / (2*rows) : row * sec_h + rand() % sec_h;
+            if (!find_nearby_land(&sx, &sy, 0)) continue;
+            ent_place(E_VILLAGE, i, sx, sy);
+            for (int j = 0; j < 3; j++) {
+                int ux = sx, uy = sy;
+                if (find_nearby_land(&ux, &uy, region_of(&regions, sx, sy)))
+                    ent_place(E_UNIT, i, ux, uy);
+            }
         }
     }
 }
@@ -335,176 +953,367 @@ static int dist2(int x1, int y1, int x2, int y2)
     return dx*dx + dy*dy;
 }
 
-/* Return entity index of nearest enemy (different civ), or -1. */
-static int nearest_enemy(int eid)
+typedef int (*EntPred)(int me, int o);
+
+static int is_enemy(int me, int o)
 {
-    Ent *me = &E[eid];
-    int best = -1, bd = 1<<30;
-    for (int i = 0; i < MAX_E; i++) {
-        if (i == eid || !E[i].alive) continue;
-        Ent *o = &E[i];
-        int is_enemy = (me->civ == -1) ? (o->civ >= 0)   /* monster vs all */
-                                       : (o->civ != me->civ); /* civ vs others+monsters */
-        if (!is_enemy) continue;
-        int d = dist2(me->x, me->y, o->x, o->y);
-        if (d < bd) { bd = d; best = i; }
-    }
-    return best;
+    return (E.civ[me] == -1) ? (E.civ[o] >= 0)          /* monster vs all */
+                             : (E.civ[o] != E.civ[me]); /* civ vs others+monsters */
+}
+
+static int is_home(int me, int o)
+{
+    return E.civ[o] == E.civ[me] && (E.kind[o] == E_VILLAGE || E.kind[o] == E_CITY);
 }
 
-/* Return entity index of nearest friendly village/city, or -1. */
-static int nearest_home(int eid)
+/* Nearest entity matching pred strictly closer than limit (squared tiles),
+   or -1.  Buckets are visited in square rings around the searcher; ring r
+   is at least (r-1)*GRID_CELL+1 tiles away, so the search stops as soon as
+   that bound passes the best hit or the limit.  Ties go to the lower
+   index, matching a linear scan over all slots. */
+static int grid_nearest(int eid, int limit, EntPred pred)
 {
-    Ent *me = &E[eid];
-    int best = -1, bd = 1<<30;
-    for (int i = 0; i < MAX_E; i++) {
-        if (!E[i].alive || E[i].civ != me->civ) continue;
-        if (E[i].kind != E_VILLAGE && E[i].kind != E_CITY) continue;
-        int d = dist2(me->x, me->y, E[i].x, E[i].y);
-        if (d < bd) { bd = d; best = i; }
+    int bx = E.x[eid] / GRID_CELL, by = E.y[eid] / GRID_CELL;
+    int rmax = GW > GH ? GW : GH;
+    int best = -1, bd = limit;
+    for (int r = 0; r < rmax; r++) {
+        if (r > 0) {
+            long lb = (long)(r - 1) * GRID_CELL + 1;
+            if (lb * lb > bd) break;
+        }
+        for (int gy = by - r; gy <= by + r; gy++) {
+            if (gy < 0 || gy >= GH) continue;
+            int edge = (gy == by - r || gy == by + r);
+            for (int gx = bx - r; gx <= bx + r; gx += edge ? 1 : 2 * r) {
+                if (gx >= 0 && gx < GW) {
+                    for (int i = grid_head[gy * GW + gx]; i >= 0; i = grid_next[i]) {
+                        if (i == eid) continue;
+                        int d = dist2(E.x[eid], E.y[eid], E.x[i], E.y[i]);
+                        if (!(d < bd || (d == bd && best >= 0 && i < best))) continue;
+                        if (pred(eid, i)) {
+                            bd = d; best = i;
+                        }
+                    }
+                }
+                if (r == 0) break;
+            }
+        }
     }
     return best;
 }
 
-/* Move entity one step toward (tx,ty), avoiding impassable terrain. */
-static void move_towards(int eid, int tx, int ty)
+/* An enemy standing where a walk could take me: one on another island,
+   or walled off, is no target. */
+static int is_reachable_enemy(int me, int o)
+{
+    return is_enemy(me, o) && region_connected(&regions, E.x[me], E.y[me], E.x[o], E.y[o], 1);
+}
+
+/* Return entity index of nearest reachable enemy within ENEMY_DETECT_R2,
+   or -1. */
+static int nearest_enemy(int eid)
+{
+    return grid_nearest(eid, ENEMY_DETECT_R2, is_reachable_enemy);
+}
+
+
+/* Per-entity random roll for this tick: a hash of the world seed, the tick,
+   the slot and a salt, so the result does not depend on the order (or the
+   thread) in which entities are processed. */
+enum { RNG_WANDER = 1, RNG_DAMAGE = 2 };
+static uint32_t sim_rand(int id, uint32_t salt)
+{
+    uint32_t h = sim_seed ^ (uint32_t)tick * 0x9E3779B1u
+               ^ (uint32_t)id * 0x85EBCA77u ^ salt * 0xC2B2AE3Du;
+    h ^= h >> 16; h *= 0x7FEB352Du;
+    h ^= h >> 15; h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static int walkable(int x, int y)
+{
+    return path_walkable(&pmap, x, y);
+}
+
+static void plan_move(int eid, int nx, int ny)
 {
-    Ent *e = &E[eid];
-    int dx = (tx > e->x) ? 1 : (tx < e->x ? -1 : 0);
-    int dy = (ty > e->y) ? 1 : (ty < e->y ? -1 : 0);
+    intent[eid].kind = I_MOVE;
+    intent[eid].nx   = (int16_t)nx;
+    intent[eid].ny   = (int16_t)ny;
+}
+
+/* Plan one step toward (tx,ty), avoiding impassable terrain and tiles that
+   were occupied at the start of the tick. */
+static void step_towards(int eid, int tx, int ty)
+{
+    int dx = (tx > E.x[eid]) ? 1 : (tx < E.x[eid] ? -1 : 0);
+    int dy = (ty > E.y[eid]) ? 1 : (ty < E.y[eid] ? -1 : 0);
     /* Preferred direction first, then alternatives */
     int tries[5][2] = { {dx,dy}, {dx,0}, {0,dy}, {-dy,dx}, {dy,-dx} };
     for (int t = 0; t < 5; t++) {
-        int nx = e->x + tries[t][0];
-        int ny = e->y + tries[t][1];
-        if (nx < 0 || nx >= WW || ny < 0 || ny >= WH) continue;
-        Terrain tr = W[ny][nx].t;
-        if (tr == T_DEEP || tr == T_WATER || tr == T_MOUNT || tr == T_LAVA) continue;
-        if (W[ny][nx].eid >= 0) continue; /* occupied */
-        W[e->y][e->x].eid = -1;
-        e->x = nx; e->y = ny;
-        W[ny][nx].eid = eid;
+        int nx = E.x[eid] + tries[t][0];
+        int ny = E.y[eid] + tries[t][1];
+        if (!walkable(nx, ny)) continue;
+        if (TILE(nx, ny).eid >= 0) continue; /* occupied */
+        plan_move(eid, nx, ny);
         return;
     }
 }
 
+/* Queue a search from (x, y) toward (tx, ty) for the unit.  Returns 0 if
+   the queue is full. */
+static int path_request(int eid, int x, int y, int tx, int ty)
+{
+    int k = preq_n + atomic_fetch_add_explicit(&preq_add, 1, memory_order_relaxed);
+    if (k >= MAX_E) return 0;
+    PathReq *r = &preq[k];
+    r->who   = ent_ref(eid);
+    r->sx    = (int16_t)x;  r->sy = (int16_t)y;
+    r->gx    = (int16_t)tx; r->gy = (int16_t)ty;
+    r->epoch = pmap.epoch;
+    EC.path_wait[eid] = 1;
+    return 1;
+}
+
+/* How many of the steps dir[0..n) from (x, y) land on walkable tiles
+   before the first that does not. */
+static int path_clear(int x, int y, const uint8_t *dir, int n)
+{
+    for (int k = 0; k < n; k++) {
+        x += path_dx[dir[k]];
+        y += path_dy[dir[k]];
+        if (!path_walkable(&pmap, x, y)) return k;
+    }
+    return n;
+}
+
+/* Plan one step toward (tx, ty) along the unit's cached A* path.  A new
+   path is asked for once the cached one is used up or runs into a tile
+   that has stopped being walkable, the goal has drifted more than
+   PATH_SLACK, or the unit has been pushed off it.  Until it comes the
+   unit keeps to what is left of its old path, or steps greedily once
+   there is none.  A step into an occupied tile sidesteps greedily and
+   drops the path.  Returns 0 if nothing walkable reaches (tx, ty). */
+static int path_towards(int eid, int tx, int ty)
+{
+    int      x   = E.x[eid], y = E.y[eid];
+    int      len = EC.path_len[eid], pos = EC.path_pos[eid], cut = 0;
+    uint8_t *dir = &EC.path_dir[(size_t)eid * PATH_CACHE];
+    if (pos < len) {
+        int d = dir[pos];
+        if (x == EC.path_x[eid] + path_dx[d] && y == EC.path_y[eid] + path_dy[d])
+            pos++;                                  /* the last step went through */
+        else if (x != EC.path_x[eid] || y != EC.path_y[eid])
+            len = 0;
+    }
+    if (pos < len && EC.path_epoch[eid] != pmap.epoch) {
+        /* Some tile changed somewhere: keep the part still walkable */
+        int k = path_clear(x, y, dir + pos, len - pos);
+        cut = pos + k < len;
+        len = pos + k;
+    }
+    EC.path_epoch[eid] = pmap.epoch;
+    if (pos >= len || cut ||
+        abs(tx - EC.path_gx[eid]) > PATH_SLACK || abs(ty - EC.path_gy[eid]) > PATH_SLACK) {
+        if (!EC.path_wait[eid]) {
+            if (!region_connected(&regions, x, y, tx, ty, 1)) {
+                EC.path_len[eid] = 0;
+                return 0;
+            }
+            path_request(eid, x, y, tx, ty);
+        }
+        if (pos >= len) {
+            EC.path_len[eid] = 0;
+            step_towards(eid, tx, ty);
+            return 1;
+        }
+    }
+    EC.path_len[eid] = (uint8_t)len;
+    EC.path_pos[eid] = (uint8_t)pos;
+    EC.path_x[eid]   = (int16_t)x;
+    EC.path_y[eid]   = (int16_t)y;
+    int nx = x + path_dx[dir[pos]], ny = y + path_dy[dir[pos]];
+    if (TILE(nx, ny).eid >= 0) {
+        EC.path_len[eid] = 0;
+        step_towards(eid, tx, ty);
+        return 1;
+    }
+    plan_move(eid, nx, ny);
+    return 1;
+}
+
+/* Plan one step down the unit's civ's home field: its own direction, or
+   if that tile is taken any free neighbour that is also closer.  Returns
+   0 if no home can be reached from here. */
+static int flow_step(int eid)
+{
+    int civ = E.civ[eid], x = E.x[eid], y = E.y[eid];
+    int here = flow_dist(&homes, civ, x, y);
+    if (here == FLOW_FAR) return 0;
+    int d = flow_dir(&homes, civ, x, y);
+    if (d != FLOW_NO_DIR && TILE(x + path_dx[d], y + path_dy[d]).eid < 0) {
+        plan_move(eid, x + path_dx[d], y + path_dy[d]);
+        return 1;
+    }
+    for (d = 0; d < 8; d++) {
+        int nx = x + path_dx[d], ny = y + path_dy[d];
+        if (walkable(nx, ny) && TILE(nx, ny).eid < 0 && flow_dist(&homes, civ, nx, ny) < here) {
+            plan_move(eid, nx, ny);
+            return 1;
+        }
+    }
+    return 1;
+}
+
+/* A home of this unit's civ beside where it will stand after its planned
+   move, or -1. */
+static int home_beside(int eid)
+{
+    int x = intent[eid].kind == I_MOVE ? intent[eid].nx : E.x[eid];
+    int y = intent[eid].kind == I_MOVE ? intent[eid].ny : E.y[eid];
+    for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++) {
+            int ox = x + dx, oy = y + dy;
+            if (ox < 0 || ox >= WW || oy < 0 || oy >= WH) continue;
+            int o = TILE(ox, oy).eid;
+            if (o >= 0 && o != eid && is_home(eid, o)) return o;
+        }
+    return -1;
+}
+
 /* ======================================================================
    COMBAT
    ====================================================================== */
 static void do_attack(int attacker, int defender)
 {
-    if (!E[attacker].alive || !E[defender].alive) return;
-    Ent *a = &E[attacker];
-    Ent *d = &E[defender];
-    int dmg = a->atk + (rand() % 5) - 2;
+    if (!E.alive[attacker] || !E.alive[defender]) return;
+    int dmg = EC.atk[attacker] + (int)(sim_rand(attacker, RNG_DAMAGE) % 5) - 2;
     if (dmg < 1) dmg = 1;
-    d->hp -= dmg;
-    if (d->hp <= 0) {
-        if (a->civ >= 0 && a->civ < NCIV) C[a->civ].kills++;
+    E.hp[defender] -= dmg;
+    if (E.hp[defender] <= 0) {
+        if (E.civ[attacker] >= 0 && E.civ[attacker] < NCIV) C[E.civ[attacker]].kills++;
         ent_kill(defender);
     }
 }
 
 /* ======================================================================
    SIMULATION
-   ====================================================================== */
+   ======================================================================
+   A tick runs in two phases.  THINK runs sim_unit/sim_building over every
+   strip in parallel: each entity reads only the state as it was at the
+   start of the tick, writes only its own fields, and records what it wants
+   to do in intent[].  COMMIT then carries the intents out:
+
+     attacks    serially, units then monsters, in live-list order
+     claims     in parallel: a contested tile goes to the lowest slot
+     moves      in parallel within a strip; moves into another strip and
+                their heal checks run serially afterwards
+     buildings  upgrades and spawns serially, in live-list order
+
+   A unit that needs a new path queues a request while thinking instead of
+   searching.  The queue is put in slot order once think is done, the
+   oldest PATH_SOLVES requests are searched on the workers after the moves,
+   and their results are handed out in queue order as the next tick starts,
+   so a crowd asking at once is spread over the ticks that follow.
+
+   No step depends on how entities were split into strips or which thread
+   ran them, so any thread count gives the same result as one thread. */
+static void wander(int eid)
+{
+    uint32_t r = sim_rand(eid, RNG_WANDER);
+    int nx = E.x[eid] + (int)(r % 3) - 1;
+    int ny = E.y[eid] + (int)((r >> 16) % 3) - 1;
+    if (walkable(nx, ny) && TILE(nx, ny).eid < 0)
+        plan_move(eid, nx, ny);
+}
+
 static void sim_unit(int eid)
 {
-    Ent *e = &E[eid];
-    if (e->move_cd > 0) e->move_cd--;
-    if (e->atk_cd  > 0) e->atk_cd--;
-    e->age++;
+    memset(&intent[eid], 0, sizeof(intent[eid]));
+    if (E.move_cd[eid] > 0) E.move_cd[eid]--;
+    if (E.atk_cd[eid]  > 0) E.atk_cd[eid]--;
+    EC.age[eid]++;
 
-    /* Invalidate stale target */
-    if (e->target >= 0) {
-        Ent *tgt = &E[e->target];
-        if (!tgt->alive || tgt->civ == e->civ)
-            e->target = -1;
-    }
+    /* A generation mismatch means the target died, even if its slot has
+       been recycled since */
+    int tgt = ent_deref(E.target[eid]);
+    if (tgt < 0) E.target[eid] = ENT_NONE;
 
     /* Trigger flee on low HP */
-    if (e->hp < e->max_hp / 4 && e->state != S_FLEE)
-        e->state = S_FLEE;
+    if (E.hp[eid] < EC.max_hp[eid] / 4 && E.state[eid] != S_FLEE)
+        E.state[eid] = S_FLEE;
 
-    switch (e->state) {
+    switch (E.state[eid]) {
         case S_IDLE: {
             /* Random wander */
-            if (e->move_cd == 0) {
-                int nx = e->x + (rand()%3) - 1;
-                int ny = e->y + (rand()%3) - 1;
-                if (nx >= 0 && nx < WW && ny >= 0 && ny < WH) {
-                    Terrain tr = W[ny][nx].t;
-                    if (tr != T_DEEP && tr != T_WATER && tr != T_MOUNT && tr != T_LAVA
-                        && W[ny][nx].eid < 0) {
-                        W[e->y][e->x].eid = -1;
-                        e->x = nx; e->y = ny;
-                        W[ny][nx].eid = eid;
-                    }
-                }
-                e->move_cd = UNIT_MOVE_CD;
+            if (E.move_cd[eid] == 0) {
+                wander(eid);
+                E.move_cd[eid] = UNIT_MOVE_CD;
             }
-            /* Scan for nearby enemies every 5 ticks */
+            /* Scan for nearby enemies every 5 ticks, passing over one
+               already found unreachable on this terrain */
             if (tick % 5 == (eid % 5)) {
                 int en = nearest_enemy(eid);
-                if (en >= 0 && dist2(e->x, e->y, E[en].x, E[en].y) < ENEMY_DETECT_R2) {
-                    e->target = en;
-                    e->state  = S_SEEK;
+                if (en >= 0 && !(ent_ref(en) == EC.path_fail[eid] &&
+                                 EC.path_epoch[eid] == pmap.epoch)) {
+                    E.target[eid] = ent_ref(en);
+                    E.state[eid]  = S_SEEK;
                 }
             }
             break;
         }
         case S_SEEK: {
-            if (e->target < 0) { e->state = S_IDLE; break; }
-            int d = dist2(e->x, e->y, E[e->target].x, E[e->target].y);
+            if (tgt < 0) { E.state[eid] = S_IDLE; break; }
+            int d = dist2(E.x[eid], E.y[eid], E.x[tgt], E.y[tgt]);
             if (d <= 2) {
-                e->state = S_ATTACK;
-            } else if (e->move_cd == 0) {
-                move_towards(eid, E[e->target].x, E[e->target].y);
-                e->move_cd = UNIT_MOVE_CD;
+                E.state[eid] = S_ATTACK;
+            } else if (E.move_cd[eid] == 0) {
+                if (!path_towards(eid, E.x[tgt], E.y[tgt])) {
+                    EC.path_fail[eid] = E.target[eid];
+                    E.target[eid]     = ENT_NONE;
+                    E.state[eid]      = S_IDLE;
+                }
+                E.move_cd[eid] = UNIT_MOVE_CD;
             }
             break;
         }
         case S_ATTACK: {
-            if (e->target < 0) { e->state = S_IDLE; break; }
-            int d = dist2(e->x, e->y, E[e->target].x, E[e->target].y);
+            if (tgt < 0) { E.state[eid] = S_IDLE; break; }
+            int d = dist2(E.x[eid], E.y[eid], E.x[tgt], E.y[tgt]);
             if (d > 2) {
-                e->state = S_SEEK;
-            } else if (e->atk_cd == 0) {
-                do_attack(eid, e->target);
-                e->atk_cd = UNIT_ATK_CD;
-                if (e->target >= 0 && !E[e->target].alive) {
-                    e->target = -1;
-                    e->state  = S_IDLE;
-                }
+                E.state[eid] = S_SEEK;
+            } else if (E.atk_cd[eid] == 0) {
+                intent[eid].kind  = I_ATTACK;
+                intent[eid].other = tgt;
+                E.atk_cd[eid] = UNIT_ATK_CD;
             }
             break;
         }
         case S_FLEE: {
-            if (e->hp >= e->max_hp / 2) { e->state = S_IDLE; break; }
-            if (e->civ < 0) {
+            if (E.hp[eid] >= EC.max_hp[eid] / 2) { E.state[eid] = S_IDLE; break; }
+            if (E.civ[eid] < 0) {
                 /* monsters: just wander in flee state */
-                if (e->move_cd == 0) {
-                    int nx = e->x + (rand()%3) - 1;
-                    int ny = e->y + (rand()%3) - 1;
+                if (E.move_cd[eid] == 0) {
+                    uint32_t r = sim_rand(eid, RNG_WANDER);
+                    int nx = E.x[eid] + (int)(r % 3) - 1;
+                    int ny = E.y[eid] + (int)((r >> 16) % 3) - 1;
                     if (nx >= 0 && nx < WW && ny >= 0 && ny < WH
-                        && W[ny][nx].t != T_DEEP && W[ny][nx].t != T_WATER
-                        && W[ny][nx].eid < 0) {
-                        W[e->y][e->x].eid = -1;
-                        e->x = nx; e->y = ny;
-                        W[ny][nx].eid = eid;
-                    }
-                    e->move_cd = UNIT_MOVE_CD;
+                        && TILE(nx, ny).t != T_DEEP && TILE(nx, ny).t != T_WATER
+                        && TILE(nx, ny).eid < 0)
+                        plan_move(eid, nx, ny);
+                    E.move_cd[eid] = UNIT_MOVE_CD;
                 }
                 break;
             }
-            int fv = nearest_home(eid);
-            if (fv >= 0 && e->move_cd == 0) {
-                move_towards(eid, E[fv].x, E[fv].y);
-                e->move_cd = UNIT_MOVE_CD - 1;
-                /* Heal at home */
-                if (dist2(e->x, e->y, E[fv].x, E[fv].y) < 4) {
-                    e->hp    = e->max_hp;
-                    e->state = S_IDLE;
+            if (homes.nsrc[E.civ[eid]] > 0 && E.move_cd[eid] == 0) {
+                if (!flow_step(eid)) wander(eid);
+                E.move_cd[eid] = UNIT_MOVE_CD - 1;
+                /* Heal at home, checked once the move is done */
+                int fv = home_beside(eid);
+                if (fv >= 0) {
+                    intent[eid].flags |= I_HOME;
+                    intent[eid].other  = fv;
                 }
             }
             break;
@@ -514,23 +1323,18 @@ static void sim_unit(int eid)
 
 static void sim_building(int eid)
 {
-    Ent *e = &E[eid];
-    e->age++;
+    memset(&intent[eid], 0, sizeof(intent[eid]));
+    EC.age[eid]++;
     /* Village → City upgrade: runs every tick, independent of spawn timer */
-    if (e->kind == E_VILLAGE && e->age >= VILLAGE_AGE_UP) {
-        e->kind        = E_CITY;
-        e->max_hp      = CITY_HP;
-        e->hp          = CITY_HP;
-        e->spawn_timer = CITY_SPAWN_INT;
-        /* village count unchanged: cities are still tracked as villages in the UI */
+    EKind kind = (EKind)E.kind[eid];
+    if (kind == E_VILLAGE && EC.age[eid] >= VILLAGE_AGE_UP) {
+        kind = E_CITY;
+        EC.spawn_timer[eid] = CITY_SPAWN_INT;
+        intent[eid].flags |= I_UPGRADE;
     }
-    if (--e->spawn_timer <= 0) {
-        e->spawn_timer = (e->kind == E_CITY) ? CITY_SPAWN_INT : UNIT_SPAWN_INT;
-        if (e->civ >= 0 && C[e->civ].units < MAX_UNITS_CIV) {
-            int ux = e->x, uy = e->y;
-            if (find_nearby_land(&ux, &uy))
-                ent_place(E_UNIT, e->civ, ux, uy);
-        }
+    if (--EC.spawn_timer[eid] <= 0) {
+        EC.spawn_timer[eid] = (kind == E_CITY) ? CITY_SPAWN_INT : UNIT_SPAWN_INT;
+        if (E.civ[eid] >= 0) intent[eid].flags |= I_SPAWN;
     }
 }
 
@@ -538,54 +1342,371 @@ static void sim_monster_spawn(void)
 {
     if (rand() % 150 != 0) return;
     int x = rand() % WW, y = rand() % WH;
-    Terrain t = W[y][x].t;
-    if ((t == T_PLAIN || t == T_FOREST) && W[y][x].eid < 0)
+    Terrain t = TILE(x, y).t;
+    if ((t == T_PLAIN || t == T_FOREST) && TILE(x, y).eid < 0)
         ent_place(E_MONSTER, -1, x, y);
 }
 
+/* Choose the strip layout for the current thread count.  One thread gets
+   a single strip so the serial tick pays no partitioning cost. */
+static void strips_init(void)
+{
+    int want = jobs_threads() > 1 ? jobs_threads() * STRIPS_PER_THREAD : 1;
+    if (want > GH) want = GH;
+    strip_rows = (GH + want - 1) / want;
+    nstrips    = (GH + strip_rows - 1) / strip_rows;
+}
+
+static int ent_strip(int id)
+{
+    return (E.y[id] / GRID_CELL) / strip_rows;
+}
+
+/* Bucket the live entities by strip, keeping live-list order within each. */
+static void strips_build(void)
+{
+    memset(strip_off, 0, (size_t)(nstrips + 1) * sizeof(*strip_off));
+    for (int l = 0; l < L_COUNT; l++)
+        for (int k = 0; k < live_n[l]; k++)
+            strip_off[ent_strip(live[l][k]) + 1]++;
+    for (int s = 0; s < nstrips; s++) {
+        strip_off[s + 1] += strip_off[s];
+        strip_fill[s]     = strip_off[s];
+        strip_ncross[s]   = 0;
+    }
+    for (int l = 0; l < L_COUNT; l++)
+        for (int k = 0; k < live_n[l]; k++) {
+            int id = live[l][k];
+            strip_ents[strip_fill[ent_strip(id)]++] = id;
+        }
+}
+
+static void think_strip(void *ctx, int s)
+{
+    (void)ctx;
+    for (int k = strip_off[s]; k < strip_off[s + 1]; k++) {
+        int id = strip_ents[k];
+        if (E.kind[id] == E_UNIT || E.kind[id] == E_MONSTER) sim_unit(id);
+        else                                                 sim_building(id);
+    }
+}
+
+static void commit_attacks(void)
+{
+    for (int l = L_UNIT; l <= L_MONSTER; l++) {
+        int n = live_n[l];
+        for (int k = 0; k < n; k++) {
+            int id = live[l][k];
+            if (!E.alive[id] || intent[id].kind != I_ATTACK) continue;
+            int tgt = intent[id].other;
+            do_attack(id, tgt);
+            if (!E.alive[tgt]) {
+                E.target[id] = ENT_NONE;
+                E.state[id]  = S_IDLE;
+            }
+        }
+    }
+}
+
+/* A mover wins its destination unless a lower slot next to that tile is
+   still alive and wants the same tile.  Read-only, so strips run freely. */
+static void claim_strip(void *ctx, int s)
+{
+    (void)ctx;
+    for (int k = strip_off[s]; k < strip_off[s + 1]; k++) {
+        int id = strip_ents[k];
+        if (!E.alive[id] || intent[id].kind != I_MOVE) continue;
+        int tx = intent[id].nx, ty = intent[id].ny, won = 1;
+        for (int dy = -1; dy <= 1 && won; dy++)
+            for (int dx = -1; dx <= 1; dx++) {
+                int ox = tx + dx, oy = ty + dy;
+                if (ox < 0 || ox >= WW || oy < 0 || oy >= WH) continue;
+                int o = TILE(ox, oy).eid;
+                if (o >= 0 && o < id && intent[o].kind == I_MOVE
+                    && intent[o].nx == tx && intent[o].ny == ty) {
+                    won = 0;
+                    break;
+                }
+            }
+        if (won) intent[id].flags |= I_WON;
+    }
+}
+
+static void commit_heal(int id)
+{
+    int fv = intent[id].other;
+    if ((intent[id].flags & I_HOME) && dist2(E.x[id], E.y[id], E.x[fv], E.y[fv]) < 4) {
+        E.hp[id]    = EC.max_hp[id];
+        E.state[id] = S_IDLE;
+    }
+}
+
+static void move_strip(void *ctx, int s)
+{
+    (void)ctx;
+    for (int k = strip_off[s]; k < strip_off[s + 1]; k++) {
+        int id = strip_ents[k];
+        if (!E.alive[id]) continue;
+        if (intent[id].kind == I_MOVE && (intent[id].flags & I_WON)) {
+            if ((intent[id].ny / GRID_CELL) / strip_rows != s) {
+                strip_cross[strip_off[s] + strip_ncross[s]++] = id;
+                continue;
+            }
+            ent_move(id, intent[id].nx, intent[id].ny);
+        }
+        commit_heal(id);
+    }
+}
+
+static void commit_crossers(void)
+{
+    for (int s = 0; s < nstrips; s++)
+        for (int k = 0; k < strip_ncross[s]; k++) {
+            int id = strip_cross[strip_off[s] + k];
+            ent_move(id, intent[id].nx, intent[id].ny);
+            commit_heal(id);
+        }
+}
+
+static void commit_buildings(void)
+{
+    int nb = live_n[L_BUILDING];
+    for (int k = 0; k < nb; k++) {
+        int id = live[L_BUILDING][k];
+        if (!E.alive[id]) continue;
+        if (intent[id].flags & I_UPGRADE) {
+            E.kind[id]     = E_CITY;
+            EC.max_hp[id]  = CITY_HP;
+            E.hp[id]       = CITY_HP;
+            /* village count unchanged: cities are still tracked as villages in the UI */
+        }
+        if ((intent[id].flags & I_SPAWN) && C[E.civ[id]].units < MAX_UNITS_CIV) {
+            int ux = E.x[id], uy = E.y[id];
+            if (find_nearby_land(&ux, &uy, region_of(&regions, ux, uy)))
+                ent_place(E_UNIT, E.civ[id], ux, uy);
+        }
+    }
+}
+
+static int preq_cmp(const void *a, const void *b)
+{
+    uint32_t ia = ((const PathReq *)a)->who & ENT_IDX_MASK;
+    uint32_t ib = ((const PathReq *)b)->who & ENT_IDX_MASK;
+    return (ia > ib) - (ia < ib);
+}
+
+/* Take in this tick's requests, in slot order whatever thread made them,
+   and drop the ones whose unit has died. */
+static void path_queue(void)
+{
+    int add = atomic_exchange_explicit(&preq_add, 0, memory_order_relaxed);
+    if (add > MAX_E - preq_n) add = MAX_E - preq_n;
+    qsort(&preq[preq_n], (size_t)add, sizeof(*preq), preq_cmp);
+    int n = 0;
+    for (int k = 0; k < preq_n + add; k++)
+        if (ent_deref(preq[k].who) >= 0) preq[n++] = preq[k];
+    preq_n = n;
+}
+
+/* Each job holds one scratch, and no more jobs run at once than there are
+   threads, which is what ppool is sized to: a search never goes without. */
+static void solve_chunk(void *ctx, int c)
+{
+    (void)ctx;
+    PathScratch *ps  = path_pool_acquire(ppool);
+    int          end = (c + 1) * PATH_SOLVE_CHUNK;
+    if (!ps) {
+        fprintf(stderr, "god-casa: path scratch pool smaller than the thread count\n");
+        abort();
+    }
+    if (end > preq_done) end = preq_done;
+    for (int k = c * PATH_SOLVE_CHUNK; k < end; k++) {
+        PathReq *r = &preq[k];
+        int      n = 0;
+        r->status = (uint8_t)hpa_find(&pgraph, &pmap, ps, r->sx, r->sy, r->gx, r->gy, 1,
+                                      r->dir, PATH_CACHE, &n);
+        r->len    = (uint8_t)n;
+    }
+    path_pool_release(ppool, ps);
+}
+
+/* Search the oldest PATH_SOLVES requests.  Nothing reads them until the
+   next tick, and each touches only its own entry. */
+static void path_solve(void)
+{
+    preq_done = preq_n < PATH_SOLVES ? preq_n : PATH_SOLVES;
+    jobs_parallel_for((preq_done + PATH_SOLVE_CHUNK - 1) / PATH_SOLVE_CHUNK, solve_chunk, NULL);
+}
+
+/* Hand out last tick's results in queue order.  The unit may have walked
+   its old path meanwhile, so the new one is picked up wherever the unit
+   stands on it, and only as far as its tiles are still walkable; one the
+   unit is off is dropped for the unit to ask again.  "Unreachable" only
+   stands if no tile has changed since the search. */
+static void path_deliver(void)
+{
+    for (int k = 0; k < preq_done; k++) {
+        const PathReq *r  = &preq[k];
+        int            id = ent_deref(r->who);
+        if (id < 0) continue;
+        EC.path_wait[id] = 0;
+        if (r->status == PATH_NONE) {
+            if (r->epoch != pmap.epoch) continue;
+            EC.path_len[id]   = 0;
+            EC.path_epoch[id] = pmap.epoch;
+            if (E.state[id] == S_SEEK) {
+                EC.path_fail[id] = E.target[id];
+                E.target[id]     = ENT_NONE;
+                E.state[id]      = S_IDLE;
+            }
+            continue;
+        }
+        int x = r->sx, y = r->sy, pos = 0;
+        while (pos < r->len && (x != E.x[id] || y != E.y[id])) {
+            x += path_dx[r->dir[pos]];
+            y += path_dy[r->dir[pos]];
+            pos++;
+        }
+        if (x != E.x[id] || y != E.y[id]) continue;
+        int len = pos + path_clear(x, y, r->dir + pos, r->len - pos);
+        if (len <= pos) continue;
+        memcpy(&EC.path_dir[(size_t)id * PATH_CACHE], r->dir, (size_t)len);
+        EC.path_len[id]   = (uint8_t)len;
+        EC.path_pos[id]   = (uint8_t)pos;
+        EC.path_x[id]     = (int16_t)x;
+        EC.path_y[id]     = (int16_t)y;
+        EC.path_gx[id]    = r->gx;
+        EC.path_gy[id]    = r->gy;
+        EC.path_epoch[id] = pmap.epoch;
+    }
+    preq_n -= preq_done;
+    memmove(preq, preq + preq_done, (size_t)preq_n * sizeof(*preq));
+    preq_done = 0;
+}
+
 static void sim_step(void)
 {
     tick++;
     global_tick++;
+    ent_reap();
     sim_monster_spawn();
-    for (int i = 0; i < MAX_E; i++) {
-        if (!E[i].alive) continue;
-        if (E[i].kind == E_UNIT || E[i].kind == E_MONSTER)
-            sim_unit(i);
-        else
-            sim_building(i);
-    }
+    hpa_sync(&pgraph, &pmap);
+    path_deliver();
+    strips_build();
+    jobs_parallel_for(nstrips, think_strip, NULL);
+    path_queue();
+    /* Anything spawned from here on is appended and acts next tick */
+    commit_attacks();
+    jobs_parallel_for(nstrips, claim_strip, NULL);
+    jobs_parallel_for(nstrips, move_strip, NULL);
+    commit_crossers();
+    commit_buildings();
+    ent_reap();
+    path_solve();
 }
 
 /* ======================================================================
    RENDERING
    ====================================================================== */
-static void tile_glyph(int wx, int wy, int *ch, int *cp, int *attr)
-{
-    *attr = A_NORMAL;
-    Tile *t = &W[wy][wx];
-    if (t->eid >= 0) {
-        Ent *e = &E[t->eid];
-        *cp   = (e->civ >= 0 && e->civ < NCIV) ? C[e->civ].cpair : CP_MON;
-        *attr = A_BOLD;
-        switch (e->kind) {
-            case E_UNIT:    *ch = (e->civ < 0) ? 'M' : 'u'; return;
-            case E_VILLAGE: *ch = 'V'; return;
-            case E_CITY:    *ch = 'C'; return;
-            case E_MONSTER: *ch = 'M'; *cp = CP_MON; return;
-            default:        *ch = '?'; *cp = CP_UI;  return;
-        }
-    }
-    switch (t->t) {
-        case T_DEEP:   *ch = '~'; *cp = CP_DEEP;   *attr = A_BOLD;   return;
-        case T_WATER:  *ch = '~'; *cp = CP_WATER;                     return;
-        case T_SAND:   *ch = ','; *cp = CP_SAND;                      return;
-        case T_PLAIN:  *ch = '.'; *cp = CP_PLAIN;                     return;
-        case T_FOREST: *ch = 'T'; *cp = CP_FOREST;  *attr = A_BOLD;  return;
-        case T_MOUNT:  *ch = '^'; *cp = CP_MOUNT;   *attr = A_BOLD;  return;
-        case T_LAVA:   *ch = '*'; *cp = CP_LAVA;    *attr = A_BOLD;  return;
-        default:       *ch = ' '; *cp = CP_PLAIN;                     return;
+/* What each terrain and each entity looks like on screen, glyph, colour
+   pair and attributes in one chtype.  Entities are indexed by civ + 1
+   (0 for monsters) and kind.  Filled by glyphs_init() once the colour
+   pairs exist. */
+static chtype glyph_terrain[T_COUNT];
+static chtype glyph_ent[MAX_CIV + 1][4];
+
+static void glyphs_init(void)
+{
+    static const struct { char ch; short cp; chtype attr; } terrain[T_COUNT] = {
+        [T_DEEP]   = { '~', CP_DEEP,   A_BOLD   },
+        [T_WATER]  = { '~', CP_WATER,  A_NORMAL },
+        [T_SAND]   = { ',', CP_SAND,   A_NORMAL },
+        [T_PLAIN]  = { '.', CP_PLAIN,  A_NORMAL },
+        [T_FOREST] = { 'T', CP_FOREST, A_BOLD   },
+        [T_MOUNT]  = { '^', CP_MOUNT,  A_BOLD   },
+        [T_LAVA]   = { '*', CP_LAVA,   A_BOLD   },
+    };
+    for (int t = 0; t < T_COUNT; t++)
+        glyph_terrain[t] = (chtype)terrain[t].ch | COLOR_PAIR(terrain[t].cp) | terrain[t].attr;
+    for (int c = 0; c <= MAX_CIV; c++) {
+        chtype civ = COLOR_PAIR(c > 0 ? CIV_CPAIRS[c - 1] : CP_MON) | A_BOLD;
+        glyph_ent[c][E_UNIT]    = (chtype)(c > 0 ? 'u' : 'M') | civ;
+        glyph_ent[c][E_VILLAGE] = 'V' | civ;
+        glyph_ent[c][E_CITY]    = 'C' | civ;
+        glyph_ent[c][E_MONSTER] = 'M' | COLOR_PAIR(CP_MON) | A_BOLD;
+    }
+}
+
+static chtype tile_cell(const Tile *t)
+{
+    return t->eid >= 0 ? glyph_ent[E.civ[t->eid] + 1][E.kind[t->eid]] : glyph_terrain[t->t];
+}
+
+/* Sum block (bx, by) at zoom z straight from its tiles into zeroed
+   terrain, civ and towns, as the pyramid would hold it. */
+static void block_sum(int z, int bx, int by, unsigned *terrain, unsigned *civ, unsigned *towns)
+{
+    int x0 = bx << z, y0 = by << z;
+    int x1 = x0 + (1 << z) < WW ? x0 + (1 << z) : WW;
+    int y1 = y0 + (1 << z) < WH ? y0 + (1 << z) : WH;
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            const Tile *t = &TILE(x, y);
+            terrain[t->t]++;
+            if (t->eid < 0) continue;
+            unsigned w = pyr_weight(t->eid);
+            civ[E.civ[t->eid] + 1] += w;
+            *towns += w > 1;
+        }
+    }
+}
+
+/* Block (bx, by) at zoom z: the side with the most presence in it, as a
+   town if it holds one and the side could own it, else the terrain most
+   of it is.  Zooms below PYR_MIN are summed from the tiles, no more than
+   a few per cell; coarser ones are read off the pyramid. */
+static chtype block_cell(int z, int bx, int by)
+{
+    unsigned terrain[T_COUNT] = { 0 }, civ[MAX_CIV + 1] = { 0 }, towns = 0;
+    if (z < PYR_MIN) {
+        block_sum(z, bx, by, terrain, civ, &towns);
+    } else {
+        const PyrBlock *b = &pyr[z][(size_t)by * pyr_w[z] + bx];
+        for (int t = 0; t < T_COUNT; t++) terrain[t] = b->terrain[t];
+        for (int c = 0; c <= NCIV; c++)
+            civ[c] = atomic_load_explicit(&b->civ[c], memory_order_relaxed);
+        towns = b->towns;
     }
+    int side = 0, t = 0;
+    for (int c = 1; c <= NCIV; c++)
+        if (civ[c] > civ[side]) side = c;
+    if (civ[side] > 0)
+        return glyph_ent[side][side > 0 && towns > 0 && civ[side] >= PYR_TOWN_WEIGHT
+                               ? E_VILLAGE : E_UNIT];
+    for (int k = 1; k < T_COUNT; k++)
+        if (terrain[k] > terrain[t]) t = k;
+    return glyph_terrain[t];
+}
+
+/* Blocks of the pyramid that differ from a fresh sum of their tiles. */
+static long pyr_verify(void)
+{
+    long bad = 0;
+    for (int z = PYR_MIN; z <= ZOOM_MAX; z++) {
+        for (int by = 0; by < pyr_h[z]; by++) {
+            for (int bx = 0; bx < pyr_w[z]; bx++) {
+                unsigned terrain[T_COUNT] = { 0 }, civ[MAX_CIV + 1] = { 0 }, towns = 0;
+                block_sum(z, bx, by, terrain, civ, &towns);
+                const PyrBlock *b = &pyr[z][(size_t)by * pyr_w[z] + bx];
+                int same = b->towns == towns;
+                for (int t = 0; t < T_COUNT; t++) same &= b->terrain[t] == terrain[t];
+                for (int c = 0; c <= MAX_CIV; c++)
+                    same &= atomic_load_explicit(&b->civ[c], memory_order_relaxed) == civ[c];
+                bad += !same;
+            }
+        }
+    }
+    return bad;
 }
 
 static const char *TERRAIN_NAMES[T_COUNT] = {
@@ -598,125 +1719,252 @@ static const char *POWER_NAMES[]  = {
     "Spawn Unit","Spawn Village","Lightning","Meteor Strike"
 };
 
+/* Shadow framebuffer: fb_frame is what this frame wants on screen and
+   fb_shown what ncurses was last given, one chtype (glyph, colour pair and
+   attributes) per cell.  render() composes the whole frame here and
+   fb_flush() hands ncurses only the cells that differ, so an unchanged
+   map or panel costs no curses calls at all. */
+static chtype *fb_frame, *fb_shown;
+static int     fb_rows = 0, fb_cols = 0;
+/* The map view fb_shown holds: its zoom, camera (in cells of that zoom)
+   and size, fb_view_w 0 if none */
+static int     fb_zoom, fb_cam_x, fb_cam_y, fb_view_w = 0, fb_view_h;
+
+/* Size both buffers to the terminal.  After a resize nothing counts as
+   shown, so the next flush repaints every cell. */
+static int fb_resize(int rows, int cols)
+{
+    if (rows == fb_rows && cols == fb_cols) return 1;
+    size_t  n     = (size_t)rows * (size_t)cols;
+    chtype *frame = realloc(fb_frame, n * sizeof(*frame));
+    if (frame) fb_frame = frame;
+    chtype *shown = frame ? realloc(fb_shown, n * sizeof(*shown)) : NULL;
+    if (!shown) return 0;
+    fb_shown = shown;
+    memset(fb_shown, 0, n * sizeof(*fb_shown));  /* 0 matches no composed cell */
+    fb_rows   = rows;
+    fb_cols   = cols;
+    fb_view_w = 0;
+    return 1;
+}
+
+/* The camera moved by (dx, dy) over an unchanged view: have the backend
+   move the map the screen already shows to where it now belongs, and
+   fb_shown with it, so the flush only draws what the pan uncovered (and,
+   since terminals scroll whole lines, the side panel beside scrolled
+   lines). */
+static void fb_pan(int dx, int dy, int view_w, int view_h)
+{
+    if (dy != 0 && abs(dy) < view_h && be->scroll_lines(0, view_h, dy)) {
+        size_t line = (size_t)fb_cols * sizeof(*fb_shown), m = (size_t)abs(dy);
+        char  *map  = (char *)fb_shown;
+        if (dy > 0) {
+            memmove(map, map + m * line, (view_h - m) * line);
+            memset(map + (view_h - m) * line, 0, m * line);
+        } else {
+            memmove(map + m * line, map, (view_h - m) * line);
+            memset(map, 0, m * line);
+        }
+    }
+    if (dx != 0 && abs(dx) < view_w && be->shift_cells(0, view_h, view_w, dx)) {
+        int m = abs(dx);
+        for (int y = 0; y < view_h; y++) {
+            chtype *row = &fb_shown[(size_t)y * fb_cols];
+            if (dx > 0) {
+                memmove(row, row + m, (size_t)(view_w - m) * sizeof(*row));
+                memset(row + view_w - m, 0, (size_t)m * sizeof(*row));
+            } else {
+                memmove(row + m, row, (size_t)(view_w - m) * sizeof(*row));
+                memset(row, 0, (size_t)m * sizeof(*row));
+            }
+        }
+    }
+}
+
+static void fb_fill(int y, int x, int n, chtype c)
+{
+    if (y < 0 || y >= fb_rows) return;
+    if (x < 0) { n += x; x = 0; }
+    if (n > fb_cols - x) n = fb_cols - x;
+    for (int i = 0; i < n; i++) fb_frame[(size_t)y * fb_cols + x + i] = c;
+}
+
+/* printf into the frame at (y, x), clipped to the screen edge. */
+static void fb_printf(int y, int x, chtype attr, const char *fmt, ...)
+{
+    char    buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > (int)sizeof(buf) - 1) n = (int)sizeof(buf) - 1;
+    if (y < 0 || y >= fb_rows) return;
+    for (int i = 0; i < n && x + i < fb_cols; i++)
+        if (x + i >= 0) fb_frame[(size_t)y * fb_cols + x + i] = (chtype)(unsigned char)buf[i] | attr;
+}
+
+/* Changed cells no more than FB_GAP apart go out as one run. */
+#define FB_GAP 4
+
+static void fb_flush(void)
+{
+    for (int y = 0; y < fb_rows; y++) {
+        chtype *frame = &fb_frame[(size_t)y * fb_cols];
+        chtype *shown = &fb_shown[(size_t)y * fb_cols];
+        int x = 0;
+        while (x < fb_cols) {
+            if (frame[x] == shown[x]) { x++; continue; }
+            int x0 = x, end = ++x;            /* [x0, end): run so far */
+            for (; x < fb_cols && x - end <= FB_GAP; x++)
+                if (frame[x] != shown[x]) end = x + 1;
+            if (be->put(y, x0, &frame[x0], end - x0))
+                memcpy(&shown[x0], &frame[x0], (size_t)(end - x0) * sizeof(*shown));
+            x = end;
+        }
+    }
+    be->present();
+}
+
 static void render(void)
 {
     int rows, cols;
-    getmaxyx(stdscr, rows, cols);
+    be->size(&rows, &cols);
+    if (!fb_resize(rows, cols)) return;
+    for (int y = 0; y < rows; y++) fb_fill(y, 0, cols, ' ');
 
     int panel_w = 26;
     view_w = cols - panel_w;
     view_h = rows - 2;  /* 2 status lines at bottom */
 
-    /* Clamp camera */
-    if (view_w > WW) { view_w = WW; cam_x = 0; }
-    if (view_h > WH) { view_h = WH; cam_y = 0; }
-    if (cam_x < 0) cam_x = 0;
-    if (cam_y < 0) cam_y = 0;
-    if (cam_x > WW - view_w) cam_x = WW - view_w;
-    if (cam_y > WH - view_h) cam_y = WH - view_h;
+    /* Clamp camera, in cells: 2^zoom tiles each way, the last ones cut
+       short at the world edge */
+    int zw = (WW + (1 << zoom) - 1) >> zoom, zh = (WH + (1 << zoom) - 1) >> zoom;
+    int cx = cam_x > 0 ? cam_x >> zoom : 0, cy = cam_y > 0 ? cam_y >> zoom : 0;
+    if (view_w > zw) { view_w = zw; cx = 0; }
+    if (view_h > zh) { view_h = zh; cy = 0; }
+    if (cx > zw - view_w) cx = zw - view_w;
+    if (cy > zh - view_h) cy = zh - view_h;
+    cam_x = cx << zoom;
+    cam_y = cy << zoom;
+
+    if (fb_zoom == zoom && fb_view_w == view_w && fb_view_h == view_h && view_w > 0 &&
+        view_h > 0)
+        fb_pan(cx - fb_cam_x, cy - fb_cam_y, view_w, view_h);
+    fb_zoom   = zoom;
+    fb_cam_x  = cx;
+    fb_cam_y  = cy;
+    fb_view_w = view_w;
+    fb_view_h = view_h;
 
     /* ── World view ── */
-    for (int sy = 0; sy < view_h; sy++) {
-        int wy = cam_y + sy;
-        if (wy < 0 || wy >= WH) continue;
-        for (int sx = 0; sx < view_w; sx++) {
-            int wx = cam_x + sx;
-            if (wx < 0 || wx >= WW) continue;
-            int ch, cp, at;
-            tile_glyph(wx, wy, &ch, &cp, &at);
-            if (wx == cur_x && wy == cur_y) {
-                attron(COLOR_PAIR(CP_CUR) | A_REVERSE | A_BOLD);
-                mvaddch(sy, sx, ch);
-                attroff(COLOR_PAIR(CP_CUR) | A_REVERSE | A_BOLD);
-            } else {
-                attron(COLOR_PAIR(cp) | at);
-                mvaddch(sy, sx, ch);
-                attroff(COLOR_PAIR(cp) | at);
-            }
+    for (int sy = 0; sy < view_h && view_w > 0; sy++) {
+        chtype *row = &fb_frame[(size_t)sy * cols];
+        if (zoom == 0) {
+            const Tile *src = &TILE(cx, cy + sy);
+            for (int sx = 0; sx < view_w; sx++) row[sx] = tile_cell(&src[sx]);
+        } else {
+            for (int sx = 0; sx < view_w; sx++) row[sx] = block_cell(zoom, cx + sx, cy + sy);
         }
     }
+    int ux = (cur_x >> zoom) - cx, uy = (cur_y >> zoom) - cy;
+    if (ux >= 0 && ux < view_w && uy >= 0 && uy < view_h) {
+        chtype *c = &fb_frame[(size_t)uy * cols + ux];
+        *c = (*c & A_CHARTEXT) | COLOR_PAIR(CP_CUR) | A_REVERSE | A_BOLD;
+    }
 
     /* ── Side panel ── */
-    int px = view_w;
-    attron(COLOR_PAIR(CP_UI));
+    int    px = view_w;
+    chtype ui = COLOR_PAIR(CP_UI);
     for (int y = 0; y < rows; y++)
-        mvhline(y, px, ' ', panel_w);
-
-    mvprintw(0, px+1, "===  GOD-CASA  ===");
-    mvprintw(1, px+1, "Tick:  %-7d", tick);
-    mvprintw(2, px+1, "State: %s", paused ? "PAUSED " : "Running");
-    mvprintw(3, px+1, "Cursor: (%3d,%3d)", cur_x, cur_y);
-    mvprintw(4, px+1, "Power: [%d] %s",
-             sel_power, POWER_NAMES[sel_power < 11 ? sel_power : 0]);
-    mvprintw(5, px+1, "Civ:   [Tab]");
+        fb_fill(y, px, panel_w, ' ' | ui);
+
+    fb_printf(0, px+1, ui, "===  GOD-CASA  ===");
+    fb_printf(1, px+1, ui, "Tick:  %-7d", tick);
+    fb_printf(2, px+1, ui, "State: %s x%-2d", paused ? "PAUSED " : "Running", sim_speed);
+    fb_printf(3, px+1, ui, "Cursor: (%3d,%3d)", cur_x, cur_y);
+    fb_printf(4, px+1, ui, "Power: [%d] %s",
+              sel_power, POWER_NAMES[sel_power < 11 ? sel_power : 0]);
+    fb_printf(5, px+1, ui, "Civ:   [Tab]");
+    fb_printf(6, px+1, ui, "Zoom:  1:%d", 1 << zoom);
+
+    /* Four rows per civ where they fit above the status bars, else two,
+       else one; if even one each does not fit, the civs around the
+       selected one. */
+    int room = rows - 2 - 8, per = 4;
+    if (NCIV * per > room) per = 2;
+    if (NCIV * per > room) per = 1;
+    int shown = NCIV <= room ? NCIV : room > 0 ? room : 0;
+    int first = sel_civ - shown / 2;
+    if (first > NCIV - shown) first = NCIV - shown;
+    if (first < 0) first = 0;
+
+    if (per == 1) fb_printf(7, px+1, ui, "-- CIVS --  Uni Vil Kill");
+    else          fb_printf(7, px+1, ui, "-- CIVILISATIONS --");
+    for (int k = 0; k < shown; k++) {
+        int i = first + k, y = 8 + k*per;
+        chtype name = COLOR_PAIR(C[i].cpair) | A_BOLD;
+        if (i == sel_civ) fb_printf(y, px, ui | A_BOLD, ">");
+        if (per == 1) {
+            fb_printf(y, px+1, name, "[%d] %s", i+1, C[i].name);
+            fb_printf(y, px+13, ui, "%3d %3d %4d", C[i].units, C[i].villages, C[i].kills);
+            continue;
+        }
+        fb_printf(y, px+1, name, "[%d] %s", i+1, C[i].name);
+        if (per == 2) {
+            fb_printf(y+1, px+2, ui, "Uni:%-3d Vil:%-3d K:%-4d",
+                      C[i].units, C[i].villages, C[i].kills);
+            continue;
+        }
+        fb_printf(y+1, px+2, ui, "Uni:%-3d Vil:%-3d", C[i].units, C[i].villages);
+        fb_printf(y+2, px+2, ui, "Kills: %-4d", C[i].kills);
+    }
 
-    mvprintw(7, px+1, "-- CIVILISATIONS --");
-    for (int i = 0; i < NCIV; i++) {
-        if (i == sel_civ) {
-            attron(COLOR_PAIR(CP_UI) | A_BOLD);
-            mvaddch(8 + i*4, px, '>');
-        } else {
-            attron(COLOR_PAIR(CP_UI));
-        }
-        attron(COLOR_PAIR(C[i].cpair) | A_BOLD);
-        mvprintw(8  + i*4, px+1, "[%d] %s", i+1, C[i].name);
-        attroff(COLOR_PAIR(C[i].cpair) | A_BOLD);
-        attron(COLOR_PAIR(CP_UI));
-        mvprintw(9  + i*4, px+2, "Uni:%-3d Vil:%-3d", C[i].units, C[i].villages);
-        mvprintw(10 + i*4, px+2, "Kills: %-4d", C[i].kills);
-        attroff(A_BOLD);
-    }
-
-    int py = 8 + NCIV*4 + 1;
-    mvprintw(py++, px+1, "-- GOD POWERS --");
-    mvprintw(py++, px+1, "1-6: Terrain");
-    mvprintw(py++, px+2, "1-Plains 2-Water");
-    mvprintw(py++, px+2, "3-Forest 4-Mount");
-    mvprintw(py++, px+2, "5-Lava   6-Sand");
-    mvprintw(py++, px+1, "7: Spawn Unit");
-    mvprintw(py++, px+1, "8: Spawn Village");
-    mvprintw(py++, px+1, "9: Lightning");
-    mvprintw(py++, px+1, "0: Meteor Strike");
+    int py = 8 + shown*per + 1;
+    fb_printf(py++, px+1, ui, "-- GOD POWERS --");
+    fb_printf(py++, px+1, ui, "1-6: Terrain");
+    fb_printf(py++, px+2, ui, "1-Plains 2-Water");
+    fb_printf(py++, px+2, ui, "3-Forest 4-Mount");
+    fb_printf(py++, px+2, ui, "5-Lava   6-Sand");
+    fb_printf(py++, px+1, ui, "7: Spawn Unit");
+    fb_printf(py++, px+1, ui, "8: Spawn Village");
+    fb_printf(py++, px+1, ui, "9: Lightning");
+    fb_printf(py++, px+1, ui, "0: Meteor Strike");
     py++;
-    mvprintw(py++, px+1, "Enter/F: Apply");
-    mvprintw(py++, px+1, "Arrows: Cursor");
-    mvprintw(py++, px+1, "WASD: Camera");
-    mvprintw(py++, px+1, "Tab: Civ  Spc:Pause");
-    mvprintw(py++, px+1, "Q: Quit");
-    attroff(COLOR_PAIR(CP_UI));
+    fb_printf(py++, px+1, ui, "Enter/F: Apply");
+    fb_printf(py++, px+1, ui, "Arrows: Cursor");
+    fb_printf(py++, px+1, ui, "WASD: Camera");
+    fb_printf(py++, px+1, ui, "Z/X: Zoom out/in");
+    fb_printf(py++, px+1, ui, "Tab: Civ  Spc:Pause");
+    fb_printf(py++, px+1, ui, "+/-: Sim speed");
+    fb_printf(py++, px+1, ui, "Q: Quit");
 
     /* ── Bottom status bar ── */
     int br = rows - 2;
-    attron(COLOR_PAIR(CP_UI) | A_BOLD);
-    mvhline(br, 0, ' ', cols);
-    mvprintw(br, 0, " [%d] %-14s | Civ: %-7s | Tick: %-6d | %s",
-             sel_power, POWER_NAMES[sel_power < 11 ? sel_power : 0],
-             C[sel_civ].name, tick, paused ? "PAUSED" : "Running");
-    attroff(COLOR_PAIR(CP_UI) | A_BOLD);
+    fb_fill(br, 0, cols, ' ' | ui | A_BOLD);
+    fb_printf(br, 0, ui | A_BOLD, " [%d] %-14s | Civ: %-7s | Tick: %-6d | %s x%d",
+              sel_power, POWER_NAMES[sel_power < 11 ? sel_power : 0],
+              C[sel_civ].name, tick, paused ? "PAUSED" : "Running", sim_speed);
 
     /* ── Entity / terrain info bar ── */
     br++;
-    attron(COLOR_PAIR(CP_UI));
-    mvhline(br, 0, ' ', cols);
+    fb_fill(br, 0, cols, ' ' | ui);
     if (cur_x >= 0 && cur_x < WW && cur_y >= 0 && cur_y < WH) {
-        int eid = W[cur_y][cur_x].eid;
+        int eid = TILE(cur_x, cur_y).eid;
         if (eid >= 0) {
-            Ent *e = &E[eid];
-            mvprintw(br, 0, " (%d,%d) %s %s  HP:%d/%d ATK:%d  %s",
-                     cur_x, cur_y,
-                     (e->civ >= 0 && e->civ < NCIV) ? C[e->civ].name : "Monster",
-                     ENTITY_KINDS[e->kind],
-                     e->hp, e->max_hp, e->atk,
-                     (e->kind == E_UNIT || e->kind == E_MONSTER)
-                         ? UNIT_STATES[e->state] : "");
+            fb_printf(br, 0, ui, " (%d,%d) %s %s  HP:%d/%d ATK:%d  %s",
+                      cur_x, cur_y,
+                      (E.civ[eid] >= 0 && E.civ[eid] < NCIV) ? C[E.civ[eid]].name : "Monster",
+                      ENTITY_KINDS[E.kind[eid]],
+                      E.hp[eid], EC.max_hp[eid], EC.atk[eid],
+                      (E.kind[eid] == E_UNIT || E.kind[eid] == E_MONSTER)
+                          ? UNIT_STATES[E.state[eid]] : "");
         } else {
-            mvprintw(br, 0, " (%d,%d) %s",
-                     cur_x, cur_y, TERRAIN_NAMES[W[cur_y][cur_x].t]);
+            fb_printf(br, 0, ui, " (%d,%d) %s",
+                      cur_x, cur_y, TERRAIN_NAMES[TILE(cur_x, cur_y).t]);
         }
     }
-    attroff(COLOR_PAIR(CP_UI));
 
-    refresh();
+    fb_flush();
 }
 
 /* ======================================================================
@@ -729,8 +1977,8 @@ static void meteor_strike(int wx, int wy)
             if (dx*dx + dy*dy > 9) continue;
             int nx = wx+dx, ny = wy+dy;
             if (nx < 0 || nx >= WW || ny < 0 || ny >= WH) continue;
-            if (W[ny][nx].eid >= 0) ent_kill(W[ny][nx].eid);
-            W[ny][nx].t = T_LAVA;
+            if (TILE(nx, ny).eid >= 0) ent_kill(TILE(nx, ny).eid);
+            tile_set_terrain(nx, ny, T_LAVA);
         }
     }
 }
@@ -739,41 +1987,41 @@ static void apply_power(int wx, int wy)
 {
     if (wx < 0 || wx >= WW || wy < 0 || wy >= WH) return;
     switch (sel_power) {
-        case 1: W[wy][wx].t = T_PLAIN;  break;
+        case 1: tile_set_terrain(wx, wy, T_PLAIN);  break;
         case 2:
-            if (W[wy][wx].eid >= 0) ent_kill(W[wy][wx].eid);
-            W[wy][wx].t = T_WATER;
+            if (TILE(wx, wy).eid >= 0) ent_kill(TILE(wx, wy).eid);
+            tile_set_terrain(wx, wy, T_WATER);
             break;
-        case 3: W[wy][wx].t = T_FOREST; break;
+        case 3: tile_set_terrain(wx, wy, T_FOREST); break;
         case 4:
-            if (W[wy][wx].eid >= 0) ent_kill(W[wy][wx].eid);
-            W[wy][wx].t = T_MOUNT;
+            if (TILE(wx, wy).eid >= 0) ent_kill(TILE(wx, wy).eid);
+            tile_set_terrain(wx, wy, T_MOUNT);
             break;
         case 5:
-            if (W[wy][wx].eid >= 0) ent_kill(W[wy][wx].eid);
-            W[wy][wx].t = T_LAVA;
+            if (TILE(wx, wy).eid >= 0) ent_kill(TILE(wx, wy).eid);
+            tile_set_terrain(wx, wy, T_LAVA);
             break;
-        case 6: W[wy][wx].t = T_SAND;   break;
+        case 6: tile_set_terrain(wx, wy, T_SAND);   break;
         case 7: { /* Spawn unit */
-            Terrain t = W[wy][wx].t;
-            if (t != T_DEEP && t != T_WATER && t != T_MOUNT && t != T_LAVA
-                && W[wy][wx].eid < 0)
+            Terrain t = TILE(wx, wy).t;
+            if (terrain_walkable(t) && TILE(wx, wy).eid < 0)
                 ent_place(E_UNIT, sel_civ, wx, wy);
             break;
         }
         case 8: { /* Spawn village */
-            Terrain t = W[wy][wx].t;
-            if ((t == T_PLAIN || t == T_FOREST || t == T_SAND) && W[wy][wx].eid < 0)
+            Terrain t = TILE(wx, wy).t;
+            if ((t == T_PLAIN || t == T_FOREST || t == T_SAND) && TILE(wx, wy).eid < 0)
                 ent_place(E_VILLAGE, sel_civ, wx, wy);
             break;
         }
         case 9: /* Lightning — destroy entity */
-            if (W[wy][wx].eid >= 0) ent_kill(W[wy][wx].eid);
+            if (TILE(wx, wy).eid >= 0) ent_kill(TILE(wx, wy).eid);
             break;
         case 10: /* Meteor strike */
             meteor_strike(wx, wy);
             break;
     }
+    ent_reap();
 }
 
 /* ======================================================================
@@ -783,15 +2031,26 @@ static void handle_input(int ch)
 {
     switch (ch) {
         /* Camera pan */
-        case 'w': case 'W': cam_y--; break;
-        case 's': case 'S': cam_y++; break;
-        case 'a': case 'A': cam_x--; break;
-        case 'd': case 'D': cam_x++; break;
+        case 'w': case 'W': cam_y -= 1 << zoom; break;
+        case 's': case 'S': cam_y += 1 << zoom; break;
+        case 'a': case 'A': cam_x -= 1 << zoom; break;
+        case 'd': case 'D': cam_x += 1 << zoom; break;
         /* Cursor */
-        case KEY_UP:    cur_y--; break;
-        case KEY_DOWN:  cur_y++; break;
-        case KEY_LEFT:  cur_x--; break;
-        case KEY_RIGHT: cur_x++; break;
+        case KEY_UP:    cur_y -= 1 << zoom; break;
+        case KEY_DOWN:  cur_y += 1 << zoom; break;
+        case KEY_LEFT:  cur_x -= 1 << zoom; break;
+        case KEY_RIGHT: cur_x += 1 << zoom; break;
+        /* Zoom out (until the whole world fits) or in, cursor mid-view */
+        case 'z': case 'Z': case 'x': case 'X':
+            if (ch == 'x' || ch == 'X') {
+                if (zoom > 0) zoom--;
+            } else if (zoom < ZOOM_MAX && (view_w < (WW + (1 << zoom) - 1) >> zoom ||
+                                           view_h < (WH + (1 << zoom) - 1) >> zoom)) {
+                zoom++;
+            }
+            cam_x = cur_x - (view_w << zoom) / 2;
+            cam_y = cur_y - (view_h << zoom) / 2;
+            break;
         /* Power selection */
         case '1': sel_power = 1;  break;
         case '2': sel_power = 2;  break;
@@ -810,8 +2069,14 @@ static void handle_input(int ch)
         case '@': sel_civ = 1; break; /* shift-2 */
         case '#': sel_civ = 2; break; /* shift-3 */
         case '$': sel_civ = 3; break; /* shift-4 */
-        /* Pause */
+        /* Pause / fast-forward */
         case ' ': paused = !paused; break;
+        case '+': case '=':
+            if (sim_speed < MAX_SPEED) sim_speed *= 2;
+            break;
+        case '-': case '_':
+            if (sim_speed > 1) sim_speed /= 2;
+            break;
         /* Quit */
         case 'q': case 'Q': quitting = 1; break;
         /* Apply power */
@@ -820,25 +2085,40 @@ static void handle_input(int ch)
             break;
     }
 
+    if (sel_civ >= NCIV) sel_civ = NCIV - 1;
+
     /* Clamp cursor to world bounds */
     if (cur_x < 0)    cur_x = 0;
     if (cur_y < 0)    cur_y = 0;
     if (cur_x >= WW)  cur_x = WW - 1;
     if (cur_y >= WH)  cur_y = WH - 1;
 
-    /* Auto-scroll camera to keep cursor visible */
-    if (cur_x < cam_x)              cam_x = cur_x;
-    if (cur_y < cam_y)              cam_y = cur_y;
-    if (cur_x >= cam_x + view_w)    cam_x = cur_x - view_w + 1;
-    if (cur_y >= cam_y + view_h)    cam_y = cur_y - view_h + 1;
+    /* Auto-scroll camera to keep cursor visible, a cell at a time */
+    if (cam_x < 0) cam_x = 0;
+    if (cam_y < 0) cam_y = 0;
+    int ux = cur_x >> zoom, uy = cur_y >> zoom;
+    if (ux < cam_x >> zoom)             cam_x = ux << zoom;
+    if (uy < cam_y >> zoom)             cam_y = uy << zoom;
+    if (ux >= (cam_x >> zoom) + view_w) cam_x = (ux - view_w + 1) << zoom;
+    if (uy >= (cam_y >> zoom) + view_h) cam_y = (uy - view_h + 1) << zoom;
 }
 
 /* ======================================================================
-   NCURSES SETUP
+   BACKENDS
    ====================================================================== */
-static void ncurses_init(void)
+/* Screen size from $LINES and $COLUMNS, else 80x24, for output that is
+   not a terminal. */
+static void env_size(int *rows, int *cols)
+{
+    const char *l = getenv("LINES"), *c = getenv("COLUMNS");
+    *rows = l && atoi(l) > 0 ? atoi(l) : 24;
+    *cols = c && atoi(c) > 0 ? atoi(c) : 80;
+}
+
+/* ── ncurses ── */
+static int nc_init(void)
 {
-    initscr();
+    if (!initscr()) return 0;
     cbreak();
     noecho();
     keypad(stdscr, TRUE);
@@ -846,21 +2126,511 @@ static void ncurses_init(void)
     curs_set(0);
     start_color();
     use_default_colors();
+    for (int p = 1; p < CP_COUNT; p++) init_pair(p, PAIR_COLORS[p][0], PAIR_COLORS[p][1]);
+    return 1;
+}
+
+static void nc_shutdown(void)                { endwin(); }
+static void nc_size(int *rows, int *cols)    { getmaxyx(stdscr, *rows, *cols); }
+static int  nc_key(void)                     { return getch(); }
+static void nc_present(void)                 { refresh(); }
+
+static int nc_put(int y, int x, const chtype *cells, int n)
+{
+    return mvaddchnstr(y, x, cells, n) != ERR;
+}
+
+static int nc_scroll(int top, int bot, int n)
+{
+    setscrreg(top, bot - 1);
+    scrollok(stdscr, TRUE);
+    scrl(n);
+    scrollok(stdscr, FALSE);
+    setscrreg(0, LINES - 1);
+    return 1;
+}
+
+/* ncurses sends a row changed by delch/insch as the cells it ends up
+   holding, not as character deletes and inserts, so shifting here would
+   save nothing on the wire. */
+static int nc_shift(int top, int bot, int width, int n)
+{
+    (void)top; (void)bot; (void)width; (void)n;
+    return 0;
+}
+
+/* ── Raw ANSI ──
+   Writes VT100 sequences itself: a frame's runs are gathered in one
+   buffer, each a cursor move then its cells with an SGR change wherever
+   colour or attributes do, and present() hands the lot to one write(2).
+   Runs in the terminal's alternate screen with stdin unbuffered and
+   unechoed; a screen size change repaints from a cleared screen. */
+#define ANSI_CELL_MAX 32        /* worst-case bytes per cell, cursor move included */
+#define ANSI_LINE_MAX 64        /* worst-case bytes per line to scroll or shift it */
+
+static struct termios ansi_saved;
+static int    ansi_tty  = 0;    /* stdin is a terminal we put in raw mode */
+static int    ansi_in   = 1;    /* stdin not yet at end of file */
+static char  *ansi_buf  = NULL;
+static size_t ansi_len  = 0, ansi_cap = 0;
+static int    ansi_rows = 0, ansi_cols = 0;
+static chtype ansi_attr;        /* attributes the terminal has set */
+#define ANSI_ATTR_UNKNOWN ((chtype)-1)
+
+static void ansi_write(const char *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(STDOUT_FILENO, p, n);
+        if (w < 0) return;
+        p += w;
+        n -= (size_t)w;
+        be_bytes += w;
+    }
+}
+
+static void ansi_restore(void)
+{
+    static const char bye[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+    if (write(STDOUT_FILENO, bye, sizeof(bye) - 1) < 0) { /* nothing to do */ }
+    if (ansi_tty) tcsetattr(STDIN_FILENO, TCSANOW, &ansi_saved);
+}
+
+static void ansi_signal(int sig)
+{
+    ansi_restore();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static int ansi_init(void)
+{
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &ansi_saved) == 0) {
+        struct termios raw = ansi_saved;
+        raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+        raw.c_cc[VMIN]  = 0;
+        raw.c_cc[VTIME] = 0;
+        ansi_tty = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+    signal(SIGINT,  ansi_signal);
+    signal(SIGTERM, ansi_signal);
+    static const char hello[] = "\x1b[?1049h\x1b[?25l";
+    ansi_write(hello, sizeof(hello) - 1);
+    return 1;
+}
+
+static void ansi_shutdown(void)
+{
+    ansi_restore();
+    free(ansi_buf);
+    ansi_buf = NULL;
+    ansi_cap = ansi_len = 0;
+    ansi_rows = ansi_cols = 0;
+}
+
+static void ansi_size(int *rows, int *cols)
+{
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        *rows = ws.ws_row;
+        *cols = ws.ws_col;
+    } else {
+        env_size(rows, cols);
+    }
+    if (*rows == ansi_rows && *cols == ansi_cols) return;
+    /* Room for a frame that changes every cell, so put() never grows it */
+    size_t cap = (size_t)*rows * ((size_t)*cols * ANSI_CELL_MAX + ANSI_LINE_MAX) + 64;
+    char  *buf = realloc(ansi_buf, cap);
+    if (!buf) { *rows = *cols = 0; return; }
+    ansi_buf  = buf;
+    ansi_cap  = cap;
+    ansi_rows = *rows;
+    ansi_cols = *cols;
+    ansi_len  = (size_t)sprintf(ansi_buf, "\x1b[0m\x1b[2J");
+    ansi_attr = 0;
+}
+
+static int ansi_key(void)
+{
+    static unsigned char q[64];
+    static int           qh = 0, qn = 0;
+    if (qh == qn && ansi_in) {
+        struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+        qh = qn = 0;
+        if (poll(&pfd, 1, 0) > 0) {
+            ssize_t r = read(STDIN_FILENO, q, sizeof(q));
+            if (r > 0) qn = (int)r;
+            else if (r == 0) ansi_in = 0;
+        }
+    }
+    if (qh == qn) return ERR;
+    int c = q[qh++];
+    if (c == 0x1b && qn - qh >= 2 && (q[qh] == '[' || q[qh] == 'O')) {
+        switch (q[qh + 1]) {
+            case 'A': qh += 2; return KEY_UP;
+            case 'B': qh += 2; return KEY_DOWN;
+            case 'C': qh += 2; return KEY_RIGHT;
+            case 'D': qh += 2; return KEY_LEFT;
+        }
+    }
+    return c;
+}
+
+static int ansi_put(int y, int x, const chtype *cells, int n)
+{
+    if (ansi_len + (size_t)n * ANSI_CELL_MAX > ansi_cap) return 0;
+    char *o = ansi_buf + ansi_len;
+    o += sprintf(o, "\x1b[%d;%dH", y + 1, x + 1);
+    for (int i = 0; i < n; i++) {
+        chtype a = cells[i] & A_ATTRIBUTES;
+        if (a != ansi_attr) {
+            int p = PAIR_NUMBER(a);
+            o += sprintf(o, "\x1b[0%s%s", (a & A_BOLD) ? ";1" : "", (a & A_REVERSE) ? ";7" : "");
+            if (p > 0 && p < CP_COUNT)
+                o += sprintf(o, ";%d;%d", 30 + PAIR_COLORS[p][0], 40 + PAIR_COLORS[p][1]);
+            *o++ = 'm';
+            ansi_attr = a;
+        }
+        *o++ = (char)(cells[i] & A_CHARTEXT);
+    }
+    ansi_len = (size_t)(o - ansi_buf);
+    return 1;
+}
+
+/* Uncovered cells take the current background, so reset it first. */
+static int ansi_scroll(int top, int bot, int n)
+{
+    if (ansi_len + ANSI_LINE_MAX > ansi_cap) return 0;
+    ansi_len += (size_t)sprintf(ansi_buf + ansi_len, "\x1b[0m\x1b[%d;%dr\x1b[%d%c\x1b[r",
+                                top + 1, bot, abs(n), n > 0 ? 'S' : 'T');
+    ansi_attr = 0;
+    return 1;
+}
+
+/* Deletes (DCH) before inserting (ICH), which keeps the cells from width
+   on in place. */
+static int ansi_shift(int top, int bot, int width, int n)
+{
+    if (ansi_len + (size_t)(bot - top) * ANSI_LINE_MAX + 8 > ansi_cap) return 0;
+    int   m = abs(n);
+    char *o = ansi_buf + ansi_len;
+    o += sprintf(o, "\x1b[0m");
+    for (int y = top; y < bot; y++)
+        o += sprintf(o, "\x1b[%d;%dH\x1b[%dP\x1b[%d;%dH\x1b[%d@", y + 1, n > 0 ? 1 : width - m + 1,
+                     m, y + 1, n > 0 ? width - m + 1 : 1, m);
+    ansi_len  = (size_t)(o - ansi_buf);
+    ansi_attr = 0;
+    return 1;
+}
+
+static void ansi_present(void)
+{
+    ansi_write(ansi_buf, ansi_len);
+    ansi_len = 0;
+}
 
-    init_pair(CP_DEEP,   COLOR_BLUE,    COLOR_BLACK);
-    init_pair(CP_WATER,  COLOR_CYAN,    COLOR_BLACK);
-    init_pair(CP_SAND,   COLOR_YELLOW,  COLOR_BLACK);
-    init_pair(CP_PLAIN,  COLOR_GREEN,   COLOR_BLACK);
-    init_pair(CP_FOREST, COLOR_GREEN,   COLOR_BLACK);
-    init_pair(CP_MOUNT,  COLOR_WHITE,   COLOR_BLACK);
-    init_pair(CP_LAVA,   COLOR_RED,     COLOR_BLACK);
-    init_pair(CP_CIV0,   COLOR_RED,     COLOR_BLACK);
-    init_pair(CP_CIV1,   COLOR_CYAN,    COLOR_BLACK);
-    init_pair(CP_CIV2,   COLOR_YELLOW,  COLOR_BLACK);
-    init_pair(CP_CIV3,   COLOR_MAGENTA, COLOR_BLACK);
-    init_pair(CP_MON,    COLOR_RED,     COLOR_BLACK);
-    init_pair(CP_CUR,    COLOR_WHITE,   COLOR_WHITE);
-    init_pair(CP_UI,     COLOR_WHITE,   COLOR_BLACK);
+/* ── Null ──
+   Composes and diffs frames as usual and shows nothing, to time the rest. */
+static int  null_init(void)                                     { return 1; }
+static void null_shutdown(void)                                 { }
+static int  null_key(void)                                      { return ERR; }
+static void null_present(void)                                  { }
+static int  null_scroll(int top, int bot, int n)                { (void)top; (void)bot; (void)n; return 1; }
+static int  null_put(int y, int x, const chtype *cells, int n)
+{
+    (void)y; (void)x; (void)cells; (void)n;
+    return 1;
+}
+static int  null_shift(int top, int bot, int width, int n)
+{
+    (void)top; (void)bot; (void)width; (void)n;
+    return 1;
+}
+
+static const Backend BACKENDS[] = {
+    { "ncurses", 0, nc_init,   nc_shutdown,   nc_size,   nc_key,   nc_put,   nc_present,
+                    nc_scroll,   nc_shift   },
+    { "ansi",    1, ansi_init, ansi_shutdown, ansi_size, ansi_key, ansi_put, ansi_present,
+                    ansi_scroll, ansi_shift },
+    { "null",    1, null_init, null_shutdown, env_size,  null_key, null_put, null_present,
+                    null_scroll, null_shift },
+};
+
+static const Backend *backend_find(const char *name)
+{
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++)
+        if (strcmp(BACKENDS[i].name, name) == 0) return &BACKENDS[i];
+    return NULL;
+}
+
+/* ── Screen check ──
+   Passes everything through to another backend and keeps its own copy of
+   the screen that backend holds, applying each run, scroll and shift it
+   accepted, for --verify to compare with the frame.  A size change starts
+   from a blank screen, as the frame is then repainted whole. */
+static Backend        chk_be;
+static const Backend *chk_real;
+static chtype        *chk_screen = NULL;
+static int            chk_rows = 0, chk_cols = 0;
+
+static void chk_shutdown(void)
+{
+    chk_real->shutdown();
+    free(chk_screen);
+    chk_screen = NULL;
+    chk_rows = chk_cols = 0;
+}
+
+static void chk_size(int *rows, int *cols)
+{
+    chk_real->size(rows, cols);
+    if (*rows == chk_rows && *cols == chk_cols) return;
+    size_t  n   = (size_t)*rows * (size_t)*cols;
+    chtype *scr = realloc(chk_screen, (n > 0 ? n : 1) * sizeof(*scr));
+    if (!scr) { *rows = *cols = 0; return; }
+    chk_screen = scr;
+    chk_rows   = *rows;
+    chk_cols   = *cols;
+    for (size_t i = 0; i < n; i++) chk_screen[i] = ' ';
+}
+
+static int chk_put(int y, int x, const chtype *cells, int n)
+{
+    if (!chk_real->put(y, x, cells, n)) return 0;
+    memcpy(&chk_screen[(size_t)y * chk_cols + x], cells, (size_t)n * sizeof(*cells));
+    return 1;
+}
+
+static int chk_scroll(int top, int bot, int n)
+{
+    if (!chk_real->scroll_lines(top, bot, n)) return 0;
+    int m = abs(n) < bot - top ? abs(n) : bot - top;
+    for (int k = 0; k < bot - top; k++) {
+        /* Walk away from the lines being uncovered */
+        int     y   = n > 0 ? top + k : bot - 1 - k, from = n > 0 ? y + m : y - m;
+        chtype *row = &chk_screen[(size_t)y * chk_cols];
+        if (k < bot - top - m)
+            memcpy(row, &chk_screen[(size_t)from * chk_cols], (size_t)chk_cols * sizeof(*row));
+        else
+            for (int x = 0; x < chk_cols; x++) row[x] = ' ';
+    }
+    return 1;
+}
+
+static int chk_shift(int top, int bot, int width, int n)
+{
+    if (!chk_real->shift_cells(top, bot, width, n)) return 0;
+    int m = abs(n) < width ? abs(n) : width;
+    for (int y = top; y < bot; y++) {
+        chtype *row = &chk_screen[(size_t)y * chk_cols];
+        if (n > 0) {
+            memmove(row, row + m, (size_t)(width - m) * sizeof(*row));
+            for (int x = width - m; x < width; x++) row[x] = ' ';
+        } else {
+            memmove(row + m, row, (size_t)(width - m) * sizeof(*row));
+            for (int x = 0; x < m; x++) row[x] = ' ';
+        }
+    }
+    return 1;
+}
+
+/* `real` with its screen tracked. */
+static const Backend *screen_check(const Backend *real)
+{
+    chk_real            = real;
+    chk_be              = *real;
+    chk_be.shutdown     = chk_shutdown;
+    chk_be.size         = chk_size;
+    chk_be.put          = chk_put;
+    chk_be.scroll_lines = chk_scroll;
+    chk_be.shift_cells  = chk_shift;
+    return &chk_be;
+}
+
+/* Cells where the tracked screen differs from the frame just flushed. */
+static long screen_verify(void)
+{
+    if (chk_rows != fb_rows || chk_cols != fb_cols) return (long)fb_rows * fb_cols;
+    long bad = 0;
+    for (size_t i = 0; i < (size_t)fb_rows * (size_t)fb_cols; i++)
+        bad += chk_screen[i] != fb_frame[i];
+    return bad;
+}
+
+/* ======================================================================
+   FIXED-TIMESTEP CLOCK
+   ====================================================================== */
+/* Monotonic wall clock in seconds. */
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Advance the simulation by the wall time elapsed since the previous call.
+   Sim time accrues at sim_speed × SIM_HZ ticks per second, independent of
+   how often we render.  At most SIM_BUDGET of a frame is spent stepping;
+   any backlog beyond that is dropped so one slow frame cannot snowball
+   into ever longer catch-up frames. */
+static void sim_advance(void)
+{
+    static double last = -1.0;
+    static double acc  = 0.0;   /* unsimulated time, in ticks */
+    double now = now_sec();
+    if (last < 0.0) last = now;
+    double elapsed = now - last;
+    last = now;
+    if (paused) { acc = 0.0; return; }
+
+    acc += elapsed * SIM_HZ * sim_speed;
+    double deadline = now + SIM_BUDGET / FRAME_HZ;
+    while (acc >= 1.0) {
+        sim_step();
+        acc -= 1.0;
+        if (now_sec() >= deadline) {
+            if (acc > 1.0) acc = 1.0; /* give up on the backlog */
+            break;
+        }
+    }
+}
+
+/* ======================================================================
+   HEADLESS BENCHMARK
+   ====================================================================== */
+static int cmp_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+/* FNV-1a over every entity slot and tile occupant, for checking that two
+   runs (e.g. with different thread counts) reached the same world. */
+static uint32_t state_hash(void)
+{
+    uint32_t h = 2166136261u;
+#define MIX(v) (h = (h ^ (uint32_t)(v)) * 16777619u)
+    for (int id = 0; id < MAX_E; id++) {
+        MIX(E.alive[id]);
+        if (!E.alive[id]) continue;
+        MIX(E.kind[id]); MIX(E.state[id]); MIX(E.civ[id]);
+        MIX(E.x[id]);    MIX(E.y[id]);     MIX(E.hp[id]);
+        MIX(E.target[id]); MIX(EC.age[id]);
+    }
+    for (int y = 0; y < WH; y++)
+        for (int x = 0; x < WW; x++)
+            MIX(TILE(x, y).eid);
+#undef MIX
+    return h;
+}
+
+/* Run `ticks` simulation steps without any rendering and report timings.
+   Returns a process exit status. */
+static int run_headless(long ticks)
+{
+    float *samples = malloc((size_t)ticks * sizeof(*samples)); /* µs per tick */
+    if (!samples) {
+        fprintf(stderr, "god-casa: cannot allocate %ld tick samples\n", ticks);
+        return 1;
+    }
+
+    double t0 = now_sec();
+    for (long i = 0; i < ticks; i++) {
+        double ts = now_sec();
+        sim_step();
+        samples[i] = (float)((now_sec() - ts) * 1e6);
+    }
+    double wall = now_sec() - t0;
+
+    double sum = 0.0;
+    for (long i = 0; i < ticks; i++) sum += samples[i];
+    qsort(samples, (size_t)ticks, sizeof(*samples), cmp_float);
+    long p99 = (long)((double)(ticks - 1) * 0.99);
+
+    int monsters = live_n[L_MONSTER];
+    int alive    = live_n[L_UNIT] + monsters + live_n[L_BUILDING];
+
+    printf("ticks:     %ld in %.3f s  (%.1f ticks/s)\n",
+           ticks, wall, (double)ticks / (wall > 0.0 ? wall : 1e-9));
+    printf("tick time: mean %.2f us  p99 %.2f us  max %.2f us\n",
+           sum / (double)ticks, (double)samples[p99], (double)samples[ticks - 1]);
+    printf("entities:  %d alive of %d slots  (%d monsters)\n",
+           alive, MAX_E, monsters);
+    for (int i = 0; i < NCIV; i++) {
+        printf("  %-8s  units:%-4d  villages:%-4d  kills:%-4d\n",
+               C[i].name, C[i].units, C[i].villages, C[i].kills);
+    }
+    printf("state:     %08x\n", state_hash());
+    free(samples);
+    return 0;
+}
+
+/* Render `frames` frames back to back through the chosen backend, one
+   tick before each unless paused, then report the render time per frame
+   and the bytes the backend wrote.  The report goes to stderr, so the
+   frames themselves can be sent to a file or /dev/null.  With `verify`
+   (and the backend wrapped by screen_check), the screen the backend was
+   left with is checked against the frame, and the overview pyramid
+   against the tiles, after every frame, outside the timing; any mismatch
+   fails the run. */
+static int run_frames(long frames, int verify)
+{
+    float *samples = malloc((size_t)frames * sizeof(*samples)); /* µs per frame */
+    if (!samples) {
+        be->shutdown();
+        fprintf(stderr, "god-casa: cannot allocate %ld frame samples\n", frames);
+        return 1;
+    }
+
+    long   n  = 0, pyr_bad = 0, pyr_frames = 0, scr_bad = 0, scr_frames = 0;
+    double t0 = now_sec();
+    while (n < frames && !quitting) {
+        int ch;
+        while ((ch = be->key()) != ERR) handle_input(ch);
+        if (!paused) sim_step();
+        double ts = now_sec();
+        render();
+        samples[n++] = (float)((now_sec() - ts) * 1e6);
+        if (verify) {
+            long bad = screen_verify();
+            scr_bad    += bad;
+            scr_frames += bad > 0;
+            bad         = pyr_verify();
+            pyr_bad    += bad;
+            pyr_frames += bad > 0;
+        }
+    }
+    double wall = now_sec() - t0;
+    int    rows = fb_rows, cols = fb_cols;
+    be->shutdown();
+
+    double sum = 0.0;
+    for (long i = 0; i < n; i++) sum += samples[i];
+    qsort(samples, (size_t)n, sizeof(*samples), cmp_float);
+    long p99 = (long)((double)(n - 1) * 0.99);
+
+    fprintf(stderr, "frames:      %ld of %dx%d through %s in %.3f s\n",
+            n, cols, rows, be->name, wall);
+    fprintf(stderr, "render time: mean %.2f us  p99 %.2f us  max %.2f us\n",
+            sum / (double)n, (double)samples[p99], (double)samples[n - 1]);
+    if (be->counted)
+        fprintf(stderr, "output:      %.0f bytes/frame\n", (double)be_bytes / (double)n);
+    if (verify) {
+        fprintf(stderr, "screen:      %ld wrong cells in %ld of %ld frames\n",
+                scr_bad, scr_frames, n);
+        fprintf(stderr, "pyramid:     %ld stale blocks in %ld of %ld frames\n",
+                pyr_bad, pyr_frames, n);
+    }
+    free(samples);
+    return scr_bad > 0 || pyr_bad > 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--config FILE] [--width N] [--height N] [--entities N]\n"
+            "          [--civs N] [--units N] [--villages N] [--threads N]\n"
+            "          [--headless [--ticks N] [--seed S]]\n"
+            "          [--backend ncurses|ansi|null] [--frames N [--verify]]\n", argv0);
 }
 
 /* ======================================================================
@@ -869,50 +2639,141 @@ static void ncurses_init(void)
 #ifdef __EMSCRIPTEN__
 static void em_main_loop(void)
 {
-    int ch = getch();
+    int ch = be->key();
     if (ch != ERR) handle_input(ch);
     if (quitting) {
         emscripten_cancel_main_loop();
-        endwin();
+        be->shutdown();
         return;
     }
-    if (!paused) sim_step();
+    sim_advance();
     render();
 }
 #endif
 
-int main(void)
+int main(int argc, char **argv)
 {
-    srand((unsigned)time(NULL));
+    int      headless = 0;
+    long     ticks    = 10000;
+    long     frames   = 0;
+    int      verify   = 0;
+    unsigned seed     = (unsigned)time(NULL);
+    be = &BACKENDS[0];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            if (!(be = backend_find(argv[++i]))) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtol(argv[++i], NULL, 10);
+            if (frames <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            if (!config_load(argv[++i])) return 2;
+        } else if (strncmp(argv[i], "--", 2) == 0 && i + 1 < argc
+                   && config_set(argv[i] + 2, argv[i + 1])) {
+            i++;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (ticks <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
 
-    memset(W, 0, sizeof(W));
-    memset(E, 0, sizeof(E));
-    memset(C, 0, sizeof(C));
+    srand(seed);
+    sim_seed = seed;
 
-    world_gen();
+    memset(C, 0, sizeof(C));
+    if (!world_alloc() || !world_gen()) return 1;
+    ent_pool_init();
     civs_init();
+    if (jobs_init(cfg.threads) < cfg.threads)
+        fprintf(stderr, "god-casa: only %d of %d threads started\n",
+                jobs_threads(), cfg.threads);
+    strips_init();
+    /* One scratch per thread: solve_chunk relies on never running short,
+       since a search skipped for want of one would depend on timing */
+    ppool = path_pool_create(jobs_threads());
+    if (!ppool) {
+        fprintf(stderr, "god-casa: cannot allocate path search scratch\n");
+        return 1;
+    }
+
+    if (headless) {
+        printf("god-casa headless: %dx%d world, %d entity slots, %d threads, seed %u\n",
+               WW, WH, MAX_E, jobs_threads(), seed);
+        int status = run_headless(ticks);
+        jobs_shutdown();
+        return status;
+    }
 
-    ncurses_init();
+    if (frames > 0 && verify) be = screen_check(be);
+    if (!be->init()) {
+        fprintf(stderr, "god-casa: cannot set up the %s screen\n", be->name);
+        jobs_shutdown();
+        return 1;
+    }
+    glyphs_init();
 
     cam_x = WW/2 - 30;
     cam_y = WH/2 - 15;
     cur_x = WW/2;
     cur_y = WH/2;
 
+    if (frames > 0) {
+        int status = run_frames(frames, verify);
+        jobs_shutdown();
+        return status;
+    }
+
 #ifdef __EMSCRIPTEN__
-    emscripten_set_main_loop(em_main_loop, 20, 1); /* 20 fps */
+    emscripten_set_main_loop(em_main_loop, FRAME_HZ, 1);
 #else
-    struct timespec frame_time = { 0, 50000000L }; /* 50 ms → ~20 fps */
+    const long frame_ns = 1000000000L / FRAME_HZ;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
 
     while (!quitting) {
-        int ch = getch();
-        if (ch != ERR) handle_input(ch);
-        if (!paused) sim_step();
+        int ch;
+        while ((ch = be->key()) != ERR) handle_input(ch);
+        sim_advance();
         render();
-        nanosleep(&frame_time, NULL);
+
+        /* Sleep to an absolute deadline so render cost does not add drift;
+           if we have fallen a whole frame behind, re-anchor to now. */
+        deadline.tv_nsec += frame_ns;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > deadline.tv_sec ||
+            (now.tv_sec == deadline.tv_sec && now.tv_nsec > deadline.tv_nsec))
+            deadline = now;
+        else
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
     }
 
-    endwin();
+    be->shutdown();
+    free(fb_frame);
+    free(fb_shown);
+    jobs_shutdown();
     printf("Thanks for playing god-casa!\n\n");
     printf("Final standings:\n");
     for (int i = 0; i < NCIV; i++) {
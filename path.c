@@ -0,0 +1,1276 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * path.c — Grid A* over a passability map
+ *
+ * Window cells are numbered row-major from the window's corner.  A scratch
+ * keeps one entry per cell and stamps it with the id of the search that
+ * last touched it, so a new search starts by bumping the id instead of
+ * clearing the arrays.  The heap holds cell numbers ordered by f, then
+ * by smaller h (the deeper of two equal-f nodes first), then by straight-
+ * line distance to the goal, then by cell, so the result depends only on
+ * the map and the query.  With 8-way unit steps whole wedges of tiles tie
+ * on f and h; the straight-line key keeps the search to the ones on the
+ * direct line instead of sweeping each wedge.
+ */
+
+#include "path.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WIN_CELLS  (PATH_WIN * PATH_WIN)
+#define WIN_MARGIN (PATH_WIN / 8)   /* room kept behind the start, if the map allows */
+#define CLOSED     (-1)
+#define NO_DIR     0xFF
+
+_Static_assert(WIN_CELLS <= 65536, "window cells must fit in uint16_t");
+
+/* Opposite directions pair up, so d ^ 1 undoes step d. */
+const int8_t path_dx[8] = { 1, -1, 0,  0, 1, -1,  1, -1 };
+const int8_t path_dy[8] = { 0,  0, 1, -1, 1, -1, -1,  1 };
+
+struct PathScratch {
+    uint32_t search;                 /* id of the current search          */
+    int      hn;                     /* heap size                         */
+    uint32_t stamp[WIN_CELLS];       /* search that last reached the cell */
+    uint32_t f[WIN_CELLS];           /* g + h                             */
+    uint32_t line[WIN_CELLS];        /* squared distance to the goal      */
+    uint16_t g[WIN_CELLS];           /* steps from the start              */
+    uint8_t  from[WIN_CELLS];        /* direction that reached the cell   */
+    int32_t  hpos[WIN_CELLS];        /* heap slot, or CLOSED              */
+    uint16_t heap[WIN_CELLS];
+    /* hpa_find's search over graph nodes, sized to the graph on demand */
+    int       ncap;                  /* nodes the arrays hold             */
+    uint32_t  nsearch;
+    int       nhn;
+    uint32_t *nstamp;
+    uint32_t *nf;
+    uint32_t *ng;
+    int32_t  *nfrom;                 /* node that reached it              */
+    int32_t  *nhpos;
+    int32_t  *nheap;                 /* afterwards, the path's nodes      */
+};
+
+struct PathPool {
+    int           count;
+    atomic_int   *busy;
+    PathScratch **slots;
+};
+
+/* ======================================================================
+   MAP
+   ====================================================================== */
+int path_map_init(PathMap *pm, int w, int h)
+{
+    pm->w     = w;
+    pm->h     = h;
+    pm->epoch = 0;
+    pm->pass  = calloc((size_t)w * (size_t)h, 1);
+    return pm->pass ? 0 : -1;
+}
+
+void path_map_free(PathMap *pm)
+{
+    free(pm->pass);
+    pm->pass = NULL;
+}
+
+int path_map_set(PathMap *pm, int x, int y, int walkable)
+{
+    if (x < 0 || x >= pm->w || y < 0 || y >= pm->h) return 0;
+    uint8_t *t = &pm->pass[(long)y * pm->w + x];
+    if (*t == (walkable != 0)) return 0;
+    *t = walkable != 0;
+    pm->epoch++;
+    return 1;
+}
+
+/* ======================================================================
+   POOL
+   ====================================================================== */
+PathPool *path_pool_create(int count)
+{
+    PathPool *pp = calloc(1, sizeof(*pp));
+    if (!pp) return NULL;
+    pp->count = count > 0 ? count : 1;
+    pp->busy  = calloc((size_t)pp->count, sizeof(*pp->busy));
+    pp->slots = calloc((size_t)pp->count, sizeof(*pp->slots));
+    int ok = pp->busy && pp->slots;
+    for (int i = 0; ok && i < pp->count; i++) {
+        atomic_init(&pp->busy[i], 0);
+        ok = (pp->slots[i] = calloc(1, sizeof(PathScratch))) != NULL;
+    }
+    if (!ok) {
+        path_pool_destroy(pp);
+        return NULL;
+    }
+    return pp;
+}
+
+void path_pool_destroy(PathPool *pp)
+{
+    if (!pp) return;
+    for (int i = 0; pp->slots && i < pp->count; i++) {
+        PathScratch *ps = pp->slots[i];
+        if (!ps) continue;
+        free(ps->nstamp);
+        free(ps->nf);
+        free(ps->ng);
+        free(ps->nfrom);
+        free(ps->nhpos);
+        free(ps->nheap);
+        free(ps);
+    }
+    free(pp->slots);
+    free(pp->busy);
+    free(pp);
+}
+
+PathScratch *path_pool_acquire(PathPool *pp)
+{
+    for (int i = 0; i < pp->count; i++) {
+        int idle = 0;
+        if (atomic_compare_exchange_strong(&pp->busy[i], &idle, 1)) return pp->slots[i];
+    }
+    return NULL;
+}
+
+void path_pool_release(PathPool *pp, PathScratch *ps)
+{
+    for (int i = 0; i < pp->count; i++)
+        if (pp->slots[i] == ps) {
+            atomic_store(&pp->busy[i], 0);
+            return;
+        }
+}
+
+/* ======================================================================
+   OPEN LIST
+   ====================================================================== */
+static int heap_before(const PathScratch *ps, int a, int b)
+{
+    if (ps->f[a] != ps->f[b]) return ps->f[a] < ps->f[b];
+    if (ps->g[a] != ps->g[b]) return ps->g[a] > ps->g[b];
+    if (ps->line[a] != ps->line[b]) return ps->line[a] < ps->line[b];
+    return a < b;
+}
+
+static void heap_up(PathScratch *ps, int i)
+{
+    int c = ps->heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_before(ps, c, ps->heap[parent])) break;
+        ps->heap[i] = ps->heap[parent];
+        ps->hpos[ps->heap[i]] = i;
+        i = parent;
+    }
+    ps->heap[i] = (uint16_t)c;
+    ps->hpos[c] = i;
+}
+
+static int heap_pop(PathScratch *ps)
+{
+    int top  = ps->heap[0];
+    int last = ps->heap[--ps->hn];
+    int i    = 0;
+    for (;;) {
+        int kid = 2 * i + 1;
+        if (kid >= ps->hn) break;
+        if (kid + 1 < ps->hn && heap_before(ps, ps->heap[kid + 1], ps->heap[kid])) kid++;
+        if (!heap_before(ps, ps->heap[kid], last)) break;
+        ps->heap[i] = ps->heap[kid];
+        ps->hpos[ps->heap[i]] = i;
+        i = kid;
+    }
+    if (ps->hn > 0) {
+        ps->heap[i]    = (uint16_t)last;
+        ps->hpos[last] = i;
+    }
+    ps->hpos[top] = CLOSED;
+    return top;
+}
+
+/* ======================================================================
+   SEARCH
+   ====================================================================== */
+/* First window coordinate along one axis of `dim` tiles. */
+static int win_lo(int s, int g, int dim)
+{
+    if (dim <= PATH_WIN) return 0;
+    int lo = s + (g - s) / 2 - PATH_WIN / 2;
+    if (lo > s - WIN_MARGIN) lo = s - WIN_MARGIN;
+    if (lo < s - PATH_WIN + 1 + WIN_MARGIN) lo = s - PATH_WIN + 1 + WIN_MARGIN;
+    if (lo < 0) lo = 0;
+    if (lo > dim - PATH_WIN) lo = dim - PATH_WIN;
+    return lo;
+}
+
+static uint32_t heuristic(int x, int y, int gx, int gy, int near)
+{
+    int dx = abs(x - gx), dy = abs(y - gy);
+    int d  = (dx > dy ? dx : dy) - near;
+    return d > 0 ? (uint32_t)d : 0u;
+}
+
+static uint32_t line_dist2(int x, int y, int gx, int gy)
+{
+    int64_t dx = x - gx, dy = y - gy;
+    int64_t d2 = dx * dx + dy * dy;
+    return d2 < UINT32_MAX ? (uint32_t)d2 : UINT32_MAX;
+}
+
+PathStatus path_find(const PathMap *pm, PathScratch *ps, int sx, int sy, int gx, int gy,
+                     int near, uint8_t *dirs, int max_dirs, int *ndirs)
+{
+    *ndirs = 0;
+    if (sx < 0 || sx >= pm->w || sy < 0 || sy >= pm->h) return PATH_NONE;
+    int ox = win_lo(sx, gx, pm->w), ww = pm->w < PATH_WIN ? pm->w : PATH_WIN;
+    int oy = win_lo(sy, gy, pm->h), wh = pm->h < PATH_WIN ? pm->h : PATH_WIN;
+
+    if (++ps->search == 0) {
+        memset(ps->stamp, 0, sizeof(ps->stamp));
+        ps->search = 1;
+    }
+    int start = (sy - oy) * ww + (sx - ox);
+    ps->stamp[start] = ps->search;
+    ps->g[start]     = 0;
+    ps->f[start]     = heuristic(sx, sy, gx, gy, near);
+    ps->line[start]  = line_dist2(sx, sy, gx, gy);
+    ps->from[start]  = NO_DIR;
+    ps->heap[0]      = (uint16_t)start;
+    ps->hpos[start]  = 0;
+    ps->hn           = 1;
+
+    int best = start, reached = -1, clipped = 0;
+    while (ps->hn > 0) {
+        int      c = heap_pop(ps);
+        uint32_t h = ps->f[c] - ps->g[c];
+        if (h == 0) {
+            reached = c;
+            break;
+        }
+        if (h < ps->f[best] - ps->g[best]) best = c;
+        int cx = ox + c % ww, cy = oy + c / ww;
+        for (int d = 0; d < 8; d++) {
+            int nx = cx + path_dx[d], ny = cy + path_dy[d];
+            if (!path_walkable(pm, nx, ny)) continue;
+            if (nx < ox || nx >= ox + ww || ny < oy || ny >= oy + wh) {
+                clipped = 1;
+                continue;
+            }
+            int      n  = (ny - oy) * ww + (nx - ox);
+            uint16_t ng = (uint16_t)(ps->g[c] + 1);
+            if (ps->stamp[n] == ps->search) {
+                if (ps->hpos[n] == CLOSED || ng >= ps->g[n]) continue;
+                ps->f[n] -= (uint32_t)(ps->g[n] - ng);
+                ps->g[n]  = ng;
+                ps->from[n] = (uint8_t)d;
+                heap_up(ps, ps->hpos[n]);
+            } else {
+                ps->stamp[n] = ps->search;
+                ps->g[n]     = ng;
+                ps->f[n]     = ng + heuristic(nx, ny, gx, gy, near);
+                ps->line[n]  = line_dist2(nx, ny, gx, gy);
+                ps->from[n]  = (uint8_t)d;
+                ps->heap[ps->hn] = (uint16_t)n;
+                heap_up(ps, ps->hn++);
+            }
+        }
+    }
+
+    PathStatus status = reached >= 0 ? PATH_FOUND : clipped ? PATH_PARTIAL : PATH_NONE;
+    if (status == PATH_NONE) return status;
+    int end = reached >= 0 ? reached : best;
+
+    /* Walk back once for the length, then again to write the first steps */
+    int len = ps->g[end], keep = len < max_dirs ? len : max_dirs;
+    int c   = end;
+    for (int k = len; k > 0; k--) {
+        int d = ps->from[c];
+        if (k <= keep) dirs[k - 1] = (uint8_t)d;
+        int x = ox + c % ww - path_dx[d], y = oy + c / ww - path_dy[d];
+        c = (y - oy) * ww + (x - ox);
+    }
+    *ndirs = keep;
+    return status;
+}
+
+/* ======================================================================
+   FLOW FIELDS
+   ======================================================================
+   An update collects seeds (tiles whose distance it has just set), sorts
+   them by distance and runs a breadth-first pass that merges the sorted
+   seeds with its own FIFO queue, so tiles are settled in order of
+   distance as in Dijkstra.  A tile's distance only ever goes down during
+   the pass; stamp marks tiles already settled in this update. */
+int flow_init(FlowSet *fs, int w, int h, int nfields)
+{
+    size_t tiles = (size_t)w * (size_t)h;
+    memset(fs, 0, sizeof(*fs));
+    fs->w       = w;
+    fs->h       = h;
+    fs->nfields = nfields;
+    fs->dist    = malloc(tiles * (size_t)nfields * sizeof(*fs->dist));
+    fs->dir     = malloc(tiles * (size_t)nfields);
+    fs->nsrc    = calloc((size_t)nfields, sizeof(*fs->nsrc));
+    fs->queue   = malloc(tiles * sizeof(*fs->queue));
+    fs->seeds   = malloc((tiles + 1) * sizeof(*fs->seeds));
+    fs->stamp   = calloc(tiles, sizeof(*fs->stamp));
+    if (!fs->dist || !fs->dir || !fs->nsrc || !fs->queue || !fs->seeds || !fs->stamp) {
+        flow_free(fs);
+        return -1;
+    }
+    memset(fs->dist, 0xFF, tiles * (size_t)nfields * sizeof(*fs->dist));
+    memset(fs->dir, FLOW_NO_DIR, tiles * (size_t)nfields);
+    return 0;
+}
+
+void flow_free(FlowSet *fs)
+{
+    free(fs->dist);
+    free(fs->dir);
+    free(fs->nsrc);
+    free(fs->queue);
+    free(fs->seeds);
+    free(fs->stamp);
+    memset(fs, 0, sizeof(*fs));
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Settle field f outward from seeds[0..nseeds), whose distances are set. */
+static void flow_spread(FlowSet *fs, const PathMap *pm, int f, int nseeds)
+{
+    uint16_t *dist = fs->dist + (size_t)f * fs->w * fs->h;
+    uint8_t  *dir  = fs->dir  + (size_t)f * fs->w * fs->h;
+    if (++fs->update == 0) {
+        memset(fs->stamp, 0, (size_t)fs->w * fs->h * sizeof(*fs->stamp));
+        fs->update = 1;
+    }
+    qsort(fs->seeds, (size_t)nseeds, sizeof(*fs->seeds), cmp_u64);
+
+    int s = 0, head = 0, tail = 0;
+    while (s < nseeds || head < tail) {
+        int t;
+        if (head < tail && (s == nseeds || dist[fs->queue[head]] <= fs->seeds[s] >> 32))
+            t = fs->queue[head++];
+        else
+            t = (int)(uint32_t)fs->seeds[s++];
+        if (fs->stamp[t] == fs->update) continue;
+        fs->stamp[t] = fs->update;
+        if (dist[t] >= FLOW_FAR - 1) continue;
+        int x = t % fs->w, y = t / fs->w;
+        uint16_t nd = (uint16_t)(dist[t] + 1);
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (!path_walkable(pm, nx, ny)) continue;
+            int n = ny * fs->w + nx;
+            if (nd >= dist[n]) continue;
+            dist[n] = nd;
+            dir[n]  = (uint8_t)(d ^ 1);       /* the step back toward t */
+            fs->queue[tail++] = n;
+        }
+    }
+}
+
+/* Give tile t of field f one more than its nearest neighbour, if that is
+   closer than it has.  Returns 1 if t ends up with a distance. */
+static int flow_seed(FlowSet *fs, int f, int t)
+{
+    uint16_t *dist = fs->dist + (size_t)f * fs->w * fs->h;
+    uint8_t  *dir  = fs->dir  + (size_t)f * fs->w * fs->h;
+    int x = t % fs->w, y = t / fs->w;
+    for (int d = 0; d < 8; d++) {
+        int nx = x + path_dx[d], ny = y + path_dy[d];
+        if (nx < 0 || nx >= fs->w || ny < 0 || ny >= fs->h) continue;
+        int v = ny * fs->w + nx;
+        if (dist[v] >= FLOW_FAR - 1 || dist[v] + 1 >= dist[t]) continue;
+        dist[t] = (uint16_t)(dist[v] + 1);
+        dir[t]  = (uint8_t)d;
+    }
+    return dist[t] != FLOW_FAR;
+}
+
+/* Clear every tile of field f whose step chain leads through `root`, root
+   included, then seed each cleared walkable tile from its uncleared
+   neighbours and spread. */
+static void flow_regrow(FlowSet *fs, const PathMap *pm, int f, int root)
+{
+    uint16_t *dist = fs->dist + (size_t)f * fs->w * fs->h;
+    uint8_t  *dir  = fs->dir  + (size_t)f * fs->w * fs->h;
+    int n = 0;
+    fs->queue[n++] = root;
+    dist[root] = FLOW_FAR;
+    dir[root]  = FLOW_NO_DIR;
+    for (int k = 0; k < n; k++) {
+        int x = fs->queue[k] % fs->w, y = fs->queue[k] / fs->w;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (nx < 0 || nx >= fs->w || ny < 0 || ny >= fs->h) continue;
+            int v = ny * fs->w + nx;
+            if (dist[v] == FLOW_FAR || dist[v] == 0 || dir[v] != (d ^ 1)) continue;
+            dist[v] = FLOW_FAR;
+            dir[v]  = FLOW_NO_DIR;
+            fs->queue[n++] = v;
+        }
+    }
+
+    int nseeds = 0;
+    for (int k = 0; k < n; k++) {
+        int t = fs->queue[k];
+        if (path_walkable(pm, t % fs->w, t / fs->w) && flow_seed(fs, f, t))
+            fs->seeds[nseeds++] = (uint64_t)dist[t] << 32 | (uint32_t)t;
+    }
+    flow_spread(fs, pm, f, nseeds);
+}
+
+void flow_add_source(FlowSet *fs, const PathMap *pm, int f, int x, int y)
+{
+    if (x < 0 || x >= fs->w || y < 0 || y >= fs->h) return;
+    int t = y * fs->w + x;
+    size_t at = (size_t)f * fs->w * fs->h + (size_t)t;
+    if (fs->dist[at] == 0) return;
+    fs->nsrc[f]++;
+    fs->dist[at] = 0;
+    fs->dir[at]  = FLOW_NO_DIR;
+    fs->seeds[0] = (uint32_t)t;
+    flow_spread(fs, pm, f, 1);
+}
+
+void flow_remove_source(FlowSet *fs, const PathMap *pm, int f, int x, int y)
+{
+    if (x < 0 || x >= fs->w || y < 0 || y >= fs->h) return;
+    int t = y * fs->w + x;
+    if (fs->dist[(size_t)f * fs->w * fs->h + (size_t)t] != 0) return;
+    fs->nsrc[f]--;
+    flow_regrow(fs, pm, f, t);
+}
+
+void flow_tile_changed(FlowSet *fs, const PathMap *pm, int x, int y)
+{
+    if (x < 0 || x >= fs->w || y < 0 || y >= fs->h) return;
+    int t = y * fs->w + x, walk = path_walkable(pm, x, y);
+    for (int f = 0; f < fs->nfields; f++) {
+        int d = fs->dist[(size_t)f * fs->w * fs->h + (size_t)t];
+        if (d == 0) continue;                   /* a source spreads either way */
+        if (!walk) {
+            if (d != FLOW_FAR) flow_regrow(fs, pm, f, t);
+        } else if (flow_seed(fs, f, t)) {
+            fs->seeds[0] = (uint64_t)fs->dist[(size_t)f * fs->w * fs->h + (size_t)t] << 32 |
+                           (uint32_t)t;
+            flow_spread(fs, pm, f, 1);
+        }
+    }
+}
+
+/* ======================================================================
+   HIERARCHY (HPA*)
+   ======================================================================
+   Node ids run cluster by cluster: cluster k's nodes are base[k] onward,
+   in the order of their tiles.  The graph itself keeps no edges between
+   clusters; a node steps across to whichever node of another cluster
+   stands on a tile next to it.  The two virtual nodes after the last
+   real one are the goal and the start of the search in progress. */
+#define HPA_CELLS       (HPA_CLUSTER * HPA_CLUSTER)
+#define HPA_FRAME       (HPA_CLUSTER + 2)         /* a cluster and a ring around it */
+#define HPA_FRAME_CELLS (HPA_FRAME * HPA_FRAME)
+#define HPA_DIRECT      (PATH_WIN - 2 * WIN_MARGIN) /* goals this close sit inside
+                                                       path_find's window     */
+
+static void cluster_box(const HpaGraph *hg, int k, int *x0, int *y0, int *x1, int *y1)
+{
+    *x0 = k % hg->cw * HPA_CLUSTER;
+    *y0 = k / hg->cw * HPA_CLUSTER;
+    *x1 = *x0 + HPA_CLUSTER < hg->w ? *x0 + HPA_CLUSTER : hg->w;
+    *y1 = *y0 + HPA_CLUSTER < hg->h ? *y0 + HPA_CLUSTER : hg->h;
+}
+
+static int cluster_of(const HpaGraph *hg, int x, int y)
+{
+    return y / HPA_CLUSTER * hg->cw + x / HPA_CLUSTER;
+}
+
+/* Index of map tile t among cluster c's nodes, or -1. */
+static int cluster_node(const HpaCluster *c, int32_t t)
+{
+    int lo = 0, hi = c->n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (c->tile[mid] < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < c->n && c->tile[lo] == t ? lo : -1;
+}
+
+/* Cell of map tile t in cluster k's frame: the cluster plus a ring of
+   blocked cells around it, so a flood needs no bounds tests. */
+static int frame_cell(const HpaGraph *hg, int k, int32_t t)
+{
+    int x0, y0, x1, y1;
+    cluster_box(hg, k, &x0, &y0, &x1, &y1);
+    return (t / hg->w - y0 + 1) * HPA_FRAME + t % hg->w - x0 + 1;
+}
+
+/* Cluster k's walkable tiles, in its frame. */
+static void cluster_open(const HpaGraph *hg, const PathMap *pm, int k, uint8_t *open)
+{
+    int x0, y0, x1, y1;
+    cluster_box(hg, k, &x0, &y0, &x1, &y1);
+    memset(open, 0, HPA_FRAME_CELLS);
+    for (int y = y0; y < y1; y++)
+        memcpy(&open[(y - y0 + 1) * HPA_FRAME + 1], &pm->pass[(long)y * pm->w + x0],
+               (size_t)(x1 - x0));
+}
+
+/* Steps from the seed cells to every cell of a frame, moving only on open
+   cells.  The seeds themselves need not be open. */
+static void cluster_bfs(const uint8_t *open, const int *seed, int nseed, uint16_t *dist)
+{
+    int16_t queue[HPA_FRAME_CELLS];
+    int     step[8];
+    for (int d = 0; d < 8; d++) step[d] = path_dy[d] * HPA_FRAME + path_dx[d];
+    for (int i = 0; i < HPA_FRAME_CELLS; i++) dist[i] = FLOW_FAR;
+    int head = 0, tail = 0;
+    for (int i = 0; i < nseed; i++) {
+        if (dist[seed[i]] == 0) continue;
+        dist[seed[i]] = 0;
+        queue[tail++] = (int16_t)seed[i];
+    }
+    while (head < tail) {
+        int      c  = queue[head++];
+        uint16_t nd = (uint16_t)(dist[c] + 1);
+        for (int d = 0; d < 8; d++) {
+            int n = c + step[d];
+            if (!open[n] || dist[n] != FLOW_FAR) continue;
+            dist[n] = nd;
+            queue[tail++] = (int16_t)n;
+        }
+    }
+}
+
+/* Append to out[] the entrance tiles on our side of a border `len` tiles
+   long, where our p-th tile is (ax + p*sx, ay + p*sy) and the one across
+   from it (bx + p*sx, by + p*sy).  Returns the new count. */
+static int border_nodes(const HpaGraph *hg, const PathMap *pm, int ax, int ay, int bx, int by,
+                        int sx, int sy, int len, int32_t *out, int n)
+{
+#define OURS(p)   path_walkable(pm, ax + (p) * sx, ay + (p) * sy)
+#define THEIRS(p) path_walkable(pm, bx + (p) * sx, by + (p) * sy)
+#define AT(p)     ((ay + (p) * sy) * hg->w + ax + (p) * sx)
+    int run = -1;
+    for (int p = 0; p <= len; p++) {
+        int open = p < len && OURS(p) && THEIRS(p);
+        if (open && run < 0) run = p;
+        if (open || run < 0) continue;
+        int last = p - 1;
+        if (last - run + 1 >= HPA_WIDE) {
+            out[n++] = AT(run);
+            out[n++] = AT(last);
+        } else {
+            out[n++] = AT((run + last) / 2);
+        }
+        run = -1;
+    }
+    /* A diagonal step across, where neither tile beside it crosses straight */
+    for (int p = 0; p + 1 < len; p++) {
+        if ((OURS(p) && THEIRS(p)) || (OURS(p + 1) && THEIRS(p + 1))) continue;
+        if (OURS(p) && THEIRS(p + 1)) out[n++] = AT(p);
+        if (OURS(p + 1) && THEIRS(p)) out[n++] = AT(p + 1);
+    }
+#undef OURS
+#undef THEIRS
+#undef AT
+    return n;
+}
+
+/* Append corner tile (x, y) to out[] if its only way into the diagonal
+   cluster at (x + ox, y + oy) is the diagonal step.  Returns the new
+   count. */
+static int corner_node(const HpaGraph *hg, const PathMap *pm, int x, int y, int ox, int oy,
+                       int32_t *out, int n)
+{
+    if (path_walkable(pm, x, y) && path_walkable(pm, x + ox, y + oy) &&
+        !path_walkable(pm, x + ox, y) && !path_walkable(pm, x, y + oy))
+        out[n++] = y * hg->w + x;
+    return n;
+}
+
+static int cmp_i32(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Find cluster k's entrances and the steps between them.  Leaves the
+   cluster without nodes if out of memory. */
+static void cluster_build(HpaGraph *hg, const PathMap *pm, int k)
+{
+    HpaCluster *c = &hg->cl[k];
+    int         x0, y0, x1, y1, n = 0;
+    int32_t     tile[8 * HPA_CLUSTER];
+    int         cell[8 * HPA_CLUSTER];
+    uint16_t    dist[HPA_FRAME_CELLS];
+    uint8_t     open[HPA_FRAME_CELLS];
+    cluster_box(hg, k, &x0, &y0, &x1, &y1);
+    if (x0 > 0)     n = border_nodes(hg, pm, x0, y0, x0 - 1, y0, 0, 1, y1 - y0, tile, n);
+    if (x1 < hg->w) n = border_nodes(hg, pm, x1 - 1, y0, x1, y0, 0, 1, y1 - y0, tile, n);
+    if (y0 > 0)     n = border_nodes(hg, pm, x0, y0, x0, y0 - 1, 1, 0, x1 - x0, tile, n);
+    if (y1 < hg->h) n = border_nodes(hg, pm, x0, y1 - 1, x0, y1, 1, 0, x1 - x0, tile, n);
+    n = corner_node(hg, pm, x0, y0, -1, -1, tile, n);
+    n = corner_node(hg, pm, x1 - 1, y0, 1, -1, tile, n);
+    n = corner_node(hg, pm, x0, y1 - 1, -1, 1, tile, n);
+    n = corner_node(hg, pm, x1 - 1, y1 - 1, 1, 1, tile, n);
+
+    /* A corner tile can be an entrance on two borders */
+    qsort(tile, (size_t)n, sizeof(*tile), cmp_i32);
+    int u = 0;
+    for (int i = 0; i < n; i++)
+        if (u == 0 || tile[i] != tile[u - 1]) tile[u++] = tile[i];
+    n = u;
+
+    if (n > c->cap) {
+        int32_t  *t = realloc(c->tile, (size_t)n * sizeof(*t));
+        if (t) c->tile = t;
+        uint16_t *d = t ? realloc(c->dist, (size_t)n * n * sizeof(*d)) : NULL;
+        if (d) c->dist = d;
+        if (!t || !d) {
+            c->n = 0;
+            return;
+        }
+        c->cap = n;
+    }
+    c->n = n;
+    if (n == 0) return;
+    memcpy(c->tile, tile, (size_t)n * sizeof(*tile));
+    cluster_open(hg, pm, k, open);
+    for (int i = 0; i < n; i++) cell[i] = frame_cell(hg, k, tile[i]);
+    for (int i = 0; i < n; i++) {
+        cluster_bfs(open, &cell[i], 1, dist);
+        for (int j = 0; j < n; j++) c->dist[i * n + j] = dist[cell[j]];
+    }
+}
+
+static void cluster_mark(HpaGraph *hg, int k)
+{
+    if (hg->dirty[k]) return;
+    hg->dirty[k] = 1;
+    hg->dirty_list[hg->ndirty++] = k;
+}
+
+int hpa_init(HpaGraph *hg, int w, int h)
+{
+    memset(hg, 0, sizeof(*hg));
+    hg->w  = w;
+    hg->h  = h;
+    hg->cw = (w + HPA_CLUSTER - 1) / HPA_CLUSTER;
+    hg->ch = (h + HPA_CLUSTER - 1) / HPA_CLUSTER;
+    size_t ncl = (size_t)hg->cw * (size_t)hg->ch;
+    hg->cl         = calloc(ncl, sizeof(*hg->cl));
+    hg->base       = calloc(ncl + 1, sizeof(*hg->base));
+    hg->dirty      = calloc(ncl, 1);
+    hg->dirty_list = malloc(ncl * sizeof(*hg->dirty_list));
+    if (!hg->cl || !hg->base || !hg->dirty || !hg->dirty_list) {
+        hpa_free(hg);
+        return -1;
+    }
+    for (size_t k = 0; k < ncl; k++) cluster_mark(hg, (int)k);
+    return 0;
+}
+
+void hpa_free(HpaGraph *hg)
+{
+    for (int k = 0; hg->cl && k < hg->cw * hg->ch; k++) {
+        free(hg->cl[k].tile);
+        free(hg->cl[k].dist);
+    }
+    free(hg->cl);
+    free(hg->base);
+    free(hg->dirty);
+    free(hg->dirty_list);
+    memset(hg, 0, sizeof(*hg));
+}
+
+void hpa_tile_changed(HpaGraph *hg, int x, int y)
+{
+    if (x < 0 || x >= hg->w || y < 0 || y >= hg->h) return;
+    /* Entrances look one tile across the border, so a tile on one (or on
+       a corner) changes those of the clusters beyond it too */
+    for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++) {
+            int nx = x + dx, ny = y + dy;
+            if (nx >= 0 && nx < hg->w && ny >= 0 && ny < hg->h)
+                cluster_mark(hg, cluster_of(hg, nx, ny));
+        }
+}
+
+int hpa_sync(HpaGraph *hg, const PathMap *pm)
+{
+    int built = hg->ndirty;
+    for (int i = 0; i < hg->ndirty; i++) {
+        hg->dirty[hg->dirty_list[i]] = 0;
+        cluster_build(hg, pm, hg->dirty_list[i]);
+    }
+    hg->ndirty = 0;
+    if (built)
+        for (int k = 0; k < hg->cw * hg->ch; k++) hg->base[k + 1] = hg->base[k] + hg->cl[k].n;
+    return built;
+}
+
+/* ---- open list over graph nodes ---------------------------------------- */
+static int node_before(const PathScratch *ps, int a, int b)
+{
+    if (ps->nf[a] != ps->nf[b]) return ps->nf[a] < ps->nf[b];
+    if (ps->ng[a] != ps->ng[b]) return ps->ng[a] > ps->ng[b];
+    return a < b;
+}
+
+static void node_up(PathScratch *ps, int i)
+{
+    int c = ps->nheap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!node_before(ps, c, ps->nheap[parent])) break;
+        ps->nheap[i] = ps->nheap[parent];
+        ps->nhpos[ps->nheap[i]] = i;
+        i = parent;
+    }
+    ps->nheap[i] = c;
+    ps->nhpos[c] = i;
+}
+
+static int node_pop(PathScratch *ps)
+{
+    int top  = ps->nheap[0];
+    int last = ps->nheap[--ps->nhn];
+    int i    = 0;
+    for (;;) {
+        int kid = 2 * i + 1;
+        if (kid >= ps->nhn) break;
+        if (kid + 1 < ps->nhn && node_before(ps, ps->nheap[kid + 1], ps->nheap[kid])) kid++;
+        if (!node_before(ps, ps->nheap[kid], last)) break;
+        ps->nheap[i] = ps->nheap[kid];
+        ps->nhpos[ps->nheap[i]] = i;
+        i = kid;
+    }
+    if (ps->nhn > 0) {
+        ps->nheap[i]    = last;
+        ps->nhpos[last] = i;
+    }
+    ps->nhpos[top] = CLOSED;
+    return top;
+}
+
+/* Offer node v at g steps, with h steps still to go at the least. */
+static void node_reach(PathScratch *ps, int v, int from, uint32_t g, uint32_t h)
+{
+    if (ps->nstamp[v] == ps->nsearch) {
+        if (ps->nhpos[v] == CLOSED || g >= ps->ng[v]) return;
+        ps->ng[v]    = g;
+        ps->nf[v]    = g + h;
+        ps->nfrom[v] = from;
+        node_up(ps, ps->nhpos[v]);
+        return;
+    }
+    ps->nstamp[v] = ps->nsearch;
+    ps->ng[v]     = g;
+    ps->nf[v]     = g + h;
+    ps->nfrom[v]  = from;
+    ps->nheap[ps->nhn] = v;
+    node_up(ps, ps->nhn++);
+}
+
+/* Make room in ps for a search over n nodes.  Returns 0, or -1 if out of
+   memory. */
+static int node_reserve(PathScratch *ps, int n)
+{
+    if (n <= ps->ncap) return 0;
+    int cap = ps->ncap ? ps->ncap : 1024;
+    while (cap < n) cap *= 2;
+    void *p;
+    if (!(p = realloc(ps->nstamp, (size_t)cap * sizeof(*ps->nstamp)))) return -1;
+    ps->nstamp = p;
+    if (!(p = realloc(ps->nf, (size_t)cap * sizeof(*ps->nf)))) return -1;
+    ps->nf = p;
+    if (!(p = realloc(ps->ng, (size_t)cap * sizeof(*ps->ng)))) return -1;
+    ps->ng = p;
+    if (!(p = realloc(ps->nfrom, (size_t)cap * sizeof(*ps->nfrom)))) return -1;
+    ps->nfrom = p;
+    if (!(p = realloc(ps->nhpos, (size_t)cap * sizeof(*ps->nhpos)))) return -1;
+    ps->nhpos = p;
+    if (!(p = realloc(ps->nheap, (size_t)cap * sizeof(*ps->nheap)))) return -1;
+    ps->nheap = p;
+    memset(ps->nstamp, 0, (size_t)cap * sizeof(*ps->nstamp));
+    ps->nsearch = 0;
+    ps->ncap    = cap;
+    return 0;
+}
+
+/* Cluster holding node id v (which must be a real node). */
+static int node_cluster(const HpaGraph *hg, int v)
+{
+    int lo = 0, hi = hg->cw * hg->ch - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (hg->base[mid] <= v) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+/* The goal's side of a search: the walkable tiles within `near` of it,
+   grouped by the (at most four) clusters they fall in, with the steps
+   from each tile of those clusters to the nearest of them. */
+typedef struct {
+    int      n;
+    int      k[4];
+    uint16_t dist[4][HPA_FRAME_CELLS];
+} GoalSide;
+
+/* Search the graph for a way from (sx, sy) to within `near` of (gx, gy).
+   On success leaves the path's nodes in ps->nheap, goal first and the
+   start's first node last, and returns how many; returns -1 if there is
+   no way, or -2 if out of memory. */
+static int graph_search(const HpaGraph *hg, const PathMap *pm, PathScratch *ps, int sx, int sy,
+                        int gx, int gy, int near, GoalSide *gs)
+{
+    int total = hg->base[hg->cw * hg->ch], goal = total, start = total + 1;
+    if (node_reserve(ps, total + 2) != 0) return -2;
+
+    /* The goal's tiles, a cluster at a time */
+    int     seed[HPA_CELLS];
+    uint8_t open[HPA_FRAME_CELLS];
+    gs->n = 0;
+    for (int y = gy - near; y <= gy + near; y++)
+        for (int x = gx - near; x <= gx + near; x++) {
+            if (!path_walkable(pm, x, y)) continue;
+            int k = cluster_of(hg, x, y), q = 0;
+            while (q < gs->n && gs->k[q] != k) q++;
+            if (q == gs->n) gs->k[gs->n++] = k;
+        }
+    for (int q = 0; q < gs->n; q++) {
+        int n = 0;
+        for (int y = gy - near; y <= gy + near; y++)
+            for (int x = gx - near; x <= gx + near; x++)
+                if (path_walkable(pm, x, y) && cluster_of(hg, x, y) == gs->k[q])
+                    seed[n++] = frame_cell(hg, gs->k[q], y * hg->w + x);
+        cluster_open(hg, pm, gs->k[q], open);
+        cluster_bfs(open, seed, n, gs->dist[q]);
+    }
+    if (gs->n == 0) return -1;
+
+    if (++ps->nsearch == 0) {
+        memset(ps->nstamp, 0, (size_t)ps->ncap * sizeof(*ps->nstamp));
+        ps->nsearch = 1;
+    }
+    ps->nhn = 0;
+
+    /* The start reaches its own cluster's nodes, and the goal if it shares it */
+    uint16_t sdist[HPA_FRAME_CELLS];
+    int      sk = cluster_of(hg, sx, sy), st = frame_cell(hg, sk, sy * hg->w + sx);
+    cluster_open(hg, pm, sk, open);
+    cluster_bfs(open, &st, 1, sdist);
+    ps->nstamp[start] = ps->nsearch;
+    ps->nhpos[start]  = CLOSED;
+    for (int i = 0; i < hg->cl[sk].n; i++) {
+        int32_t t = hg->cl[sk].tile[i];
+        int     d = sdist[frame_cell(hg, sk, t)];
+        if (d != FLOW_FAR)
+            node_reach(ps, hg->base[sk] + i, start, (uint32_t)d,
+                       heuristic(t % hg->w, t / hg->w, gx, gy, near));
+    }
+    for (int q = 0; q < gs->n; q++) {
+        if (gs->k[q] != sk) continue;
+        uint32_t best = FLOW_FAR;
+        for (int c = 0; c < HPA_FRAME_CELLS; c++)
+            if (gs->dist[q][c] == 0 && sdist[c] < best) best = sdist[c];
+        if (best != FLOW_FAR) node_reach(ps, goal, start, best, 0);
+    }
+
+    int reached = 0;
+    while (ps->nhn > 0) {
+        int v = node_pop(ps);
+        if (v == goal) {
+            reached = 1;
+            break;
+        }
+        int               k = node_cluster(hg, v), i = v - hg->base[k];
+        const HpaCluster *c = &hg->cl[k];
+        int32_t           t = c->tile[i];
+        int               x = t % hg->w, y = t / hg->w;
+        uint32_t          g = ps->ng[v];
+        for (int j = 0; j < c->n; j++) {
+            int d = c->dist[i * c->n + j];
+            if (j == i || d == FLOW_FAR) continue;
+            node_reach(ps, hg->base[k] + j, v, g + (uint32_t)d,
+                       heuristic(c->tile[j] % hg->w, c->tile[j] / hg->w, gx, gy, near));
+        }
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (!path_walkable(pm, nx, ny)) continue;
+            int nk = cluster_of(hg, nx, ny);
+            if (nk == k) continue;
+            int j = cluster_node(&hg->cl[nk], ny * hg->w + nx);
+            if (j >= 0) node_reach(ps, hg->base[nk] + j, v, g + 1, heuristic(nx, ny, gx, gy, near));
+        }
+        for (int q = 0; q < gs->n; q++) {
+            if (gs->k[q] != k) continue;
+            int d = gs->dist[q][frame_cell(hg, k, t)];
+            if (d != FLOW_FAR) node_reach(ps, goal, v, g + (uint32_t)d, 0);
+        }
+    }
+    if (!reached) return -1;
+
+    int n = 0;
+    for (int v = goal; v != start; v = ps->nfrom[v]) ps->nheap[n++] = v;
+    return n;
+}
+
+PathStatus hpa_find(const HpaGraph *hg, const PathMap *pm, PathScratch *ps, int sx, int sy,
+                    int gx, int gy, int near, uint8_t *dirs, int max_dirs, int *ndirs)
+{
+    *ndirs = 0;
+    if (sx < 0 || sx >= pm->w || sy < 0 || sy >= pm->h) return PATH_NONE;
+    int dx = abs(gx - sx), dy = abs(gy - sy);
+    int whole = pm->w <= PATH_WIN && pm->h <= PATH_WIN;
+    int odd   = gx < 0 || gx >= pm->w || gy < 0 || gy >= pm->h || 2 * near + 1 > HPA_CLUSTER;
+    if (whole || odd || (dx <= HPA_DIRECT && dy <= HPA_DIRECT)) {
+        PathStatus st = path_find(pm, ps, sx, sy, gx, gy, near, dirs, max_dirs, ndirs);
+        if (st != PATH_PARTIAL || whole || odd) return st;
+    }
+
+    GoalSide gs;
+    int n = graph_search(hg, pm, ps, sx, sy, gx, gy, near, &gs);
+    if (n == -1) return PATH_NONE;
+    if (n < 0) return path_find(pm, ps, sx, sy, gx, gy, near, dirs, max_dirs, ndirs);
+
+    /* Plan tile by tile through the nodes until enough steps are out */
+    int got = 0, x = sx, y = sy;
+    for (int k = n - 1; k >= 0 && got < max_dirs; k--) {
+        int v = ps->nheap[k], tx = gx, ty = gy, tn = near, len;
+        if (k > 0) {
+            int c = node_cluster(hg, v);
+            int32_t t = hg->cl[c].tile[v - hg->base[c]];
+            tx = t % hg->w;
+            ty = t / hg->w;
+            tn = 0;
+        }
+        PathStatus st = path_find(pm, ps, x, y, tx, ty, tn, dirs + got, max_dirs - got, &len);
+        got += len;
+        if (st != PATH_FOUND) {
+            *ndirs = got;
+            return PATH_PARTIAL;
+        }
+        x = tx;
+        y = ty;
+    }
+    *ndirs = got;
+    return PATH_FOUND;
+}
+
+/* ======================================================================
+   REGIONS
+   ======================================================================
+   No more regions can stand apart at once than tiles on every other row
+   and column, plus the REGION_SIDES a split holds while it runs, so the
+   label table is sized once.  Freed labels are reused. */
+#define REGION_SIDES 4          /* most sides a closing tile can leave apart */
+
+int region_init(RegionMap *rm, int w, int h)
+{
+    size_t tiles = (size_t)w * (size_t)h;
+    size_t cap   = (size_t)((w + 1) / 2) * (size_t)((h + 1) / 2) + REGION_SIDES + 1;
+    memset(rm, 0, sizeof(*rm));
+    rm->w     = w;
+    rm->h     = h;
+    rm->next  = 1;
+    rm->label = calloc(tiles, sizeof(*rm->label));
+    rm->size  = calloc(cap, sizeof(*rm->size));
+    rm->box   = malloc(cap * 4 * sizeof(*rm->box));
+    rm->spare = malloc(cap * sizeof(*rm->spare));
+    rm->queue = malloc(tiles * sizeof(*rm->queue));
+    rm->link  = malloc(tiles * sizeof(*rm->link));
+    if (!rm->label || !rm->size || !rm->box || !rm->spare || !rm->queue || !rm->link) {
+        region_free(rm);
+        return -1;
+    }
+    return 0;
+}
+
+void region_free(RegionMap *rm)
+{
+    free(rm->label);
+    free(rm->size);
+    free(rm->box);
+    free(rm->spare);
+    free(rm->queue);
+    free(rm->link);
+    memset(rm, 0, sizeof(*rm));
+}
+
+static uint32_t label_take(RegionMap *rm)
+{
+    return rm->nspare > 0 ? rm->spare[--rm->nspare] : rm->next++;
+}
+
+static void box_start(RegionMap *rm, uint32_t l, int x, int y)
+{
+    int16_t *b = &rm->box[4 * (size_t)l];
+    b[0] = b[2] = (int16_t)x;
+    b[1] = b[3] = (int16_t)y;
+}
+
+static void box_add(RegionMap *rm, uint32_t l, int x, int y)
+{
+    int16_t *b = &rm->box[4 * (size_t)l];
+    if (x < b[0]) b[0] = (int16_t)x;
+    if (y < b[1]) b[1] = (int16_t)y;
+    if (x > b[2]) b[2] = (int16_t)x;
+    if (y > b[3]) b[3] = (int16_t)y;
+}
+
+static void label_drop(RegionMap *rm, uint32_t l)
+{
+    rm->size[l] = 0;
+    rm->spare[rm->nspare++] = l;
+}
+
+/* Relabel `to` every tile labelled `from` that tile t reaches. */
+static void region_flood(RegionMap *rm, int t, uint32_t from, uint32_t to)
+{
+    int head = 0, tail = 0;
+    rm->label[t] = to;
+    rm->queue[tail++] = t;
+    while (head < tail) {
+        int c = rm->queue[head++], x = c % rm->w, y = c / rm->w;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + path_dx[d], ny = y + path_dy[d];
+            if (region_of(rm, nx, ny) != from) continue;
+            rm->label[ny * rm->w + nx] = to;
+            rm->queue[tail++] = ny * rm->w + nx;
+        }
+    }
+}
+
+static void region_open(RegionMap *rm, int t)
+{
+    int      x = t % rm->w, y = t / rm->w;
+    uint32_t keep = 0;
+    for (int d = 0; d < 8; d++) {
+        uint32_t l = region_of(rm, x + path_dx[d], y + path_dy[d]);
+        if (l && (!keep || rm->size[l] > rm->size[keep] ||
+                  (rm->size[l] == rm->size[keep] && l < keep)))
+            keep = l;
+    }
+    if (!keep) {
+        keep = label_take(rm);
+        box_start(rm, keep, x, y);
+    }
+    box_add(rm, keep, x, y);
+    rm->label[t] = keep;
+    rm->size[keep]++;
+    for (int d = 0; d < 8; d++) {
+        int      nx = x + path_dx[d], ny = y + path_dy[d];
+        uint32_t l  = region_of(rm, nx, ny);
+        if (!l || l == keep) continue;
+        const int16_t *b = &rm->box[4 * (size_t)l];
+        box_add(rm, keep, b[0], b[1]);
+        box_add(rm, keep, b[2], b[3]);
+        rm->size[keep] += rm->size[l];
+        label_drop(rm, l);
+        region_flood(rm, ny * rm->w + nx, l, keep);
+    }
+}
+
+/* The floods of a split share queue[]: flood g's entries are chained
+   through link[] from first[g], and head[g] is the next one to expand. */
+typedef struct {
+    int      n;
+    uint32_t tmp[REGION_SIDES];  /* label of the tiles each flood has reached */
+    int      first[REGION_SIDES], head[REGION_SIDES], tail[REGION_SIDES];
+    int      count[REGION_SIDES];
+    int      joined[REGION_SIDES];   /* flood it has met, toward the group's root */
+    int      done[REGION_SIDES];
+    int      used;
+} Split;
+
+static int split_root(const Split *sp, int g)
+{
+    while (sp->joined[g] != g) g = sp->joined[g];
+    return g;
+}
+
+static void split_push(RegionMap *rm, Split *sp, int g, int t)
+{
+    int e = sp->used++;
+    rm->queue[e] = t;
+    rm->link[e]  = -1;
+    if (sp->count[g] > 0) rm->link[sp->tail[g]] = e;
+    if (sp->head[g] < 0) sp->head[g] = e;
+    sp->tail[g] = e;
+    sp->count[g]++;
+}
+
+/* Relabel every tile flood g has reached, growing to's box to hold them. */
+static void split_relabel(RegionMap *rm, const Split *sp, int g, uint32_t to)
+{
+    for (int e = sp->first[g]; e >= 0; e = rm->link[e]) {
+        int t = rm->queue[e];
+        rm->label[t] = to;
+        box_add(rm, to, t % rm->w, t / rm->w);
+    }
+}
+
+/* Region l has lost a tile, leaving sides around it that start at
+   seed[0..n) and may no longer meet.  Floods every side a tile per turn,
+   joining floods as they meet; a group whose floods all run dry while
+   another still spreads is cut off and keeps a label of its own.  The
+   last group left keeps l. */
+static void region_split(RegionMap *rm, uint32_t l, const int *seed, int n)
+{
+    Split sp;
+    sp.n    = n;
+    sp.used = 0;
+    for (int g = 0; g < n; g++) {
+        sp.tmp[g]    = label_take(rm);
+        sp.head[g]   = -1;
+        sp.count[g]  = 0;
+        sp.joined[g] = g;
+        sp.done[g]   = 0;
+        sp.first[g]  = sp.used;
+        rm->label[seed[g]] = sp.tmp[g];
+        split_push(rm, &sp, g, seed[g]);
+    }
+
+    int live = n;
+    while (live > 1) {
+        for (int g = 0; g < n; g++) {
+            if (sp.head[g] < 0 || sp.done[split_root(&sp, g)]) continue;
+            int c = rm->queue[sp.head[g]], x = c % rm->w, y = c / rm->w;
+            sp.head[g] = rm->link[sp.head[g]];
+            for (int d = 0; d < 8; d++) {
+                int      nx = x + path_dx[d], ny = y + path_dy[d];
+                uint32_t lv = region_of(rm, nx, ny);
+                if (lv == l) {
+                    rm->label[ny * rm->w + nx] = sp.tmp[g];
+                    split_push(rm, &sp, g, ny * rm->w + nx);
+                    continue;
+                }
+                for (int o = 0; o < n; o++) {
+                    if (lv != sp.tmp[o]) continue;
+                    int a = split_root(&sp, g), b = split_root(&sp, o);
+                    if (a != b) {
+                        sp.joined[a > b ? a : b] = a < b ? a : b;
+                        live--;
+                    }
+                    break;
+                }
+            }
+        }
+        for (int r = 0; r < n && live > 1; r++) {
+            if (split_root(&sp, r) != r || sp.done[r]) continue;
+            int dry = 1, total = 0;
+            for (int g = 0; g < n; g++)
+                if (split_root(&sp, g) == r) {
+                    dry   &= sp.head[g] < 0;
+                    total += sp.count[g];
+                }
+            if (!dry) continue;
+            sp.done[r] = 1;
+            live--;
+            int t = rm->queue[sp.first[r]];
+            box_start(rm, sp.tmp[r], t % rm->w, t / rm->w);
+            for (int g = 0; g < n; g++)
+                if (split_root(&sp, g) == r) {
+                    split_relabel(rm, &sp, g, sp.tmp[r]);
+                    if (g != r) label_drop(rm, sp.tmp[g]);
+                }
+            rm->size[sp.tmp[r]] = total;
+            rm->size[l] -= total;
+        }
+    }
+    for (int g = 0; g < n; g++)
+        if (!sp.done[split_root(&sp, g)]) {
+            split_relabel(rm, &sp, g, l);           /* inside l's box already */
+            label_drop(rm, sp.tmp[g]);
+        }
+}
+
+/* Ring of the eight tiles around one, in order round it. */
+static const int8_t ring_dx[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+static const int8_t ring_dy[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+static void region_close(RegionMap *rm, int t)
+{
+    int      x = t % rm->w, y = t / rm->w;
+    uint32_t l = rm->label[t];
+    rm->label[t] = 0;
+    if (--rm->size[l] == 0) {
+        label_drop(rm, l);
+        return;
+    }
+
+    /* Sides: the walkable tiles of the ring, joined where they touch */
+    int side[8], seed[REGION_SIDES], n = 0;
+    for (int i = 0; i < 8; i++) side[i] = region_of(rm, x + ring_dx[i], y + ring_dy[i]) ? -2 : -1;
+    for (int i = 0; i < 8; i++) {
+        if (side[i] != -2) continue;
+        int stack[8], sn = 0;
+        seed[n]       = (y + ring_dy[i]) * rm->w + x + ring_dx[i];
+        side[i]       = n;
+        stack[sn++]   = i;
+        while (sn > 0) {
+            int a = stack[--sn];
+            for (int j = 0; j < 8; j++)
+                if (side[j] == -2 && abs(ring_dx[a] - ring_dx[j]) <= 1 &&
+                    abs(ring_dy[a] - ring_dy[j]) <= 1) {
+                    side[j]     = n;
+                    stack[sn++] = j;
+                }
+        }
+        n++;
+    }
+    if (n > 1) region_split(rm, l, seed, n);
+}
+
+void region_tile_changed(RegionMap *rm, const PathMap *pm, int x, int y)
+{
+    if (x < 0 || x >= rm->w || y < 0 || y >= rm->h) return;
+    int t = y * rm->w + x, walk = path_walkable(pm, x, y);
+    if (walk == (rm->label[t] != 0)) return;
+    if (walk) region_open(rm, t);
+    else region_close(rm, t);
+}
+
+int region_connected(const RegionMap *rm, int sx, int sy, int gx, int gy, int near)
+{
+    uint32_t from[8];
+    int      n = 0;
+    if ((from[0] = region_of(rm, sx, sy)) != 0) {
+        n = 1;
+    } else {
+        for (int d = 0; d < 8; d++) {
+            uint32_t l = region_of(rm, sx + path_dx[d], sy + path_dy[d]);
+            if (l) from[n++] = l;
+        }
+    }
+    /* The goal tile itself first: it is usually walkable */
+    uint32_t l = region_of(rm, gx, gy);
+    for (int k = 0; l && k < n; k++)
+        if (from[k] == l) return 1;
+    for (int y = gy - near; n > 0 && y <= gy + near; y++)
+        for (int x = gx - near; x <= gx + near; x++) {
+            l = region_of(rm, x, y);
+            for (int k = 0; l && k < n; k++)
+                if (from[k] == l) return 1;
+        }
+    return 0;
+}
@@ -0,0 +1,217 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * path.h — Grid A* over a passability map
+ *
+ * Units move one tile per step in any of eight directions, so a step costs
+ * the same whether it is straight or diagonal and the Chebyshev distance is
+ * an exact lower bound.  The open list is a binary heap with decrease-key.
+ *
+ * A search only looks at a PATH_WIN x PATH_WIN window of the map, placed to
+ * hold the start and as much of the way to the goal as fits; a map no
+ * bigger than that is searched whole.  All per-search memory lives in a
+ * PathScratch, which a PathPool hands out to one thread at a time, so
+ * searching never allocates.
+ *
+ * Where many walkers share the same goals, a FlowSet holds instead the
+ * distance from every tile to its nearest goal and the step toward it,
+ * kept up to date as goals and tiles change.  A goal further off than the
+ * window reaches is planned over an HpaGraph of cluster entrances first,
+ * and a RegionMap tells up front whether a goal can be reached at all.
+ */
+
+#ifndef PATH_H
+#define PATH_H
+
+#include <stdint.h>
+
+#define PATH_WIN  128            /* side of the search window (tiles) */
+
+/* Direction d steps by (path_dx[d], path_dy[d]); 0..3 straight, 4..7 diagonal. */
+extern const int8_t path_dx[8];
+extern const int8_t path_dy[8];
+
+/* Which tiles can be stepped on.  epoch changes whenever a tile does, so a
+   path planned at one epoch is known to still be walkable at the same
+   epoch. */
+typedef struct {
+    int      w, h;
+    uint8_t *pass;              /* w * h, row-major: 1 walkable, 0 not */
+    uint32_t epoch;
+} PathMap;
+
+/* Allocate an all-blocked map.  Returns 0, or -1 if out of memory. */
+int  path_map_init(PathMap *pm, int w, int h);
+void path_map_free(PathMap *pm);
+/* Set one tile.  Returns 1 (and bumps epoch) if its walkability changed. */
+int  path_map_set(PathMap *pm, int x, int y, int walkable);
+
+static inline int path_walkable(const PathMap *pm, int x, int y)
+{
+    return x >= 0 && x < pm->w && y >= 0 && y < pm->h && pm->pass[(long)y * pm->w + x];
+}
+
+typedef enum {
+    PATH_FOUND   = 0,           /* dirs lead to within `near` of the goal      */
+    PATH_PARTIAL = 1,           /* the goal is outside the window: dirs lead
+                                   to the explored tile nearest it             */
+    PATH_NONE    = 2,           /* nothing walkable gets within `near` of it   */
+} PathStatus;
+
+typedef struct PathScratch PathScratch;
+typedef struct PathPool    PathPool;
+
+/* A fixed set of scratches for concurrent searches.  acquire returns one
+   no other thread holds, or NULL once all `count` are taken; release hands
+   it back.  create returns NULL if out of memory. */
+PathPool    *path_pool_create(int count);
+void         path_pool_destroy(PathPool *pp);
+PathScratch *path_pool_acquire(PathPool *pp);
+void         path_pool_release(PathPool *pp, PathScratch *ps);
+
+/* Plan from (sx, sy) to any tile within Chebyshev distance `near` of
+   (gx, gy), which need not be walkable itself.  The first min(length,
+   max_dirs) steps go to dirs[] and their count to *ndirs; a path longer
+   than max_dirs is cut short, to be planned again from its end.  The
+   start tile is never tested for walkability. */
+PathStatus path_find(const PathMap *pm, PathScratch *ps, int sx, int sy, int gx, int gy,
+                     int near, uint8_t *dirs, int max_dirs, int *ndirs);
+
+/* ======================================================================
+   FLOW FIELDS
+   ======================================================================
+   Field f gives, for every tile, the steps to the nearest of its sources
+   and the direction of one step closer.  Sources are tiles; a tile is
+   reached through walkable tiles only, but a source need not be walkable.
+   Each change is applied incrementally: a new source or a newly walkable
+   tile spreads shorter distances outward, and a removed source or a newly
+   blocked tile clears every tile whose step chain ran through it and
+   refills them from the tiles around. */
+#define FLOW_FAR    0xFFFF       /* no source reachable                */
+#define FLOW_NO_DIR 0xFF         /* at a source, or no source reachable */
+
+typedef struct {
+    int       w, h;
+    int       nfields;
+    uint16_t *dist;              /* nfields * w * h, row-major per field */
+    uint8_t  *dir;
+    int      *nsrc;              /* sources per field                   */
+    /* work space for one update at a time */
+    int32_t  *queue;             /* w * h */
+    uint64_t *seeds;             /* w * h + 1: distance << 32 | tile    */
+    uint32_t *stamp;             /* w * h: update that last settled it  */
+    uint32_t  update;
+} FlowSet;
+
+/* Allocate nfields empty fields.  Returns 0, or -1 if out of memory. */
+int  flow_init(FlowSet *fs, int w, int h, int nfields);
+void flow_free(FlowSet *fs);
+void flow_add_source(FlowSet *fs, const PathMap *pm, int f, int x, int y);
+void flow_remove_source(FlowSet *fs, const PathMap *pm, int f, int x, int y);
+/* Call after path_map_set changed (x, y); updates every field. */
+void flow_tile_changed(FlowSet *fs, const PathMap *pm, int x, int y);
+
+static inline int flow_dist(const FlowSet *fs, int f, int x, int y)
+{
+    return fs->dist[((long)f * fs->h + y) * fs->w + x];
+}
+
+static inline int flow_dir(const FlowSet *fs, int f, int x, int y)
+{
+    return fs->dir[((long)f * fs->h + y) * fs->w + x];
+}
+
+/* ======================================================================
+   HIERARCHY (HPA*)
+   ======================================================================
+   The map is cut into HPA_CLUSTER-square clusters.  Wherever two clusters
+   side by side share a run of border tiles walkable on both sides, the
+   run gets an entrance: a node in each cluster at its middle, or at both
+   its ends once it is HPA_WIDE tiles or longer.  A diagonal step across a
+   border or a corner that no straight one stands in for gets a node at
+   each end too, so the graph connects exactly the tiles the map does.
+   Each cluster caches the steps between every pair of its own nodes
+   without leaving it.  A long search runs A* over the nodes, then plans
+   tile by tile only as far as the steps asked for.  A changed tile marks
+   the clusters within a tile of it for hpa_sync() to rebuild. */
+#define HPA_CLUSTER 16           /* side of a cluster (tiles)              */
+#define HPA_WIDE    6            /* entrance long enough for a node per end */
+
+typedef struct {
+    int       n, cap;            /* nodes, and room for them               */
+    int32_t  *tile;              /* n map tiles, ascending                 */
+    uint16_t *dist;              /* n * n steps inside the cluster, or FLOW_FAR */
+} HpaCluster;
+
+typedef struct {
+    int         w, h;
+    int         cw, ch;          /* clusters across and down               */
+    HpaCluster *cl;              /* cw * ch, row-major                     */
+    int        *base;            /* cw * ch + 1: id of each cluster's first node */
+    uint8_t    *dirty;           /* cw * ch: waiting in dirty_list         */
+    int32_t    *dirty_list;
+    int         ndirty;
+} HpaGraph;
+
+/* Allocate a graph with every cluster dirty.  Returns 0, or -1 if out of
+   memory. */
+int  hpa_init(HpaGraph *hg, int w, int h);
+void hpa_free(HpaGraph *hg);
+/* Call after path_map_set changed (x, y). */
+void hpa_tile_changed(HpaGraph *hg, int x, int y);
+/* Rebuild the dirty clusters.  Returns how many were rebuilt.  Not safe to
+   run alongside hpa_find. */
+int  hpa_sync(HpaGraph *hg, const PathMap *pm);
+
+/* path_find for goals of any distance, with the same arguments and
+   results, except that PATH_PARTIAL is only returned when out of memory.
+   A goal the window holds is searched as path_find does; one further off,
+   or not reachable inside the window, is searched over the graph, whose
+   paths may run a few percent longer than the shortest.  The graph must
+   be in sync with pm.  Grows ps the first time the graph outgrows it. */
+PathStatus hpa_find(const HpaGraph *hg, const PathMap *pm, PathScratch *ps, int sx, int sy,
+                    int gx, int gy, int near, uint8_t *dirs, int max_dirs, int *ndirs);
+
+/* ======================================================================
+   REGIONS
+   ======================================================================
+   Walkable tiles that reach one another share a region label, so whether
+   a goal can be reached at all is a lookup.  Labels follow every tile
+   change: a tile opening joins the regions around it, relabelling all but
+   the largest; a tile closing that leaves its neighbours unjoined around
+   it floods outward from each side at once until all but one side has
+   run out of tiles, and only the sides that ran out are relabelled. */
+typedef struct {
+    int       w, h;
+    uint32_t *label;             /* w * h: region of each tile, 0 if blocked */
+    int32_t  *size;              /* tiles per label, 0 if unused            */
+    int16_t  *box;               /* 4 per label: x0, y0, x1, y1 bounding its
+                                    tiles (loosely, after a tile closes)    */
+    uint32_t *spare;             /* unused labels below next                */
+    int       nspare;
+    uint32_t  next;              /* lowest label never used                 */
+    /* work space for one update at a time */
+    int32_t  *queue;             /* w * h: tiles in the order floods reach them */
+    int32_t  *link;              /* w * h: next entry of the same flood     */
+} RegionMap;
+
+/* Allocate labels for an all-blocked map.  Returns 0, or -1 if out of
+   memory. */
+int  region_init(RegionMap *rm, int w, int h);
+void region_free(RegionMap *rm);
+/* Call after path_map_set changed (x, y). */
+void region_tile_changed(RegionMap *rm, const PathMap *pm, int x, int y);
+/* Whether any walkable tile within Chebyshev distance `near` of (gx, gy)
+   is in the region of (sx, sy), or of a tile beside it if (sx, sy) is
+   blocked itself. */
+int  region_connected(const RegionMap *rm, int sx, int sy, int gx, int gy, int near);
+
+static inline uint32_t region_of(const RegionMap *rm, int x, int y)
+{
+    if (x < 0 || x >= rm->w || y < 0 || y >= rm->h) return 0;
+    return rm->label[(long)y * rm->w + x];
+}
+
+#endif /* PATH_H */
@@ -0,0 +1,1183 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * sim_schedule.c — Kernel registry and dependency-graph scheduler.
+ *
+ * A scheduled tick is built in three steps:
+ *
+ *   1. Kernel edges.  Walking the kernels in program order, each kernel
+ *      depends on the last earlier writer of every field it reads or
+ *      writes, and on every reader since then of each field it writes
+ *      (read-after-write, write-after-write, write-after-read).
+ *   2. Tasks.  An element-wise kernel over n elements becomes
+ *      ceil(n / SCHED_GRAIN) tasks on aligned index ranges; anything else
+ *      (the grid build and flocking kernels, index-seeded rolls) is one task.
+ *   3. Task edges.  Element i of an element-wise kernel touches only
+ *      element i of any array, so between two split kernels range r waits
+ *      only for range r.  Every other kernel edge joins all tasks of both.
+ *
+ * A range runs its kernel unchanged on an offset view: a copy of each SoA
+ * struct with every array advanced by the range start and `count` cut to
+ * the range (or, for a SoA the kernel only pairs by index, to what is left
+ * of it), so the index guards inside the kernels keep working.
+ */
+
+#include "sim_schedule.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jobs.h"
+
+#define SCHED_GRAIN 4096   /* elements per task of an element-wise kernel */
+#define SF_END      (-1)   /* terminates a registry field list */
+#define MAX_FIELDS  16     /* longest registry field list, with SF_END */
+
+/* ======================================================================
+   OFFSET VIEWS
+   ====================================================================== */
+#define SHIFT(a) ((a) ? (a) + lo : (a))
+
+/* Elements of a `count`-long SoA inside [lo, hi). */
+static int view_count(int count, int lo, int hi)
+{
+    int n = (hi < count ? hi : count) - lo;
+    return n > 0 ? n : 0;
+}
+
+static PopSoA pop_view(const PopSoA *s, int lo, int hi)
+{
+    PopSoA v = *s;
+    v.population   = SHIFT(v.population);   v.carrying_cap   = SHIFT(v.carrying_cap);
+    v.growth_rate  = SHIFT(v.growth_rate);  v.susceptible    = SHIFT(v.susceptible);
+    v.infected     = SHIFT(v.infected);     v.recovered      = SHIFT(v.recovered);
+    v.beta         = SHIFT(v.beta);         v.gamma_rec      = SHIFT(v.gamma_rec);
+    v.food_supply  = SHIFT(v.food_supply);  v.food_threshold = SHIFT(v.food_threshold);
+    v.age_young    = SHIFT(v.age_young);    v.age_adult      = SHIFT(v.age_adult);
+    v.age_elder    = SHIFT(v.age_elder);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static FaithSoA faith_view(const FaithSoA *s, int lo, int hi)
+{
+    FaithSoA v = *s;
+    v.faith_level    = SHIFT(v.faith_level);    v.mana            = SHIFT(v.mana);
+    v.mana_regen     = SHIFT(v.mana_regen);     v.heresy_rate     = SHIFT(v.heresy_rate);
+    v.miracle_chance = SHIFT(v.miracle_chance); v.devotee_count   = SHIFT(v.devotee_count);
+    v.temple_count   = SHIFT(v.temple_count);   v.schism_risk     = SHIFT(v.schism_risk);
+    v.conversion_rate= SHIFT(v.conversion_rate);v.divine_favor    = SHIFT(v.divine_favor);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static CombatSoA combat_view(const CombatSoA *s, int lo, int hi)
+{
+    CombatSoA v = *s;
+    v.base_atk     = SHIFT(v.base_atk);     v.armor          = SHIFT(v.armor);
+    v.hp           = SHIFT(v.hp);           v.max_hp         = SHIFT(v.max_hp);
+    v.morale       = SHIFT(v.morale);       v.morale_decay   = SHIFT(v.morale_decay);
+    v.hit_chance   = SHIFT(v.hit_chance);   v.crit_chance    = SHIFT(v.crit_chance);
+    v.crit_mult    = SHIFT(v.crit_mult);    v.rout_threshold = SHIFT(v.rout_threshold);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static EconSoA econ_view(const EconSoA *s, int lo, int hi)
+{
+    EconSoA v = *s;
+    v.resource      = SHIFT(v.resource);      v.max_resource   = SHIFT(v.max_resource);
+    v.gather_rate   = SHIFT(v.gather_rate);   v.depletion_rate = SHIFT(v.depletion_rate);
+    v.price         = SHIFT(v.price);         v.demand         = SHIFT(v.demand);
+    v.supply        = SHIFT(v.supply);        v.tax_rate       = SHIFT(v.tax_rate);
+    v.tax_collected = SHIFT(v.tax_collected); v.trade_volume   = SHIFT(v.trade_volume);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static EnvSoA env_view(const EnvSoA *s, int lo, int hi)
+{
+    EnvSoA v = *s;
+    v.temperature    = SHIFT(v.temperature);    v.temp_target = SHIFT(v.temp_target);
+    v.rainfall       = SHIFT(v.rainfall);       v.humidity    = SHIFT(v.humidity);
+    v.wind_x         = SHIFT(v.wind_x);         v.wind_y      = SHIFT(v.wind_y);
+    v.fire_intensity = SHIFT(v.fire_intensity); v.fuel        = SHIFT(v.fuel);
+    v.elevation      = SHIFT(v.elevation);      v.pressure    = SHIFT(v.pressure);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static MoveSoA move_view(const MoveSoA *s, int lo, int hi)
+{
+    MoveSoA v = *s;
+    v.pos_x   = SHIFT(v.pos_x);   v.pos_y     = SHIFT(v.pos_y);
+    v.vel_x   = SHIFT(v.vel_x);   v.vel_y     = SHIFT(v.vel_y);
+    v.acc_x   = SHIFT(v.acc_x);   v.acc_y     = SHIFT(v.acc_y);
+    v.heading = SHIFT(v.heading); v.speed     = SHIFT(v.speed);
+    v.max_speed = SHIFT(v.max_speed); v.h_cost = SHIFT(v.h_cost);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static DivineSoA divine_view(const DivineSoA *s, int lo, int hi)
+{
+    DivineSoA v = *s;
+    v.energy         = SHIFT(v.energy);         v.energy_cap    = SHIFT(v.energy_cap);
+    v.regen_rate     = SHIFT(v.regen_rate);     v.meteor_cost   = SHIFT(v.meteor_cost);
+    v.heal_amount    = SHIFT(v.heal_amount);    v.heal_decay    = SHIFT(v.heal_decay);
+    v.terraform_cost = SHIFT(v.terraform_cost); v.smite_power   = SHIFT(v.smite_power);
+    v.blessing_mult  = SHIFT(v.blessing_mult);  v.cooldown      = SHIFT(v.cooldown);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static PsychSoA psych_view(const PsychSoA *s, int lo, int hi)
+{
+    PsychSoA v = *s;
+    v.happiness     = SHIFT(v.happiness);     v.fear          = SHIFT(v.fear);
+    v.loyalty       = SHIFT(v.loyalty);       v.aggression    = SHIFT(v.aggression);
+    v.utility_work  = SHIFT(v.utility_work);  v.utility_fight = SHIFT(v.utility_fight);
+    v.utility_flee  = SHIFT(v.utility_flee);  v.threat_level  = SHIFT(v.threat_level);
+    v.memory_decay  = SHIFT(v.memory_decay);  v.social_bond   = SHIFT(v.social_bond);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static TechSoA tech_view(const TechSoA *s, int lo, int hi)
+{
+    TechSoA v = *s;
+    v.research_pts     = SHIFT(v.research_pts);     v.research_rate   = SHIFT(v.research_rate);
+    v.tech_cost        = SHIFT(v.tech_cost);        v.tech_level      = SHIFT(v.tech_level);
+    v.golden_age_mult  = SHIFT(v.golden_age_mult);  v.golden_age_timer= SHIFT(v.golden_age_timer);
+    v.culture          = SHIFT(v.culture);          v.culture_spread  = SHIFT(v.culture_spread);
+    v.era              = SHIFT(v.era);              v.pop_bonus       = SHIFT(v.pop_bonus);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+static EngineSoA engine_view(const EngineSoA *s, int lo, int hi)
+{
+    EngineSoA v = *s;
+    v.entropy      = SHIFT(v.entropy);      v.entropy_rate = SHIFT(v.entropy_rate);
+    v.grid_x       = SHIFT(v.grid_x);       v.grid_y       = SHIFT(v.grid_y);
+    v.inv_sqrt_val = SHIFT(v.inv_sqrt_val); v.inv_sqrt_out = SHIFT(v.inv_sqrt_out);
+    v.stability    = SHIFT(v.stability);    v.end_timer    = SHIFT(v.end_timer);
+    v.victory_pts  = SHIFT(v.victory_pts);  v.chaos_mult   = SHIFT(v.chaos_mult);
+    v.rng_state    = SHIFT(v.rng_state);
+    v.count = view_count(s->count, lo, hi);
+    return v;
+}
+
+/* ======================================================================
+   KERNEL WRAPPERS — run one registered kernel over [lo, hi)
+   ====================================================================== */
+#define RUN_ARGS const SimWorld *w, const SimParams *p, int lo, int hi
+
+static void run_pop_logistic_growth(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_logistic_growth(&v, p->dt);
+}
+
+static void run_pop_sir_step(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_sir_step(&v, p->dt);
+}
+
+static void run_pop_starvation(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_starvation(&v, p->dt);
+}
+
+static void run_pop_age_cohort_shift(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_age_cohort_shift(&v, p->dt);
+}
+
+static void run_pop_birth_rate(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_birth_rate(&v, p->dt);
+}
+
+static void run_pop_death_rate(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_death_rate(&v, p->dt);
+}
+
+static void run_pop_carrying_cap_pressure(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    (void)p;
+    pop_carrying_cap_pressure(&v);
+}
+
+static void run_pop_epidemic_mortality(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_epidemic_mortality(&v, p->epidemic_mortality, p->dt);
+}
+
+static void run_pop_recovery_bonus(RUN_ARGS)
+{
+    PopSoA v = pop_view(w->pop, lo, hi);
+    pop_recovery_bonus(&v, p->dt);
+}
+
+static void run_faith_generate(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_generate(&v, p->dt);
+}
+
+static void run_faith_mana_regen(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_mana_regen(&v, p->dt);
+}
+
+static void run_faith_heresy_spread(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_heresy_spread(&v, p->dt);
+}
+
+static void run_faith_miracle_check(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_miracle_check(&v, p->miracle_out + lo);
+}
+
+static void run_faith_conversion_tick(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_conversion_tick(&v, p->dt);
+}
+
+static void run_faith_schism_accumulate(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_schism_accumulate(&v, p->dt);
+}
+
+static void run_faith_divine_favor_update(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_divine_favor_update(&v, p->piety_delta);
+}
+
+static void run_faith_temple_bonus(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    (void)p;
+    faith_temple_bonus(&v);
+}
+
+static void run_faith_devotee_update(RUN_ARGS)
+{
+    FaithSoA v = faith_view(w->faith, lo, hi);
+    faith_devotee_update(&v, p->dt);
+}
+
+static void run_combat_armor_mitigation(RUN_ARGS)
+{
+    CombatSoA v = combat_view(w->combat, lo, hi);
+    combat_armor_mitigation(&v, p->dmg_inout + lo);
+}
+
+static void run_combat_morale_decay(RUN_ARGS)
+{
+    CombatSoA v = combat_view(w->combat, lo, hi);
+    combat_morale_decay(&v, p->dt);
+}
+
+static void run_combat_rout_check(RUN_ARGS)
+{
+    CombatSoA v = combat_view(w->combat, lo, hi);
+    combat_rout_check(&v, p->rout_flags + lo);
+}
+
+static void run_combat_hp_regen(RUN_ARGS)
+{
+    CombatSoA v = combat_view(w->combat, lo, hi);
+    combat_hp_regen(&v, p->hp_regen_rate, p->dt);
+}
+
+static void run_econ_gather(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_gather(&v, p->dt);
+}
+
+static void run_econ_deplete(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_deplete(&v, p->dt);
+}
+
+static void run_econ_market_price(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    (void)p;
+    econ_market_price(&v);
+}
+
+static void run_econ_collect_tax(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_collect_tax(&v, p->tax_population + lo);
+}
+
+static void run_econ_resource_cap(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    (void)p;
+    econ_resource_cap(&v);
+}
+
+static void run_econ_demand_update(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_demand_update(&v, p->population_delta);
+}
+
+static void run_econ_inflation(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_inflation(&v, p->inflation_rate, p->dt);
+}
+
+static void run_econ_scarcity_penalty(RUN_ARGS)
+{
+    EconSoA v = econ_view(w->econ, lo, hi);
+    econ_scarcity_penalty(&v, p->scarcity_mult + lo);
+}
+
+static void run_env_temperature_diffuse(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_temperature_diffuse(&v, p->temp_diffuse_rate, p->dt);
+}
+
+static void run_env_rainfall_update(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_rainfall_update(&v, p->dt);
+}
+
+static void run_env_fire_spread(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_fire_spread(&v, p->fire_spread_prob, p->dt);
+}
+
+static void run_env_fire_consume(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_fire_consume(&v, p->dt);
+}
+
+static void run_env_humidity_evaporate(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_humidity_evaporate(&v, p->dt);
+}
+
+static void run_env_wind_advect(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_wind_advect(&v, p->dt);
+}
+
+static void run_env_pressure_gradient(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    (void)p;
+    env_pressure_gradient(&v);
+}
+
+static void run_env_elevation_temp_bias(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    (void)p;
+    env_elevation_temp_bias(&v);
+}
+
+static void run_env_drought_check(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_drought_check(&v, p->drought_threshold, p->drought_flags + lo);
+}
+
+static void run_env_flood_check(RUN_ARGS)
+{
+    EnvSoA v = env_view(w->env, lo, hi);
+    env_flood_check(&v, p->flood_threshold, p->flood_flags + lo);
+}
+
+static void run_move_velocity_verlet(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    move_velocity_verlet(&v, p->dt);
+}
+
+static void run_move_grid_build(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    if (p->flock_skin > 0.0f)
+        move_grid_update(p->move_grid, &v, p->flock_radius, p->flock_skin);
+    else
+        move_grid_build(p->move_grid, &v, p->flock_radius);
+}
+
+static void run_move_flock_separation(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    move_flock_separation(&v, p->move_grid, p->flock_radius, p->separation_strength);
+}
+
+static void run_move_flock_alignment(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    move_flock_alignment(&v, p->move_grid, p->flock_radius, p->alignment_strength);
+}
+
+static void run_move_flock_cohesion(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    move_flock_cohesion(&v, p->move_grid, p->flock_radius, p->cohesion_strength);
+}
+
+static void run_move_clamp_speed(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    (void)p;
+    move_clamp_speed(&v);
+}
+
+static void run_move_heading_update(RUN_ARGS)
+{
+    MoveSoA v = move_view(w->move, lo, hi);
+    (void)p;
+    move_heading_update(&v);
+}
+
+static void run_divine_energy_regen(RUN_ARGS)
+{
+    DivineSoA v = divine_view(w->divine, lo, hi);
+    FaithSoA faith = faith_view(w->faith, lo, INT_MAX);
+    divine_energy_regen(&v, &faith, p->dt);
+}
+
+static void run_divine_heal_decay(RUN_ARGS)
+{
+    DivineSoA v = divine_view(w->divine, lo, hi);
+    divine_heal_decay(&v, p->dt);
+}
+
+static void run_divine_cooldown_tick(RUN_ARGS)
+{
+    DivineSoA v = divine_view(w->divine, lo, hi);
+    divine_cooldown_tick(&v, p->dt);
+}
+
+static void run_divine_energy_cap(RUN_ARGS)
+{
+    DivineSoA v = divine_view(w->divine, lo, hi);
+    (void)p;
+    divine_energy_cap(&v);
+}
+
+static void run_divine_favor_scale(RUN_ARGS)
+{
+    DivineSoA v = divine_view(w->divine, lo, hi);
+    FaithSoA faith = faith_view(w->faith, lo, INT_MAX);
+    (void)p;
+    divine_favor_scale(&v, &faith);
+}
+
+static void run_psych_utility_evaluate(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    (void)p;
+    psych_utility_evaluate(&v);
+}
+
+static void run_psych_fear_decay(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    psych_fear_decay(&v, p->dt);
+}
+
+static void run_psych_happiness_update(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    EconSoA econ = econ_view(w->econ, lo, INT_MAX);
+    (void)p;
+    psych_happiness_update(&v, &econ);
+}
+
+static void run_psych_social_bond_update(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    psych_social_bond_update(&v, p->dt);
+}
+
+static void run_psych_memory_fade(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    psych_memory_fade(&v, p->dt);
+}
+
+static void run_psych_morale_from_psych(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    CombatSoA combat = combat_view(w->combat, lo, INT_MAX);
+    (void)p;
+    psych_morale_from_psych(&v, &combat);
+}
+
+static void run_psych_defection_check(RUN_ARGS)
+{
+    PsychSoA v = psych_view(w->psych, lo, hi);
+    psych_defection_check(&v, p->defect_flags + lo);
+}
+
+static void run_tech_research_tick(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    PopSoA pop = pop_view(w->pop, lo, INT_MAX);
+    tech_research_tick(&v, &pop, p->dt);
+}
+
+static void run_tech_cost_scale(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    (void)p;
+    tech_cost_scale(&v);
+}
+
+static void run_tech_unlock_check(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    tech_unlock_check(&v, p->unlock_flags + lo);
+}
+
+static void run_tech_golden_age_tick(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    tech_golden_age_tick(&v, p->dt);
+}
+
+static void run_tech_culture_spread(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    tech_culture_spread(&v, p->dt);
+}
+
+static void run_tech_era_advance(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    (void)p;
+    tech_era_advance(&v);
+}
+
+static void run_tech_pop_research_bonus(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    PopSoA pop = pop_view(w->pop, lo, INT_MAX);
+    (void)p;
+    tech_pop_research_bonus(&v, &pop);
+}
+
+static void run_tech_decay(RUN_ARGS)
+{
+    TechSoA v = tech_view(w->tech, lo, hi);
+    tech_decay(&v, p->dt);
+}
+
+static void run_engine_fast_inv_sqrt(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    (void)p;
+    engine_fast_inv_sqrt(&v);
+}
+
+static void run_engine_entropy_increase(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    engine_entropy_increase(&v, p->dt);
+}
+
+static void run_engine_stability_update(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    TechSoA tech = tech_view(w->tech, lo, INT_MAX);
+    PopSoA pop = pop_view(w->pop, lo, INT_MAX);
+    (void)p;
+    engine_stability_update(&v, &tech, &pop);
+}
+
+static void run_engine_spatial_grid_assign(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    MoveSoA move = move_view(w->move, lo, INT_MAX);
+    engine_spatial_grid_assign(&v, &move, p->grid_cell);
+}
+
+static void run_engine_end_timer_tick(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    engine_end_timer_tick(&v, p->dt);
+}
+
+static void run_engine_victory_pts_update(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    PopSoA pop = pop_view(w->pop, lo, INT_MAX);
+    TechSoA tech = tech_view(w->tech, lo, INT_MAX);
+    (void)p;
+    engine_victory_pts_update(&v, &pop, &tech);
+}
+
+static void run_engine_end_condition_check(RUN_ARGS)
+{
+    EngineSoA v = engine_view(w->engine, lo, hi);
+    engine_end_condition_check(&v, p->end_flags + lo);
+}
+
+/* ======================================================================
+   REGISTRY
+   ====================================================================== */
+typedef enum {
+    SOA_POP, SOA_FAITH, SOA_COMBAT, SOA_ECON, SOA_ENV,
+    SOA_MOVE, SOA_DIVINE, SOA_PSYCH, SOA_TECH, SOA_ENGINE
+} SoaId;
+
+/* SPLIT only if element i depends on nothing but element i of each array:
+   the flocking kernels read every mover, and faith_miracle_check seeds
+   its roll with the index, which a range view would renumber. */
+enum { WHOLE = 0, SPLIT = 1 };
+
+typedef struct {
+    const char *name;
+    void      (*run)(RUN_ARGS);
+    SoaId       soa;              /* SoA whose count the kernel sweeps */
+    int         split;
+    short       reads[MAX_FIELDS];
+    short       writes[MAX_FIELDS];
+} KernelDef;
+
+static const KernelDef REGISTRY[] = {
+    { "pop_logistic_growth", run_pop_logistic_growth, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_GROWTH_RATE, SF_END },
+      { SF_POP_POPULATION, SF_END } },
+    { "pop_sir_step", run_pop_sir_step, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_SUSCEPTIBLE, SF_POP_INFECTED, SF_POP_RECOVERED,
+        SF_POP_BETA, SF_POP_GAMMA_REC, SF_END },
+      { SF_POP_SUSCEPTIBLE, SF_POP_INFECTED, SF_POP_RECOVERED, SF_END } },
+    { "pop_starvation", run_pop_starvation, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_FOOD_SUPPLY,
+        SF_POP_FOOD_THRESHOLD, SF_END },
+      { SF_POP_POPULATION, SF_END } },
+    { "pop_age_cohort_shift", run_pop_age_cohort_shift, SOA_POP, SPLIT,
+      { SF_POP_AGE_YOUNG, SF_POP_AGE_ADULT, SF_POP_AGE_ELDER, SF_END },
+      { SF_POP_AGE_YOUNG, SF_POP_AGE_ADULT, SF_POP_AGE_ELDER, SF_END } },
+    { "pop_birth_rate", run_pop_birth_rate, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_AGE_YOUNG, SF_POP_AGE_ADULT,
+        SF_END },
+      { SF_POP_POPULATION, SF_POP_AGE_YOUNG, SF_END } },
+    { "pop_death_rate", run_pop_death_rate, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_AGE_ELDER, SF_END },
+      { SF_POP_POPULATION, SF_END } },
+    { "pop_carrying_cap_pressure", run_pop_carrying_cap_pressure, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_END },
+      { SF_POP_POPULATION, SF_POP_FOOD_THRESHOLD, SF_END } },
+    { "pop_epidemic_mortality", run_pop_epidemic_mortality, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_INFECTED, SF_END },
+      { SF_POP_POPULATION, SF_END } },
+    { "pop_recovery_bonus", run_pop_recovery_bonus, SOA_POP, SPLIT,
+      { SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_RECOVERED, SF_END },
+      { SF_POP_POPULATION, SF_END } },
+    { "faith_generate", run_faith_generate, SOA_FAITH, SPLIT,
+      { SF_FAITH_FAITH_LEVEL, SF_FAITH_DEVOTEE_COUNT, SF_FAITH_TEMPLE_COUNT, SF_END
+        },
+      { SF_FAITH_FAITH_LEVEL, SF_END } },
+    { "faith_mana_regen", run_faith_mana_regen, SOA_FAITH, SPLIT,
+      { SF_FAITH_MANA, SF_FAITH_MANA_REGEN, SF_FAITH_DIVINE_FAVOR, SF_END },
+      { SF_FAITH_MANA, SF_END } },
+    { "faith_heresy_spread", run_faith_heresy_spread, SOA_FAITH, SPLIT,
+      { SF_FAITH_FAITH_LEVEL, SF_FAITH_HERESY_RATE, SF_END },
+      { SF_FAITH_FAITH_LEVEL, SF_END } },
+    { "faith_miracle_check", run_faith_miracle_check, SOA_FAITH, WHOLE,
+      { SF_FAITH_MIRACLE_CHANCE, SF_FAITH_DIVINE_FAVOR, SF_END },
+      { SF_OUT_MIRACLE, SF_END } },
+    { "faith_conversion_tick", run_faith_conversion_tick, SOA_FAITH, SPLIT,
+      { SF_FAITH_FAITH_LEVEL, SF_FAITH_DEVOTEE_COUNT, SF_FAITH_CONVERSION_RATE,
+        SF_END },
+      { SF_FAITH_DEVOTEE_COUNT, SF_END } },
+    { "faith_schism_accumulate", run_faith_schism_accumulate, SOA_FAITH, SPLIT,
+      { SF_FAITH_FAITH_LEVEL, SF_FAITH_SCHISM_RISK, SF_END },
+      { SF_FAITH_SCHISM_RISK, SF_END } },
+    { "faith_divine_favor_update", run_faith_divine_favor_update, SOA_FAITH, SPLIT,
+      { SF_FAITH_DIVINE_FAVOR, SF_END },
+      { SF_FAITH_DIVINE_FAVOR, SF_END } },
+    { "faith_temple_bonus", run_faith_temple_bonus, SOA_FAITH, SPLIT,
+      { SF_FAITH_TEMPLE_COUNT, SF_END },
+      { SF_FAITH_MIRACLE_CHANCE, SF_END } },
+    { "faith_devotee_update", run_faith_devotee_update, SOA_FAITH, SPLIT,
+      { SF_FAITH_FAITH_LEVEL, SF_FAITH_DEVOTEE_COUNT, SF_END },
+      { SF_FAITH_DEVOTEE_COUNT, SF_END } },
+    { "combat_armor_mitigation", run_combat_armor_mitigation, SOA_COMBAT, SPLIT,
+      { SF_COMBAT_ARMOR, SF_IO_DMG, SF_END },
+      { SF_IO_DMG, SF_END } },
+    { "combat_morale_decay", run_combat_morale_decay, SOA_COMBAT, SPLIT,
+      { SF_COMBAT_MORALE, SF_COMBAT_MORALE_DECAY, SF_END },
+      { SF_COMBAT_MORALE, SF_END } },
+    { "combat_rout_check", run_combat_rout_check, SOA_COMBAT, SPLIT,
+      { SF_COMBAT_MORALE, SF_COMBAT_ROUT_THRESHOLD, SF_END },
+      { SF_OUT_ROUT, SF_END } },
+    { "combat_hp_regen", run_combat_hp_regen, SOA_COMBAT, SPLIT,
+      { SF_COMBAT_HP, SF_COMBAT_MAX_HP, SF_END },
+      { SF_COMBAT_HP, SF_END } },
+    { "econ_gather", run_econ_gather, SOA_ECON, SPLIT,
+      { SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_ECON_GATHER_RATE, SF_END },
+      { SF_ECON_RESOURCE, SF_END } },
+    { "econ_deplete", run_econ_deplete, SOA_ECON, SPLIT,
+      { SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_ECON_DEPLETION_RATE, SF_END },
+      { SF_ECON_RESOURCE, SF_ECON_SUPPLY, SF_END } },
+    { "econ_market_price", run_econ_market_price, SOA_ECON, SPLIT,
+      { SF_ECON_PRICE, SF_ECON_DEMAND, SF_ECON_SUPPLY, SF_END },
+      { SF_ECON_PRICE, SF_END } },
+    { "econ_collect_tax", run_econ_collect_tax, SOA_ECON, SPLIT,
+      { SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_ECON_TAX_RATE,
+        SF_ECON_TAX_COLLECTED, SF_IN_TAX_POP, SF_END },
+      { SF_ECON_RESOURCE, SF_ECON_TAX_COLLECTED, SF_END } },
+    { "econ_resource_cap", run_econ_resource_cap, SOA_ECON, SPLIT,
+      { SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_END },
+      { SF_ECON_RESOURCE, SF_END } },
+    { "econ_demand_update", run_econ_demand_update, SOA_ECON, SPLIT,
+      { SF_ECON_DEMAND, SF_END },
+      { SF_ECON_DEMAND, SF_END } },
+    { "econ_inflation", run_econ_inflation, SOA_ECON, SPLIT,
+      { SF_ECON_PRICE, SF_END },
+      { SF_ECON_PRICE, SF_END } },
+    { "econ_scarcity_penalty", run_econ_scarcity_penalty, SOA_ECON, SPLIT,
+      { SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_END },
+      { SF_OUT_SCARCITY, SF_END } },
+    { "env_temperature_diffuse", run_env_temperature_diffuse, SOA_ENV, SPLIT,
+      { SF_ENV_TEMPERATURE, SF_ENV_TEMP_TARGET, SF_END },
+      { SF_ENV_TEMPERATURE, SF_END } },
+    { "env_rainfall_update", run_env_rainfall_update, SOA_ENV, SPLIT,
+      { SF_ENV_RAINFALL, SF_ENV_HUMIDITY, SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_END },
+      { SF_ENV_RAINFALL, SF_END } },
+    { "env_fire_spread", run_env_fire_spread, SOA_ENV, SPLIT,
+      { SF_ENV_FIRE_INTENSITY, SF_ENV_FUEL, SF_END },
+      { SF_ENV_FIRE_INTENSITY, SF_END } },
+    { "env_fire_consume", run_env_fire_consume, SOA_ENV, SPLIT,
+      { SF_ENV_FIRE_INTENSITY, SF_ENV_FUEL, SF_END },
+      { SF_ENV_FIRE_INTENSITY, SF_ENV_FUEL, SF_END } },
+    { "env_humidity_evaporate", run_env_humidity_evaporate, SOA_ENV, SPLIT,
+      { SF_ENV_TEMPERATURE, SF_ENV_HUMIDITY, SF_END },
+      { SF_ENV_HUMIDITY, SF_END } },
+    { "env_wind_advect", run_env_wind_advect, SOA_ENV, SPLIT,
+      { SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_END },
+      { SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_END } },
+    { "env_pressure_gradient", run_env_pressure_gradient, SOA_ENV, SPLIT,
+      { SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_ENV_PRESSURE, SF_END },
+      { SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_END } },
+    { "env_elevation_temp_bias", run_env_elevation_temp_bias, SOA_ENV, SPLIT,
+      { SF_ENV_TEMP_TARGET, SF_ENV_ELEVATION, SF_END },
+      { SF_ENV_TEMP_TARGET, SF_END } },
+    { "env_drought_check", run_env_drought_check, SOA_ENV, SPLIT,
+      { SF_ENV_RAINFALL, SF_END },
+      { SF_OUT_DROUGHT, SF_END } },
+    { "env_flood_check", run_env_flood_check, SOA_ENV, SPLIT,
+      { SF_ENV_RAINFALL, SF_END },
+      { SF_OUT_FLOOD, SF_END } },
+    { "move_velocity_verlet", run_move_velocity_verlet, SOA_MOVE, SPLIT,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_MOVE_ACC_X,
+        SF_MOVE_ACC_Y, SF_END },
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_END } },
+    { "move_grid_build", run_move_grid_build, SOA_MOVE, WHOLE,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_END },
+      { SF_MOVE_GRID, SF_END } },
+    /* The flocking kernels keep their neighbour lists in the grid's scratch,
+       so they count as writing it. */
+    { "move_flock_separation", run_move_flock_separation, SOA_MOVE, WHOLE,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_GRID,
+        SF_END },
+      { SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_GRID, SF_END } },
+    { "move_flock_alignment", run_move_flock_alignment, SOA_MOVE, WHOLE,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_MOVE_ACC_X,
+        SF_MOVE_ACC_Y, SF_MOVE_GRID, SF_END },
+      { SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_GRID, SF_END } },
+    { "move_flock_cohesion", run_move_flock_cohesion, SOA_MOVE, WHOLE,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_GRID,
+        SF_END },
+      { SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_GRID, SF_END } },
+    { "move_clamp_speed", run_move_clamp_speed, SOA_MOVE, SPLIT,
+      { SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_MOVE_MAX_SPEED, SF_END },
+      { SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_MOVE_SPEED, SF_END } },
+    { "move_heading_update", run_move_heading_update, SOA_MOVE, SPLIT,
+      { SF_MOVE_VEL_X, SF_MOVE_VEL_Y, SF_MOVE_SPEED, SF_END },
+      { SF_MOVE_HEADING, SF_END } },
+    { "divine_energy_regen", run_divine_energy_regen, SOA_DIVINE, SPLIT,
+      { SF_DIVINE_ENERGY, SF_DIVINE_ENERGY_CAP, SF_DIVINE_REGEN_RATE,
+        SF_FAITH_DIVINE_FAVOR, SF_END },
+      { SF_DIVINE_ENERGY, SF_END } },
+    { "divine_heal_decay", run_divine_heal_decay, SOA_DIVINE, SPLIT,
+      { SF_DIVINE_ENERGY_CAP, SF_DIVINE_HEAL_AMOUNT, SF_DIVINE_HEAL_DECAY, SF_END },
+      { SF_DIVINE_HEAL_AMOUNT, SF_END } },
+    { "divine_cooldown_tick", run_divine_cooldown_tick, SOA_DIVINE, SPLIT,
+      { SF_DIVINE_COOLDOWN, SF_END },
+      { SF_DIVINE_COOLDOWN, SF_END } },
+    { "divine_energy_cap", run_divine_energy_cap, SOA_DIVINE, SPLIT,
+      { SF_DIVINE_ENERGY, SF_DIVINE_ENERGY_CAP, SF_END },
+      { SF_DIVINE_ENERGY, SF_END } },
+    { "divine_favor_scale", run_divine_favor_scale, SOA_DIVINE, SPLIT,
+      { SF_DIVINE_REGEN_RATE, SF_FAITH_DIVINE_FAVOR, SF_END },
+      { SF_DIVINE_REGEN_RATE, SF_END } },
+    { "psych_utility_evaluate", run_psych_utility_evaluate, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_AGGRESSION, SF_PSYCH_UTILITY_WORK, SF_PSYCH_UTILITY_FIGHT,
+        SF_PSYCH_UTILITY_FLEE, SF_END },
+      { SF_PSYCH_AGGRESSION, SF_END } },
+    { "psych_fear_decay", run_psych_fear_decay, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_FEAR, SF_PSYCH_MEMORY_DECAY, SF_END },
+      { SF_PSYCH_FEAR, SF_END } },
+    { "psych_happiness_update", run_psych_happiness_update, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_HAPPINESS, SF_PSYCH_FEAR, SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE,
+        SF_END },
+      { SF_PSYCH_HAPPINESS, SF_END } },
+    { "psych_social_bond_update", run_psych_social_bond_update, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_LOYALTY, SF_PSYCH_SOCIAL_BOND, SF_END },
+      { SF_PSYCH_SOCIAL_BOND, SF_END } },
+    { "psych_memory_fade", run_psych_memory_fade, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_FEAR, SF_PSYCH_AGGRESSION, SF_PSYCH_THREAT_LEVEL,
+        SF_PSYCH_MEMORY_DECAY, SF_END },
+      { SF_PSYCH_FEAR, SF_PSYCH_AGGRESSION, SF_PSYCH_THREAT_LEVEL, SF_END } },
+    { "psych_morale_from_psych", run_psych_morale_from_psych, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_HAPPINESS, SF_PSYCH_FEAR, SF_PSYCH_LOYALTY, SF_END },
+      { SF_COMBAT_MORALE, SF_END } },
+    { "psych_defection_check", run_psych_defection_check, SOA_PSYCH, SPLIT,
+      { SF_PSYCH_LOYALTY, SF_END },
+      { SF_OUT_DEFECT, SF_END } },
+    { "tech_research_tick", run_tech_research_tick, SOA_TECH, SPLIT,
+      { SF_TECH_RESEARCH_PTS, SF_TECH_RESEARCH_RATE, SF_TECH_GOLDEN_AGE_MULT,
+        SF_TECH_GOLDEN_AGE_TIMER, SF_TECH_POP_BONUS, SF_END },
+      { SF_TECH_RESEARCH_PTS, SF_END } },
+    { "tech_cost_scale", run_tech_cost_scale, SOA_TECH, SPLIT,
+      { SF_TECH_TECH_LEVEL, SF_END },
+      { SF_TECH_TECH_COST, SF_END } },
+    { "tech_unlock_check", run_tech_unlock_check, SOA_TECH, SPLIT,
+      { SF_TECH_RESEARCH_PTS, SF_TECH_TECH_COST, SF_TECH_TECH_LEVEL, SF_END },
+      { SF_TECH_RESEARCH_PTS, SF_TECH_TECH_LEVEL, SF_OUT_UNLOCK, SF_END } },
+    { "tech_golden_age_tick", run_tech_golden_age_tick, SOA_TECH, SPLIT,
+      { SF_TECH_GOLDEN_AGE_TIMER, SF_END },
+      { SF_TECH_GOLDEN_AGE_TIMER, SF_END } },
+    { "tech_culture_spread", run_tech_culture_spread, SOA_TECH, SPLIT,
+      { SF_TECH_CULTURE, SF_TECH_CULTURE_SPREAD, SF_END },
+      { SF_TECH_CULTURE, SF_END } },
+    { "tech_era_advance", run_tech_era_advance, SOA_TECH, SPLIT,
+      { SF_TECH_TECH_LEVEL, SF_TECH_ERA, SF_END },
+      { SF_TECH_ERA, SF_END } },
+    { "tech_pop_research_bonus", run_tech_pop_research_bonus, SOA_TECH, SPLIT,
+      { SF_POP_POPULATION, SF_END },
+      { SF_TECH_POP_BONUS, SF_END } },
+    { "tech_decay", run_tech_decay, SOA_TECH, SPLIT,
+      { SF_TECH_RESEARCH_PTS, SF_TECH_TECH_LEVEL, SF_END },
+      { SF_TECH_TECH_LEVEL, SF_END } },
+    { "engine_fast_inv_sqrt", run_engine_fast_inv_sqrt, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_INV_SQRT_VAL, SF_END },
+      { SF_ENGINE_INV_SQRT_OUT, SF_END } },
+    { "engine_entropy_increase", run_engine_entropy_increase, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_ENTROPY, SF_ENGINE_ENTROPY_RATE, SF_ENGINE_CHAOS_MULT, SF_END },
+      { SF_ENGINE_ENTROPY, SF_END } },
+    { "engine_stability_update", run_engine_stability_update, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_ENTROPY, SF_TECH_TECH_LEVEL, SF_POP_POPULATION,
+        SF_POP_CARRYING_CAP, SF_END },
+      { SF_ENGINE_STABILITY, SF_END } },
+    { "engine_spatial_grid_assign", run_engine_spatial_grid_assign, SOA_ENGINE, SPLIT,
+      { SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_END },
+      { SF_ENGINE_GRID_X, SF_ENGINE_GRID_Y, SF_END } },
+    { "engine_end_timer_tick", run_engine_end_timer_tick, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_STABILITY, SF_ENGINE_END_TIMER, SF_END },
+      { SF_ENGINE_END_TIMER, SF_END } },
+    { "engine_victory_pts_update", run_engine_victory_pts_update, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_VICTORY_PTS, SF_POP_POPULATION, SF_TECH_TECH_LEVEL, SF_END },
+      { SF_ENGINE_VICTORY_PTS, SF_END } },
+    { "engine_end_condition_check", run_engine_end_condition_check, SOA_ENGINE, SPLIT,
+      { SF_ENGINE_END_TIMER, SF_END },
+      { SF_OUT_END, SF_END } },
+};
+
+#define NKERNELS ((int)(sizeof(REGISTRY) / sizeof(REGISTRY[0])))
+
+static SimKernelInfo info[NKERNELS];
+static int           info_ready = 0;
+
+static void set_add(SimFieldSet *s, int f)
+{
+    s->bits[f >> 6] |= (uint64_t)1 << (f & 63);
+}
+
+static int set_has(const SimFieldSet *s, int f)
+{
+    return (int)((s->bits[f >> 6] >> (f & 63)) & 1u);
+}
+
+static void info_init(void)
+{
+    if (info_ready) return;
+    for (int k = 0; k < NKERNELS; k++) {
+        const KernelDef *d = &REGISTRY[k];
+        memset(&info[k], 0, sizeof(info[k]));
+        info[k].name  = d->name;
+        info[k].split = d->split;
+        for (int i = 0; d->reads[i] != SF_END; i++)  set_add(&info[k].reads,  d->reads[i]);
+        for (int i = 0; d->writes[i] != SF_END; i++) set_add(&info[k].writes, d->writes[i]);
+    }
+    info_ready = 1;
+}
+
+int sim_kernel_count(void)
+{
+    return NKERNELS;
+}
+
+const SimKernelInfo *sim_kernel_info(int k)
+{
+    if (k < 0 || k >= NKERNELS) return NULL;
+    info_init();
+    return &info[k];
+}
+
+int sim_kernel_find(const char *name)
+{
+    for (int k = 0; k < NKERNELS; k++)
+        if (strcmp(REGISTRY[k].name, name) == 0) return k;
+    return -1;
+}
+
+/* Elements kernel k sweeps in this world. */
+static int kernel_count(const SimWorld *w, int k)
+{
+    switch (REGISTRY[k].soa) {
+        case SOA_POP:    return w->pop->count;
+        case SOA_FAITH:  return w->faith->count;
+        case SOA_COMBAT: return w->combat->count;
+        case SOA_ECON:   return w->econ->count;
+        case SOA_ENV:    return w->env->count;
+        case SOA_MOVE:   return w->move->count;
+        case SOA_DIVINE: return w->divine->count;
+        case SOA_PSYCH:  return w->psych->count;
+        case SOA_TECH:   return w->tech->count;
+        case SOA_ENGINE: return w->engine->count;
+    }
+    return 0;
+}
+
+/* Whether every caller-owned buffer kernel k touches was supplied. */
+static int buffers_ready(const SimParams *p, int k)
+{
+    const SimKernelInfo *ki = sim_kernel_info(k);
+    for (int f = SF_OUT_MIRACLE; f < SF_COUNT; f++) {
+        if (!set_has(&ki->reads, f) && !set_has(&ki->writes, f)) continue;
+        const void *buf = NULL;
+        switch ((SimField)f) {
+            case SF_OUT_MIRACLE:  buf = p->miracle_out;    break;
+            case SF_OUT_ROUT:     buf = p->rout_flags;     break;
+            case SF_OUT_DROUGHT:  buf = p->drought_flags;  break;
+            case SF_OUT_FLOOD:    buf = p->flood_flags;    break;
+            case SF_OUT_DEFECT:   buf = p->defect_flags;   break;
+            case SF_OUT_UNLOCK:   buf = p->unlock_flags;   break;
+            case SF_OUT_END:      buf = p->end_flags;      break;
+            case SF_OUT_SCARCITY: buf = p->scarcity_mult;  break;
+            case SF_IO_DMG:       buf = p->dmg_inout;      break;
+            case SF_IN_TAX_POP:   buf = p->tax_population; break;
+            case SF_MOVE_GRID:
+                /* Only the builder needs it; the flocking kernels, which
+                   read it, fall back to testing every pair. */
+                if (set_has(&ki->reads, f)) continue;
+                buf = p->move_grid;
+                break;
+            default:                                       break;
+        }
+        if (!buf) return 0;
+    }
+    return 1;
+}
+
+/* ======================================================================
+   SCHEDULER
+   ====================================================================== */
+typedef struct {
+    int kernel;
+    int lo, hi;
+} RangeTask;
+
+/* Scratch for one run, grown as needed and kept between ticks */
+static const SimWorld  *cur_world;
+static const SimParams *cur_params;
+static RangeTask *tasks;
+static JobTask   *job_tasks;
+static int        task_cap, job_cap;
+static int       *succ;
+static int        succ_cap;
+
+/* Kernel-level graph, indexed by position in the run's kernel list */
+static int  *kdeps;               /* n*n adjacency: kdeps[b*n + a] = b after a */
+static int   kdeps_cap;
+static int  *klist;               /* the kernels that run, in order */
+static int  *kfirst;              /* first task of each, and one past the last */
+static int  *kntask;
+static int  *kreaders;            /* SF_COUNT*n: readers of each field since its last write */
+static int   klist_cap, kfirst_cap, kntask_cap, kreaders_cap;
+
+static void *grow(void *ptr, int *capacity, int need, size_t elem)
+{
+    if (need <= *capacity) return ptr;
+    int n = *capacity ? *capacity : 256;
+    while (n < need) n *= 2;
+    void *q = realloc(ptr, (size_t)n * elem);
+    if (!q) {
+        fprintf(stderr, "sim_schedule: out of memory for a %d-entry graph\n", need);
+        exit(1);
+    }
+    *capacity = n;
+    return q;
+}
+
+static void run_task(void *ctx, int t)
+{
+    (void)ctx;
+    const RangeTask *rt = &tasks[t];
+    REGISTRY[rt->kernel].run(cur_world, cur_params, rt->lo, rt->hi);
+}
+
+/* Fill kdeps for list[0..n): the earlier kernels each one must wait for. */
+static void build_kernel_edges(const int *list, int n)
+{
+    int  last_writer[SF_COUNT];
+    int  nreaders[SF_COUNT];
+    int *readers = kreaders;          /* field f's list at readers[f*n] */
+    for (int f = 0; f < SF_COUNT; f++) { last_writer[f] = -1; nreaders[f] = 0; }
+    memset(kdeps, 0, (size_t)n * (size_t)n * sizeof(*kdeps));
+
+    for (int b = 0; b < n; b++) {
+        const KernelDef *d = &REGISTRY[list[b]];
+        for (int i = 0; d->reads[i] != SF_END; i++) {
+            int f = d->reads[i];
+            if (last_writer[f] >= 0) kdeps[b * n + last_writer[f]] = 1;
+        }
+        for (int i = 0; d->writes[i] != SF_END; i++) {
+            int f = d->writes[i];
+            if (last_writer[f] >= 0) kdeps[b * n + last_writer[f]] = 1;
+            for (int r = 0; r < nreaders[f]; r++)
+                if (readers[f * n + r] != b) kdeps[b * n + readers[f * n + r]] = 1;
+        }
+        for (int i = 0; d->writes[i] != SF_END; i++) {
+            last_writer[d->writes[i]] = b;
+            nreaders[d->writes[i]]    = 0;
+        }
+        for (int i = 0; d->reads[i] != SF_END; i++) {
+            int f = d->reads[i];
+            if (nreaders[f] == 0 || readers[f * n + nreaders[f] - 1] != b)
+                readers[f * n + nreaders[f]++] = b;
+        }
+    }
+}
+
+/* Whether task range r of kernel b needs range s of earlier kernel a. */
+static int range_edge(int a, int s, int b, int r, const int *list)
+{
+    if (REGISTRY[list[a]].split && REGISTRY[list[b]].split) return s == r;
+    return 1;
+}
+
+void sim_schedule_run(const SimWorld *w, const SimParams *p, const int *kernels, int n)
+{
+    klist = grow(klist, &klist_cap, n > 0 ? n : 1, sizeof(*klist));
+    int *list = klist;
+    int  nk   = 0;
+    for (int i = 0; i < n; i++)
+        if (kernels[i] >= 0 && kernels[i] < NKERNELS && buffers_ready(p, kernels[i]))
+            list[nk++] = kernels[i];
+
+    if (jobs_threads() == 1) {
+        for (int i = 0; i < nk; i++)
+            REGISTRY[list[i]].run(w, p, 0, INT_MAX);
+        return;
+    }
+
+    /* Tasks: aligned SCHED_GRAIN ranges for element-wise kernels */
+    kfirst   = grow(kfirst, &kfirst_cap, nk + 1, sizeof(*kfirst));
+    kntask   = grow(kntask, &kntask_cap, nk > 0 ? nk : 1, sizeof(*kntask));
+    kreaders = grow(kreaders, &kreaders_cap, SF_COUNT * (nk > 0 ? nk : 1), sizeof(*kreaders));
+    int ntasks = 0;
+    for (int b = 0; b < nk; b++) {
+        int count = kernel_count(w, list[b]);
+        kfirst[b] = ntasks;
+        kntask[b] = REGISTRY[list[b]].split && count > SCHED_GRAIN
+                    ? (count + SCHED_GRAIN - 1) / SCHED_GRAIN : 1;
+        ntasks += kntask[b];
+    }
+    kfirst[nk] = ntasks;
+    tasks     = grow(tasks, &task_cap, ntasks, sizeof(*tasks));
+    job_tasks = grow(job_tasks, &job_cap, ntasks, sizeof(*job_tasks));
+    for (int b = 0; b < nk; b++)
+        for (int r = 0; r < kntask[b]; r++) {
+            RangeTask *rt = &tasks[kfirst[b] + r];
+            rt->kernel = list[b];
+            rt->lo     = kntask[b] == 1 ? 0 : r * SCHED_GRAIN;
+            rt->hi     = kntask[b] == 1 ? INT_MAX : (r + 1) * SCHED_GRAIN;
+        }
+
+    kdeps = grow(kdeps, &kdeps_cap, nk * nk, sizeof(*kdeps));
+    build_kernel_edges(list, nk);
+
+    /* Task edges, as successor lists in one array */
+    for (int t = 0; t < ntasks; t++) {
+        job_tasks[t].npred = 0;
+        job_tasks[t].nsucc = 0;
+    }
+    int nedges = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        int at = 0;
+        for (int a = 0; a < nk; a++)
+            for (int s = 0; s < kntask[a]; s++) {
+                int from = kfirst[a] + s;
+                if (pass == 1) job_tasks[from].succ = succ + at;
+                for (int b = a + 1; b < nk; b++) {
+                    if (!kdeps[b * nk + a]) continue;
+                    for (int r = 0; r < kntask[b]; r++) {
+                        if (!range_edge(a, s, b, r, list)) continue;
+                        if (pass == 0) { nedges++; continue; }
+                        succ[at++] = kfirst[b] + r;
+                        job_tasks[from].nsucc++;
+                        job_tasks[kfirst[b] + r].npred++;
+                    }
+                }
+            }
+        if (pass == 0) succ = grow(succ, &succ_cap, nedges > 0 ? nedges : 1, sizeof(*succ));
+    }
+
+    cur_world  = w;
+    cur_params = p;
+    jobs_run_graph(ntasks, job_tasks, run_task, NULL);
+}
+
+void sim_schedule_tick(const SimWorld *w, const SimParams *p)
+{
+    int all[NKERNELS];
+    for (int k = 0; k < NKERNELS; k++) all[k] = k;
+    sim_schedule_run(w, p, all, NKERNELS);
+}
@@ -0,0 +1,168 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * sim_schedule.h — Kernel registry and per-tick scheduler for simulation.c
+ *
+ * Every batch kernel (one that sweeps a whole SoA each tick) is registered
+ * with the fields it reads and writes.  A tick is a list of kernels in
+ * program order; the scheduler links two kernels whenever one writes a
+ * field the other touches, splits element-wise kernels into index ranges,
+ * and runs the resulting task graph on the jobs.c pool.  The result is
+ * bit-identical to calling the same kernels one after another.
+ *
+ * Single-index and event kernels (pop_migration, combat_apply_damage,
+ * divine_smite, ...) take arguments that only the caller knows at the
+ * moment of the event, so they are not registered; call them directly
+ * between ticks.
+ */
+
+#ifndef SIM_SCHEDULE_H
+#define SIM_SCHEDULE_H
+
+#include <stdint.h>
+
+#include "simulation.h"
+
+/* ======================================================================
+   FIELDS — one bit per SoA array, plus the caller-owned buffers
+   ====================================================================== */
+typedef enum {
+    /* 1. PopSoA */
+    SF_POP_POPULATION, SF_POP_CARRYING_CAP, SF_POP_GROWTH_RATE,
+    SF_POP_SUSCEPTIBLE, SF_POP_INFECTED, SF_POP_RECOVERED, SF_POP_BETA,
+    SF_POP_GAMMA_REC, SF_POP_FOOD_SUPPLY, SF_POP_FOOD_THRESHOLD,
+    SF_POP_AGE_YOUNG, SF_POP_AGE_ADULT, SF_POP_AGE_ELDER,
+    /* 2. FaithSoA */
+    SF_FAITH_FAITH_LEVEL, SF_FAITH_MANA, SF_FAITH_MANA_REGEN,
+    SF_FAITH_HERESY_RATE, SF_FAITH_MIRACLE_CHANCE, SF_FAITH_DEVOTEE_COUNT,
+    SF_FAITH_TEMPLE_COUNT, SF_FAITH_SCHISM_RISK, SF_FAITH_CONVERSION_RATE,
+    SF_FAITH_DIVINE_FAVOR,
+    /* 3. CombatSoA */
+    SF_COMBAT_BASE_ATK, SF_COMBAT_ARMOR, SF_COMBAT_HP, SF_COMBAT_MAX_HP,
+    SF_COMBAT_MORALE, SF_COMBAT_MORALE_DECAY, SF_COMBAT_HIT_CHANCE,
+    SF_COMBAT_CRIT_CHANCE, SF_COMBAT_CRIT_MULT, SF_COMBAT_ROUT_THRESHOLD,
+    /* 4. EconSoA */
+    SF_ECON_RESOURCE, SF_ECON_MAX_RESOURCE, SF_ECON_GATHER_RATE,
+    SF_ECON_DEPLETION_RATE, SF_ECON_PRICE, SF_ECON_DEMAND, SF_ECON_SUPPLY,
+    SF_ECON_TAX_RATE, SF_ECON_TAX_COLLECTED, SF_ECON_TRADE_VOLUME,
+    /* 5. EnvSoA */
+    SF_ENV_TEMPERATURE, SF_ENV_TEMP_TARGET, SF_ENV_RAINFALL, SF_ENV_HUMIDITY,
+    SF_ENV_WIND_X, SF_ENV_WIND_Y, SF_ENV_FIRE_INTENSITY, SF_ENV_FUEL,
+    SF_ENV_ELEVATION, SF_ENV_PRESSURE,
+    /* 6. MoveSoA */
+    SF_MOVE_POS_X, SF_MOVE_POS_Y, SF_MOVE_VEL_X, SF_MOVE_VEL_Y,
+    SF_MOVE_ACC_X, SF_MOVE_ACC_Y, SF_MOVE_HEADING, SF_MOVE_SPEED,
+    SF_MOVE_MAX_SPEED, SF_MOVE_H_COST,
+    /* 7. DivineSoA */
+    SF_DIVINE_ENERGY, SF_DIVINE_ENERGY_CAP, SF_DIVINE_REGEN_RATE,
+    SF_DIVINE_METEOR_COST, SF_DIVINE_HEAL_AMOUNT, SF_DIVINE_HEAL_DECAY,
+    SF_DIVINE_TERRAFORM_COST, SF_DIVINE_SMITE_POWER, SF_DIVINE_BLESSING_MULT,
+    SF_DIVINE_COOLDOWN,
+    /* 8. PsychSoA */
+    SF_PSYCH_HAPPINESS, SF_PSYCH_FEAR, SF_PSYCH_LOYALTY, SF_PSYCH_AGGRESSION,
+    SF_PSYCH_UTILITY_WORK, SF_PSYCH_UTILITY_FIGHT, SF_PSYCH_UTILITY_FLEE,
+    SF_PSYCH_THREAT_LEVEL, SF_PSYCH_MEMORY_DECAY, SF_PSYCH_SOCIAL_BOND,
+    /* 9. TechSoA */
+    SF_TECH_RESEARCH_PTS, SF_TECH_RESEARCH_RATE, SF_TECH_TECH_COST,
+    SF_TECH_TECH_LEVEL, SF_TECH_GOLDEN_AGE_MULT, SF_TECH_GOLDEN_AGE_TIMER,
+    SF_TECH_CULTURE, SF_TECH_CULTURE_SPREAD, SF_TECH_ERA, SF_TECH_POP_BONUS,
+    /* 10. EngineSoA */
+    SF_ENGINE_ENTROPY, SF_ENGINE_ENTROPY_RATE, SF_ENGINE_GRID_X,
+    SF_ENGINE_GRID_Y, SF_ENGINE_INV_SQRT_VAL, SF_ENGINE_INV_SQRT_OUT,
+    SF_ENGINE_STABILITY, SF_ENGINE_END_TIMER, SF_ENGINE_VICTORY_PTS,
+    SF_ENGINE_CHAOS_MULT, SF_ENGINE_RNG_STATE,
+    /* Caller-owned buffers in SimParams */
+    SF_OUT_MIRACLE, SF_OUT_ROUT, SF_OUT_DROUGHT, SF_OUT_FLOOD, SF_OUT_DEFECT,
+    SF_OUT_UNLOCK, SF_OUT_END, SF_OUT_SCARCITY, SF_IO_DMG, SF_IN_TAX_POP,
+    SF_MOVE_GRID,
+    SF_COUNT
+} SimField;
+
+/* Set of SimField bits. */
+typedef struct {
+    uint64_t bits[2];
+} SimFieldSet;
+
+/* ======================================================================
+   TICK INPUTS
+   ====================================================================== */
+/* The ten SoAs a tick runs over.  Element i of every SoA is assumed to
+   describe the same thing (kernels that mix SoAs pair them by index). */
+typedef struct {
+    PopSoA    *pop;
+    FaithSoA  *faith;
+    CombatSoA *combat;
+    EconSoA   *econ;
+    EnvSoA    *env;
+    MoveSoA   *move;
+    DivineSoA *divine;
+    PsychSoA  *psych;
+    TechSoA   *tech;
+    EngineSoA *engine;
+} SimWorld;
+
+/* Scalar arguments and caller-owned buffers of the registered kernels.
+   Buffers are indexed like the SoA the kernel sweeps; a kernel whose
+   buffer is NULL is skipped. */
+typedef struct {
+    float dt;
+    float epidemic_mortality;   /* pop_epidemic_mortality */
+    float piety_delta;          /* faith_divine_favor_update */
+    float hp_regen_rate;        /* combat_hp_regen */
+    float population_delta;     /* econ_demand_update */
+    float inflation_rate;       /* econ_inflation */
+    float temp_diffuse_rate;    /* env_temperature_diffuse */
+    float fire_spread_prob;     /* env_fire_spread */
+    float drought_threshold;    /* env_drought_check */
+    float flood_threshold;      /* env_flood_check */
+    float flock_radius;         /* move_flock_* */
+    float flock_skin;           /* > 0: Verlet lists (move_grid_update) */
+    float separation_strength;
+    float alignment_strength;
+    float cohesion_strength;
+    float grid_cell;            /* engine_spatial_grid_assign */
+
+    int         *miracle_out;   /* FaithSoA-sized */
+    int         *rout_flags;    /* CombatSoA-sized */
+    float       *dmg_inout;     /* CombatSoA-sized */
+    float       *scarcity_mult; /* EconSoA-sized */
+    const float *tax_population;/* EconSoA-sized */
+    int         *drought_flags; /* EnvSoA-sized */
+    int         *flood_flags;
+    int         *defect_flags;  /* PsychSoA-sized */
+    int         *unlock_flags;  /* TechSoA-sized */
+    int         *end_flags;     /* EngineSoA-sized */
+    MoveGrid    *move_grid;     /* rebuilt by move_grid_build each tick, or
+                                   when stale with flock_skin; if NULL,
+                                   move_flock_* test every pair */
+} SimParams;
+
+/* ======================================================================
+   REGISTRY & SCHEDULER
+   ====================================================================== */
+typedef struct {
+    const char  *name;
+    SimFieldSet  reads;
+    SimFieldSet  writes;
+    int          split;     /* element-wise: may run as index ranges */
+} SimKernelInfo;
+
+/* Number of registered kernels; ids run from 0 in registry order, which
+   follows the category order of simulation.h. */
+int                  sim_kernel_count(void);
+const SimKernelInfo *sim_kernel_info(int k);
+/* Id of the kernel with this function name, or -1. */
+int                  sim_kernel_find(const char *name);
+
+/* Run kernels[0..n) as if called in that order, skipping any whose
+   caller-owned buffer is NULL.  Independent kernels and the index ranges
+   of element-wise ones run concurrently on the jobs.c pool; with a single
+   thread they are simply called in order.  Not reentrant. */
+void sim_schedule_run(const SimWorld *w, const SimParams *p, const int *kernels, int n);
+
+/* One full tick: every registered kernel, in registry order. */
+void sim_schedule_tick(const SimWorld *w, const SimParams *p);
+
+#endif /* SIM_SCHEDULE_H */
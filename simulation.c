@@ -6,15 +6,20 @@
  * simulation.c — Batch-processing implementations for all 100 DOD formulas.
  *
  * Every function iterates over the SoA arrays in a tight loop for cache
- * locality.  All data lives in the caller-supplied SoA structs.
+ * locality.  All data lives in the caller-supplied SoA structs.  These
+ * loops are the reference: where simulation_simd.c has a vector path for
+ * the running CPU, the loop starts at SIMD_DONE(...), after the elements
+ * the vector pass already handled.
  * global_tick is the only global state; it is incremented each game tick
  * and XORed into LCG seeds so that roll results vary between ticks.
  */
 
 #include "simulation.h"
+#include "simulation_simd.h"
 
 #include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* Incremented each game tick by the caller; XORed into LCG seeds so that
@@ -25,9 +30,6 @@ uint32_t global_tick = 0u;
    INTERNAL HELPERS
    ====================================================================== */
 
-/* Maximum allowed market price — prevents multiplicative divergence to infinity. */
-#define MAX_PRICE 1000.0f
-
 /* Clamp a float to [lo, hi]. */
 static float clampf(float v, float lo, float hi)
 {
@@ -70,7 +72,7 @@ static float lcg_float(uint32_t *s)
  */
 void pop_logistic_growth(PopSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_logistic_growth, p, dt); i < p->count; i++) {
         float n = p->population[i];
         float k = p->carrying_cap[i];
         float r = p->growth_rate[i];
@@ -88,7 +90,7 @@ void pop_logistic_growth(PopSoA *p, float dt)
  */
 void pop_sir_step(PopSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_sir_step, p, dt); i < p->count; i++) {
         float n = p->population[i];
         if (n <= 0.0f) continue;
         float s = p->susceptible[i];
@@ -120,7 +122,7 @@ void pop_sir_step(PopSoA *p, float dt)
  */
 void pop_starvation(PopSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_starvation, p, dt); i < p->count; i++) {
         float deficit = p->food_threshold[i] - p->food_supply[i];
         if (deficit <= 0.0f) continue;
         float frac = deficit / p->food_threshold[i];
@@ -137,7 +139,7 @@ void pop_starvation(PopSoA *p, float dt)
 void pop_age_cohort_shift(PopSoA *p, float dt)
 {
     const float shift_rate = 0.002f; /* fraction per unit time */
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_age_cohort_shift, p, dt); i < p->count; i++) {
         float young = p->age_young[i];
         float adult = p->age_adult[i];
         float elder = p->age_elder[i];
@@ -158,7 +160,7 @@ void pop_age_cohort_shift(PopSoA *p, float dt)
 void pop_birth_rate(PopSoA *p, float dt)
 {
     const float birth_coeff = 0.03f;
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_birth_rate, p, dt); i < p->count; i++) {
         float births = birth_coeff * p->age_adult[i] * p->population[i] * dt;
         p->age_young[i]  = clampf(p->age_young[i] + births / (p->population[i] + 1.0f),
                                    0.0f, 1.0f);
@@ -174,7 +176,7 @@ void pop_death_rate(PopSoA *p, float dt)
 {
     const float base_death   = 0.01f;
     const float elder_excess = 0.04f;
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_death_rate, p, dt); i < p->count; i++) {
         float rate   = base_death + elder_excess * p->age_elder[i];
         float deaths = rate * p->population[i] * dt;
         p->population[i] = clampf(p->population[i] - deaths, 0.0f, p->carrying_cap[i]);
@@ -199,7 +201,7 @@ void pop_migration(PopSoA *src, PopSoA *dst, int idx, float rate, float dt)
  */
 void pop_carrying_cap_pressure(PopSoA *p)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_carrying_cap_pressure, p); i < p->count; i++) {
         if (p->population[i] > p->carrying_cap[i])
             p->population[i] = p->carrying_cap[i];
         p->food_threshold[i] = p->carrying_cap[i] * 0.1f;
@@ -211,7 +213,7 @@ void pop_carrying_cap_pressure(PopSoA *p)
  */
 void pop_epidemic_mortality(PopSoA *p, float mortality_rate, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_epidemic_mortality, p, mortality_rate, dt); i < p->count; i++) {
         float deaths = mortality_rate * p->infected[i] * p->population[i] * dt;
         p->population[i] = clampf(p->population[i] - deaths, 0.0f, p->carrying_cap[i]);
     }
@@ -224,12 +226,90 @@ void pop_epidemic_mortality(PopSoA *p, float mortality_rate, float dt)
 void pop_recovery_bonus(PopSoA *p, float dt)
 {
     const float bonus = 0.005f;
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(pop_recovery_bonus, p, dt); i < p->count; i++) {
         float gain = bonus * p->recovered[i] * p->population[i] * dt;
         p->population[i] = clampf(p->population[i] + gain, 0.0f, p->carrying_cap[i]);
     }
 }
 
+/*
+ * pop_tick — One pass of the population chain, fused:
+ *   pop_logistic_growth, pop_sir_step, pop_starvation, pop_age_cohort_shift,
+ *   pop_birth_rate, pop_death_rate, pop_epidemic_mortality, pop_recovery_bonus.
+ * Each element goes through the same arithmetic, in the same order, as the
+ * eight calls in sequence, so the result is identical; the arrays are just
+ * streamed once instead of eight times.
+ */
+void pop_tick(PopSoA *p, float mortality_rate, float dt)
+{
+    const float shift_rate   = 0.002f;  /* pop_age_cohort_shift */
+    const float birth_coeff  = 0.03f;   /* pop_birth_rate */
+    const float base_death   = 0.01f;   /* pop_death_rate */
+    const float elder_excess = 0.04f;
+    const float bonus        = 0.005f;  /* pop_recovery_bonus */
+    for (int i = SIMD_DONE(pop_tick, p, mortality_rate, dt); i < p->count; i++) {
+        float n     = p->population[i];
+        float k     = p->carrying_cap[i];
+        float s     = p->susceptible[i];
+        float inf   = p->infected[i];
+        float r     = p->recovered[i];
+        float young = p->age_young[i];
+        float adult = p->age_adult[i];
+        float elder = p->age_elder[i];
+
+        /* logistic growth */
+        float dn = p->growth_rate[i] * n * (1.0f - n / k);
+        n = clampf(n + dn * dt, 0.0f, k);
+
+        /* SIR, skipped like pop_sir_step's `continue` */
+        if (!(n <= 0.0f)) {
+            float new_inf = p->beta[i] * s * inf / n;
+            float new_rec = p->gamma_rec[i] * inf;
+            float s2   = s   - new_inf * dt;
+            float inf2 = inf + (new_inf - new_rec) * dt;
+            float r2   = r   + new_rec * dt;
+            float total = s2 + inf2 + r2;
+            if (total > 0.0f) {
+                s   = clampf(s2   / total, 0.0f, 1.0f);
+                inf = clampf(inf2 / total, 0.0f, 1.0f);
+                r   = clampf(r2   / total, 0.0f, 1.0f);
+            }
+        }
+
+        /* starvation */
+        float deficit = p->food_threshold[i] - p->food_supply[i];
+        if (!(deficit <= 0.0f)) {
+            float frac = deficit / p->food_threshold[i];
+            n = clampf(n - n * frac * 0.05f * dt, 0.0f, k);
+        }
+
+        /* age cohorts */
+        float ya = young * shift_rate * dt;
+        float ae = adult * shift_rate * dt;
+        young = clampf(young - ya,      0.0f, 1.0f);
+        adult = clampf(adult + ya - ae, 0.0f, 1.0f);
+        elder = clampf(elder + ae,      0.0f, 1.0f);
+
+        /* births */
+        float births = birth_coeff * adult * n * dt;
+        young = clampf(young + births / (n + 1.0f), 0.0f, 1.0f);
+        n     = clampf(n + births, 0.0f, k);
+
+        /* natural deaths, epidemic deaths, recovery bonus */
+        n = clampf(n - (base_death + elder_excess * elder) * n * dt, 0.0f, k);
+        n = clampf(n - mortality_rate * inf * n * dt, 0.0f, k);
+        n = clampf(n + bonus * r * n * dt, 0.0f, k);
+
+        p->population[i]  = n;
+        p->susceptible[i] = s;
+        p->infected[i]    = inf;
+        p->recovered[i]   = r;
+        p->age_young[i]   = young;
+        p->age_adult[i]   = adult;
+        p->age_elder[i]   = elder;
+    }
+}
+
 /* ======================================================================
    2. FAITH & RELIGION
    ====================================================================== */
@@ -240,7 +320,7 @@ void pop_recovery_bonus(PopSoA *p, float dt)
  */
 void faith_generate(FaithSoA *f, float dt)
 {
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_generate, f, dt); i < f->count; i++) {
         float gain = f->devotee_count[i] * (1.0f + f->temple_count[i] * 0.1f) * 0.001f * dt;
         f->faith_level[i] = clampf(f->faith_level[i] + gain, 0.0f, 1.0f);
     }
@@ -252,7 +332,7 @@ void faith_generate(FaithSoA *f, float dt)
  */
 void faith_mana_regen(FaithSoA *f, float dt)
 {
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_mana_regen, f, dt); i < f->count; i++) {
         float gain = f->mana_regen[i] * f->divine_favor[i] * dt;
         f->mana[i] = clampf(f->mana[i] + gain, 0.0f, 1000.0f);
     }
@@ -265,7 +345,7 @@ void faith_mana_regen(FaithSoA *f, float dt)
  */
 void faith_heresy_spread(FaithSoA *f, float dt)
 {
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_heresy_spread, f, dt); i < f->count; i++) {
         float heresy = 1.0f - f->faith_level[i];
         float d = f->heresy_rate[i] * (1.0f - f->faith_level[i]) * heresy * (1.0f - heresy);
         heresy = clampf(heresy + d * dt, 0.0f, 1.0f);
@@ -280,7 +360,7 @@ void faith_heresy_spread(FaithSoA *f, float dt)
  */
 void faith_miracle_check(FaithSoA *f, int *miracle_out)
 {
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_miracle_check, f, miracle_out); i < f->count; i++) {
         uint32_t seed = ((uint32_t)(i + 1) * 2654435761u) ^ global_tick;
         float roll = lcg_float(&seed);
         miracle_out[i] = (roll < f->miracle_chance[i] * f->divine_favor[i]) ? 1 : 0;
@@ -294,7 +374,7 @@ void faith_miracle_check(FaithSoA *f, int *miracle_out)
 void faith_conversion_tick(FaithSoA *f, float dt)
 {
     const float pop_cap = 1000.0f;
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_conversion_tick, f, dt); i < f->count; i++) {
         float target = pop_cap * f->faith_level[i];
         float delta  = f->conversion_rate[i] * (target - f->devotee_count[i]) * dt;
         f->devotee_count[i] = clampf(f->devotee_count[i] + delta, 0.0f, pop_cap);
@@ -307,7 +387,7 @@ void faith_conversion_tick(FaithSoA *f, float dt)
  */
 void faith_schism_accumulate(FaithSoA *f, float dt)
 {
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_schism_accumulate, f, dt); i < f->count; i++) {
         float rise = (1.0f - f->faith_level[i]) * 0.01f * dt;
         f->schism_risk[i] = clampf(f->schism_risk[i] + rise, 0.0f, 1.0f);
     }
@@ -318,7 +398,7 @@ void faith_schism_accumulate(FaithSoA *f, float dt)
  */
 void faith_divine_favor_update(FaithSoA *f, float piety_delta)
 {
-    for (int i = 0; i < f->count; i++)
+    for (int i = SIMD_DONE(faith_divine_favor_update, f, piety_delta); i < f->count; i++)
         f->divine_favor[i] = clampf(f->divine_favor[i] + piety_delta, 0.0f, 1.0f);
 }
 
@@ -329,7 +409,7 @@ void faith_divine_favor_update(FaithSoA *f, float piety_delta)
 void faith_temple_bonus(FaithSoA *f)
 {
     const float base_miracle = 0.01f;
-    for (int i = 0; i < f->count; i++)
+    for (int i = SIMD_DONE(faith_temple_bonus, f); i < f->count; i++)
         f->miracle_chance[i] = base_miracle * (1.0f + f->temple_count[i] * 0.05f);
 }
 
@@ -349,7 +429,7 @@ void faith_devotee_update(FaithSoA *f, float dt)
 {
     const float target_scale = 1000.0f;
     const float drift_rate   = 0.05f;
-    for (int i = 0; i < f->count; i++) {
+    for (int i = SIMD_DONE(faith_devotee_update, f, dt); i < f->count; i++) {
         float target = f->faith_level[i] * target_scale;
         f->devotee_count[i] += drift_rate * (target - f->devotee_count[i]) * dt;
         f->devotee_count[i]  = clampf(f->devotee_count[i], 0.0f, target_scale);
@@ -379,7 +459,7 @@ void combat_apply_damage(CombatSoA *c, int attacker, int defender, float raw_dmg
  */
 void combat_armor_mitigation(const CombatSoA *c, float *dmg_inout)
 {
-    for (int i = 0; i < c->count; i++) {
+    for (int i = SIMD_DONE(combat_armor_mitigation, c, dmg_inout); i < c->count; i++) {
         float mit = c->armor[i] / (c->armor[i] + 100.0f);
         dmg_inout[i] = dmg_inout[i] * (1.0f - mit);
     }
@@ -412,7 +492,7 @@ void combat_crit_roll(const CombatSoA *c, int attacker, float *dmg_mult_out)
  */
 void combat_morale_decay(CombatSoA *c, float dt)
 {
-    for (int i = 0; i < c->count; i++)
+    for (int i = SIMD_DONE(combat_morale_decay, c, dt); i < c->count; i++)
         c->morale[i] = clampf(c->morale[i] - c->morale_decay[i] * dt, 0.0f, 1.0f);
 }
 
@@ -430,7 +510,7 @@ void combat_morale_boost(CombatSoA *c, int unit, float amount)
  */
 void combat_rout_check(const CombatSoA *c, int *rout_flags)
 {
-    for (int i = 0; i < c->count; i++)
+    for (int i = SIMD_DONE(combat_rout_check, c, rout_flags); i < c->count; i++)
         rout_flags[i] = (c->morale[i] < c->rout_threshold[i]) ? 1 : 0;
 }
 
@@ -439,7 +519,7 @@ void combat_rout_check(const CombatSoA *c, int *rout_flags)
  */
 void combat_hp_regen(CombatSoA *c, float regen_rate, float dt)
 {
-    for (int i = 0; i < c->count; i++) {
+    for (int i = SIMD_DONE(combat_hp_regen, c, regen_rate, dt); i < c->count; i++) {
         float heal = regen_rate * c->max_hp[i] * dt;
         c->hp[i] = clampf(c->hp[i] + heal, 0.0f, c->max_hp[i]);
     }
@@ -447,22 +527,75 @@ void combat_hp_regen(CombatSoA *c, float regen_rate, float dt)
 
 /*
  * combat_aoe_damage — Deal dmg to every unit within radius of (cx, cy).
- *   Damage falls off linearly with distance.
+ *   falloff = 1 - dist / radius  (linear, minimum 1 damage)
  */
+static void aoe_hit(CombatSoA *c, const float *pos_x, const float *pos_y, int i,
+                    float cx, float cy, float r2, float radius, float dmg)
+{
+    float dx = pos_x[i] - cx;
+    float dy = pos_y[i] - cy;
+    float d2 = dx * dx + dy * dy;
+    if (d2 >= r2) return;
+    float falloff = 1.0f - sqrtf(d2) / radius;
+    float actual  = dmg * falloff;
+    if (actual < 1.0f) actual = 1.0f;
+    c->hp[i] = clampf(c->hp[i] - actual, 0.0f, c->max_hp[i]);
+}
+
+/* Cell index range [*lo, *hi] of [a, b] along an axis of n cells. */
+static int grid_span(double a, double b, double origin, double inv, int n, int *lo, int *hi)
+{
+    double l = floor((a - origin) * inv), h = floor((b - origin) * inv);
+    if (h < 0.0 || l > n - 1) return 0;
+    *lo = l < 0.0 ? 0 : (int)l;
+    *hi = h > n - 1 ? n - 1 : (int)h;
+    return 1;
+}
+
+/* Whether g indexes these n positions: built over the same arrays, and no
+   agent has left its cell since.  That means unmoved for a plain grid, and
+   within skin / 2 of where it was for one kept by move_grid_update. */
+static int grid_current(const MoveGrid *g, int n, const float *x, const float *y)
+{
+    if (!g || g->count < 0 || g->count != n || g->src_x != x || g->src_y != y) return 0;
+    float lim2 = g->reach > 0.0f ? 0.25f * g->skin * g->skin : 0.0f;
+    for (int i = 0; i < n; i++) {
+        float dx = x[i] - g->ref_x[i];
+        float dy = y[i] - g->ref_y[i];
+        if (dx * dx + dy * dy <= lim2) continue;
+        /* Non-finite then and now: still in the run every query visits */
+        if (!(isfinite(g->ref_x[i]) && isfinite(g->ref_y[i])) &&
+            !(isfinite(x[i]) && isfinite(y[i])))
+            continue;
+        return 0;
+    }
+    return 1;
+}
+
 void combat_aoe_damage(CombatSoA *c, const float *pos_x, const float *pos_y,
-                       float cx, float cy, float radius, float dmg)
+                       const MoveGrid *g, float cx, float cy, float radius, float dmg)
 {
     float r2 = radius * radius;
-    for (int i = 0; i < c->count; i++) {
-        float dx = pos_x[i] - cx;
-        float dy = pos_y[i] - cy;
-        float d2 = dx * dx + dy * dy;
-        if (d2 >= r2) continue;
-        float falloff = 1.0f - sqrtf(d2) / radius;
-        float actual  = dmg * falloff;
-        if (actual < 1.0f) actual = 1.0f;
-        c->hp[i] = clampf(c->hp[i] - actual, 0.0f, c->max_hp[i]);
-    }
+    if (isfinite(cx) && isfinite(cy) && isfinite(r2) &&
+        grid_current(g, c->count, pos_x, pos_y)) {
+        /* Each unit is independent, so cell order does not matter.  Cells
+           kept for Verlet lists are up to skin / 2 out of date. */
+        double reach = ((double)radius + (g->reach > 0.0f ? 0.5 * g->skin : 0.0)) *
+                       (1.0 + 1.0 / 1024.0);
+        int x0, x1, y0, y1;
+        if (grid_span(cx - reach, cx + reach, g->origin_x, g->inv_cell, g->cols, &x0, &x1) &&
+            grid_span(cy - reach, cy + reach, g->origin_y, g->inv_cell, g->rows, &y0, &y1))
+            for (int y = y0; y <= y1; y++)
+                for (int s = g->cell_start[y * g->cols + x0];
+                     s < g->cell_start[y * g->cols + x1 + 1]; s++)
+                    aoe_hit(c, pos_x, pos_y, g->order[s], cx, cy, r2, radius, dmg);
+        for (int s = g->cell_start[g->ncells]; s < g->cell_start[g->ncells + 1]; s++)
+            aoe_hit(c, pos_x, pos_y, g->order[s], cx, cy, r2, radius, dmg);
+        return;
+    }
+    for (int i = SIMD_DONE(combat_aoe_damage, c, pos_x, pos_y, cx, cy, radius, dmg);
+         i < c->count; i++)
+        aoe_hit(c, pos_x, pos_y, i, cx, cy, r2, radius, dmg);
 }
 
 /*
@@ -484,7 +617,7 @@ void combat_siege_damage(CombatSoA *c, int building, float siege_power, float dt
  */
 void econ_gather(EconSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_gather, e, dt); i < e->count; i++) {
         e->resource[i] = clampf(e->resource[i] + e->gather_rate[i] * dt,
                                  0.0f, e->max_resource[i]);
     }
@@ -495,7 +628,7 @@ void econ_gather(EconSoA *e, float dt)
  */
 void econ_deplete(EconSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_deplete, e, dt); i < e->count; i++) {
         e->resource[i] = clampf(e->resource[i] - e->depletion_rate[i] * dt,
                                  0.0f, e->max_resource[i]);
         /* supply tracks current stockpile */
@@ -509,7 +642,7 @@ void econ_deplete(EconSoA *e, float dt)
  */
 void econ_market_price(EconSoA *e)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_market_price, e); i < e->count; i++) {
         float sup = e->supply[i] > 1.0f ? e->supply[i] : 1.0f;
         float base = e->price[i] > 0.0f ? e->price[i] : 1.0f;
         e->price[i] = clampf(base * sqrtf(e->demand[i] / sup), 0.01f, MAX_PRICE);
@@ -521,7 +654,7 @@ void econ_market_price(EconSoA *e)
  */
 void econ_collect_tax(EconSoA *e, const float *population)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_collect_tax, e, population); i < e->count; i++) {
         float tax = e->resource[i] * e->tax_rate[i] * population[i] * 0.001f;
         e->tax_collected[i] += tax;
         e->resource[i]       = clampf(e->resource[i] - tax, 0.0f, e->max_resource[i]);
@@ -550,7 +683,7 @@ void econ_trade(EconSoA *seller, int si, EconSoA *buyer, int bi, float amount)
  */
 void econ_resource_cap(EconSoA *e)
 {
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(econ_resource_cap, e); i < e->count; i++)
         e->resource[i] = clampf(e->resource[i], 0.0f, e->max_resource[i]);
 }
 
@@ -560,7 +693,7 @@ void econ_resource_cap(EconSoA *e)
  */
 void econ_demand_update(EconSoA *e, float population_delta)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_demand_update, e, population_delta); i < e->count; i++) {
         e->demand[i] = clampf(e->demand[i] + 0.01f * population_delta, 0.0f, 1e9f);
     }
 }
@@ -571,7 +704,7 @@ void econ_demand_update(EconSoA *e, float population_delta)
 void econ_supply_shock(EconSoA *e, float shock_factor)
 {
     float keep = clampf(1.0f - shock_factor, 0.0f, 1.0f);
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_supply_shock, e, keep); i < e->count; i++) {
         e->resource[i] *= keep;
         e->supply[i]    = e->resource[i];
     }
@@ -583,7 +716,7 @@ void econ_supply_shock(EconSoA *e, float shock_factor)
 void econ_inflation(EconSoA *e, float inflation_rate, float dt)
 {
     float factor = 1.0f + inflation_rate * dt;
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(econ_inflation, e, factor); i < e->count; i++)
         e->price[i] = clampf(e->price[i] * factor, 0.01f, 1e6f);
 }
 
@@ -593,7 +726,7 @@ void econ_inflation(EconSoA *e, float inflation_rate, float dt)
  */
 void econ_scarcity_penalty(const EconSoA *e, float *output_mult)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(econ_scarcity_penalty, e, output_mult); i < e->count; i++) {
         float cap = e->max_resource[i] > 0.0f ? e->max_resource[i] : 1.0f;
         output_mult[i] = clampf(e->resource[i] / cap, 0.0f, 1.0f);
     }
@@ -609,7 +742,7 @@ void econ_scarcity_penalty(const EconSoA *e, float *output_mult)
  */
 void env_temperature_diffuse(EnvSoA *e, float rate, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_temperature_diffuse, e, rate, dt); i < e->count; i++) {
         float diff = e->temp_target[i] - e->temperature[i];
         e->temperature[i] += rate * diff * dt;
     }
@@ -621,7 +754,7 @@ void env_temperature_diffuse(EnvSoA *e, float rate, float dt)
  */
 void env_rainfall_update(EnvSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_rainfall_update, e, dt); i < e->count; i++) {
         float wind_mag = sqrtf(e->wind_x[i] * e->wind_x[i] +
                                 e->wind_y[i] * e->wind_y[i]);
         float target_rain = e->humidity[i] * wind_mag * 0.5f;
@@ -636,7 +769,7 @@ void env_rainfall_update(EnvSoA *e, float dt)
  */
 void env_fire_spread(EnvSoA *e, float spread_prob, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_fire_spread, e, spread_prob, dt); i < e->count; i++) {
         if (e->fire_intensity[i] <= 0.0f) continue;
         float spread = spread_prob * e->fuel[i] * e->fire_intensity[i] * dt;
         e->fire_intensity[i] = clampf(e->fire_intensity[i] + spread, 0.0f, 1.0f);
@@ -652,7 +785,7 @@ void env_fire_consume(EnvSoA *e, float dt)
 {
     const float consume_rate  = 0.1f;
     const float decay_rate    = 0.01f; /* fixed intensity loss per unit time while fuel remains */
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_fire_consume, e, dt); i < e->count; i++) {
         if (e->fire_intensity[i] <= 0.0f) continue;
         float burned = consume_rate * e->fire_intensity[i] * dt;
         e->fuel[i] = clampf(e->fuel[i] - burned, 0.0f, 1.0f);
@@ -670,7 +803,7 @@ void env_fire_consume(EnvSoA *e, float dt)
  */
 void env_humidity_evaporate(EnvSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_humidity_evaporate, e, dt); i < e->count; i++) {
         float loss = e->temperature[i] * 0.001f * dt;
         e->humidity[i] = clampf(e->humidity[i] - loss, 0.0f, 1.0f);
     }
@@ -683,7 +816,7 @@ void env_humidity_evaporate(EnvSoA *e, float dt)
 void env_wind_advect(EnvSoA *e, float dt)
 {
     const float dampen = 0.99f;
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_wind_advect, e); i < e->count; i++) {
         e->wind_x[i] *= dampen;
         e->wind_y[i] *= dampen;
         /* Keep wind bounded */
@@ -698,7 +831,7 @@ void env_wind_advect(EnvSoA *e, float dt)
 void env_pressure_gradient(EnvSoA *e)
 {
     const float base_pressure = 1013.25f;
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(env_pressure_gradient, e); i < e->count; i++) {
         float excess = (e->pressure[i] - base_pressure) * 0.01f;
         e->wind_x[i] += excess;
         e->wind_y[i] += excess;
@@ -712,7 +845,7 @@ void env_pressure_gradient(EnvSoA *e)
 void env_elevation_temp_bias(EnvSoA *e)
 {
     const float lapse = 0.5f;
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(env_elevation_temp_bias, e); i < e->count; i++)
         e->temp_target[i] -= e->elevation[i] * lapse;
 }
 
@@ -721,7 +854,7 @@ void env_elevation_temp_bias(EnvSoA *e)
  */
 void env_drought_check(const EnvSoA *e, float threshold, int *drought_flags)
 {
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(env_drought_check, e, threshold, drought_flags); i < e->count; i++)
         drought_flags[i] = (e->rainfall[i] < threshold) ? 1 : 0;
 }
 
@@ -730,7 +863,7 @@ void env_drought_check(const EnvSoA *e, float threshold, int *drought_flags)
  */
 void env_flood_check(const EnvSoA *e, float threshold, int *flood_flags)
 {
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(env_flood_check, e, threshold, flood_flags); i < e->count; i++)
         flood_flags[i] = (e->rainfall[i] > threshold) ? 1 : 0;
 }
 
@@ -746,7 +879,7 @@ void env_flood_check(const EnvSoA *e, float threshold, int *flood_flags)
 void move_velocity_verlet(MoveSoA *m, float dt)
 {
     float dt2_half = 0.5f * dt * dt;
-    for (int i = 0; i < m->count; i++) {
+    for (int i = SIMD_DONE(move_velocity_verlet, m, dt, dt2_half); i < m->count; i++) {
         m->pos_x[i] += m->vel_x[i] * dt + m->acc_x[i] * dt2_half;
         m->pos_y[i] += m->vel_y[i] * dt + m->acc_y[i] * dt2_half;
         m->vel_x[i] += m->acc_x[i] * dt;
@@ -754,14 +887,277 @@ void move_velocity_verlet(MoveSoA *m, float dt)
     }
 }
 
+/*
+ * move_grid_build — Counting-sort the agents of m into square cells.
+ *   The edge is cell_size padded by 1/1024, so that rounding in a kernel's
+ *   distance test can never accept a pair more than one cell apart; it is
+ *   doubled while the bounding box would need more than 2 * count + 64
+ *   cells, which keeps far-flung agents from blowing up the cell table.
+ */
+int move_grid_build(MoveGrid *g, const MoveSoA *m, float cell_size)
+{
+    int n = m->count > 0 ? m->count : 0;
+    g->count = -1;
+    g->reach = 0.0f;
+
+    double lo_x = 0.0, lo_y = 0.0, hi_x = 0.0, hi_y = 0.0;
+    int    any  = 0;
+    for (int i = 0; i < n; i++) {
+        float x = m->pos_x[i], y = m->pos_y[i];
+        if (!isfinite(x) || !isfinite(y)) continue;
+        if (!any || x < lo_x) lo_x = x;
+        if (!any || x > hi_x) hi_x = x;
+        if (!any || y < lo_y) lo_y = y;
+        if (!any || y > hi_y) hi_y = y;
+        any = 1;
+    }
+
+    double edge = cell_size > 0.0f && isfinite(cell_size) ? (double)cell_size : 1.0;
+    double pad  = 1.0 + 1.0 / 1024.0;
+    double max_cells = 2.0 * n + 64.0;
+    while ((floor((hi_x - lo_x) / (edge * pad)) + 1.0) *
+           (floor((hi_y - lo_y) / (edge * pad)) + 1.0) > max_cells)
+        edge *= 2.0;
+    int cols = (int)floor((hi_x - lo_x) / (edge * pad)) + 1;
+    int rows = (int)floor((hi_y - lo_y) / (edge * pad)) + 1;
+    int ncells = cols * rows;
+
+    if (n > g->agent_cap) {
+        int *order   = realloc(g->order,   (size_t)n * sizeof(int));
+        if (order)   g->order = order;
+        int *cell    = realloc(g->cell,    (size_t)n * sizeof(int));
+        if (cell)    g->cell = cell;
+        int *scratch = realloc(g->scratch, (size_t)n * 2 * sizeof(int));
+        if (scratch) g->scratch = scratch;
+        float *rx    = realloc(g->ref_x,   (size_t)n * sizeof(float));
+        if (rx)      g->ref_x = rx;
+        float *ry    = realloc(g->ref_y,   (size_t)n * sizeof(float));
+        if (ry)      g->ref_y = ry;
+        if (!order || !cell || !scratch || !rx || !ry) return -1;
+        g->agent_cap = n;
+    }
+    if (ncells + 2 > g->cell_cap) {
+        int *start = realloc(g->cell_start, (size_t)(ncells + 2) * sizeof(int));
+        if (!start) return -1;
+        g->cell_start = start;
+        g->cell_cap   = ncells + 2;
+    }
+
+    g->origin_x  = lo_x;
+    g->origin_y  = lo_y;
+    g->inv_cell  = 1.0 / (edge * pad);
+    g->cell_size = (float)edge;
+    g->cols      = cols;
+    g->rows      = rows;
+    g->ncells    = ncells;
+
+    /* Count, prefix-sum, then place in index order so each cell is sorted */
+    int *start = g->cell_start;
+    memset(start, 0, (size_t)(ncells + 2) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        float x = m->pos_x[i], y = m->pos_y[i];
+        int c = ncells;
+        if (isfinite(x) && isfinite(y)) {
+            int cx = (int)(((double)x - lo_x) * g->inv_cell);
+            int cy = (int)(((double)y - lo_y) * g->inv_cell);
+            if (cx > cols - 1) cx = cols - 1;
+            if (cy > rows - 1) cy = rows - 1;
+            c = cy * cols + cx;
+        }
+        g->cell[i] = c;
+        start[c + 1]++;
+    }
+    for (int c = 0; c <= ncells; c++) start[c + 1] += start[c];
+    for (int i = 0; i < n; i++) g->order[start[g->cell[i]]++] = i;
+    for (int c = ncells; c > 0; c--) start[c] = start[c - 1];
+    start[0] = 0;
+
+    if (n > 0) {
+        memcpy(g->ref_x, m->pos_x, (size_t)n * sizeof(float));
+        memcpy(g->ref_y, m->pos_y, (size_t)n * sizeof(float));
+    }
+    g->src_x = m->pos_x;
+    g->src_y = m->pos_y;
+    g->count = n;
+    return 0;
+}
+
+void move_grid_free(MoveGrid *g)
+{
+    free(g->cell_start);
+    free(g->order);
+    free(g->cell);
+    free(g->scratch);
+    free(g->nbr_start);
+    free(g->nbr);
+    free(g->ref_x);
+    free(g->ref_y);
+    memset(g, 0, sizeof(*g));
+    g->count = -1;
+}
+
+/* Whether g indexes m closely enough to answer queries of this radius. */
+static int grid_usable(const MoveGrid *g, const MoveSoA *m, float radius)
+{
+    return g && radius <= (g->reach > 0.0f ? g->reach : g->cell_size) &&
+           isfinite(radius * radius) && grid_current(g, m->count, m->pos_x, m->pos_y);
+}
+
+/* Sort a[0..run[nruns]), made of ascending runs starting at run[0..nruns),
+   by merging neighbouring runs into b and back.  Returns the sorted copy. */
+static int *merge_runs(int *a, int *b, int *run, int nruns)
+{
+    while (nruns > 1) {
+        int k = 0;
+        for (int r = 0; r < nruns; r += 2) {
+            int lo = run[r], mid = run[r + 1], hi = r + 2 <= nruns ? run[r + 2] : mid;
+            int i = lo, j = mid, o = lo;
+            while (i < mid && j < hi) b[o++] = a[i] < a[j] ? a[i++] : a[j++];
+            while (i < mid) b[o++] = a[i++];
+            while (j < hi)  b[o++] = a[j++];
+            run[k++] = lo;
+        }
+        run[k] = run[nruns];
+        nruns  = k;
+        int *t = a; a = b; b = t;
+    }
+    return a;
+}
+
+/*
+ * Neighbours j != i of agent i that the all-pairs loop would not skip,
+ * i.e. with d2 <= r2 and not d2 < min_d2, in ascending j, so the kernels
+ * accumulate in the same order as the reference.  Returns how many; the
+ * list stays valid until the next call on g.
+ */
+static int grid_neighbours(MoveGrid *g, const MoveSoA *m, int i, float r2, float min_d2,
+                           const int **out)
+{
+    int *list = g->scratch, *tmp = g->scratch + g->count;
+    int  k    = 0;
+    float xi = m->pos_x[i], yi = m->pos_y[i];
+#define GRID_TAKE(j)                                         \
+    do {                                                     \
+        float dx = xi - m->pos_x[j];                         \
+        float dy = yi - m->pos_y[j];                         \
+        float d2 = dx * dx + dy * dy;                        \
+        if ((j) != i && !(d2 > r2 || d2 < min_d2)) list[k++] = (j); \
+    } while (0)
+
+    if (g->reach > 0.0f) {
+        /* Verlet list: already ascending */
+        for (int s = g->nbr_start[i]; s < g->nbr_start[i + 1]; s++) GRID_TAKE(g->nbr[s]);
+        *out = list;
+        return k;
+    }
+    if (g->cell[i] == g->ncells) {
+        /* Non-finite agent: no cell bounds its neighbours */
+        for (int j = 0; j < g->count; j++) GRID_TAKE(j);
+        *out = list;
+        return k;
+    }
+
+    int run[12], nruns = 0;     /* 3x3 cells plus the non-finite run */
+    int cx = g->cell[i] % g->cols, cy = g->cell[i] / g->cols;
+    int x0 = cx > 0 ? cx - 1 : 0, x1 = cx < g->cols - 1 ? cx + 1 : cx;
+    for (int y = cy > 0 ? cy - 1 : 0; y <= cy + 1 && y < g->rows; y++)
+        for (int c = y * g->cols + x0; c <= y * g->cols + x1; c++) {
+            int k0 = k;
+            for (int s = g->cell_start[c]; s < g->cell_start[c + 1]; s++) GRID_TAKE(g->order[s]);
+            if (k > k0) run[nruns++] = k0;
+        }
+    int k0 = k;
+    for (int s = g->cell_start[g->ncells]; s < g->cell_start[g->ncells + 1]; s++)
+        GRID_TAKE(g->order[s]);
+    if (k > k0) run[nruns++] = k0;
+    run[nruns] = k;
+#undef GRID_TAKE
+
+    *out = merge_runs(list, tmp, run, nruns);
+    return k;
+}
+
+/*
+ * move_grid_update — Rebuild the Verlet lists only once they may be stale.
+ *   A pair within reach now was within reach + skin at the last build as
+ *   long as neither agent has moved more than skin / 2; the list radius
+ *   carries the same 1/1024 padding as the cells against rounding.
+ */
+int move_grid_update(MoveGrid *g, const MoveSoA *m, float radius, float skin)
+{
+    int n = m->count > 0 ? m->count : 0;
+    if (!(skin > 0.0f) || !isfinite(skin)) skin = 0.0f;
+
+    if (g->reach > 0.0f && g->reach == radius && g->skin == skin &&
+        grid_current(g, n, m->pos_x, m->pos_y))
+        return 0;
+
+    float list_r = radius + skin;
+    if (!(radius > 0.0f) || !isfinite(list_r * list_r)) {
+        move_grid_build(g, m, radius);                  /* no lists; kernels fall back */
+        return -2;
+    }
+    if (move_grid_build(g, m, list_r) != 0) return -1;
+    g->count = -1;
+
+    int *start = realloc(g->nbr_start, (size_t)(n + 1) * sizeof(int));
+    if (!start) return -1;
+    g->nbr_start = start;
+    g->count     = n;
+
+    float pad  = list_r * (1.0f + 1.0f / 1024.0f);
+    int   used = 0, cap = g->nbr_cap;
+    for (int i = 0; i < n; i++) {
+        const int *nb;
+        int k = grid_neighbours(g, m, i, pad * pad, -1.0f, &nb);
+        if (used + k > cap) {
+            int  want = cap > 0 ? cap : 1024;
+            while (want < used + k) want *= 2;
+            int *grown = realloc(g->nbr, (size_t)want * sizeof(int));
+            if (!grown) {
+                g->count = -1;
+                return -1;
+            }
+            g->nbr = grown;
+            cap    = want;
+        }
+        g->nbr_start[i] = used;
+        memcpy(g->nbr + used, nb, (size_t)k * sizeof(int));
+        used += k;
+    }
+    g->nbr_start[n] = used;
+    g->nbr_cap      = cap;
+    g->reach = radius;
+    g->skin  = skin;
+    g->builds++;
+    return 1;
+}
+
 /*
  * move_flock_separation — Steer away from neighbours closer than radius.
  *   Accumulates repulsion forces into each agent's acceleration.
  */
-void move_flock_separation(MoveSoA *m, float radius, float strength)
+void move_flock_separation(MoveSoA *m, MoveGrid *g, float radius, float strength)
 {
     float r2 = radius * radius;
-    for (int i = 0; i < m->count; i++) {
+    if (grid_usable(g, m, radius)) {
+        for (int i = 0; i < m->count; i++) {
+            const int *nb;
+            int   k  = grid_neighbours(g, m, i, r2, 1e-6f, &nb);
+            float fx = 0.0f, fy = 0.0f;
+            for (int q = 0; q < k; q++) {
+                float dx = m->pos_x[i] - m->pos_x[nb[q]];
+                float dy = m->pos_y[i] - m->pos_y[nb[q]];
+                float inv_d = fast_inv_sqrt_scalar(dx * dx + dy * dy);
+                fx += dx * inv_d;
+                fy += dy * inv_d;
+            }
+            m->acc_x[i] += strength * fx;
+            m->acc_y[i] += strength * fy;
+        }
+        return;
+    }
+    for (int i = SIMD_DONE(move_flock_separation, m, radius, strength); i < m->count; i++) {
         float fx = 0.0f, fy = 0.0f;
         for (int j = 0; j < m->count; j++) {
             if (i == j) continue;
@@ -781,10 +1177,26 @@ void move_flock_separation(MoveSoA *m, float radius, float strength)
 /*
  * move_flock_alignment — Steer toward the average velocity of neighbours.
  */
-void move_flock_alignment(MoveSoA *m, float radius, float strength)
+void move_flock_alignment(MoveSoA *m, MoveGrid *g, float radius, float strength)
 {
     float r2 = radius * radius;
-    for (int i = 0; i < m->count; i++) {
+    if (grid_usable(g, m, radius)) {
+        for (int i = 0; i < m->count; i++) {
+            const int *nb;
+            int   n      = grid_neighbours(g, m, i, r2, -1.0f, &nb);
+            float avg_vx = 0.0f, avg_vy = 0.0f;
+            for (int q = 0; q < n; q++) {
+                avg_vx += m->vel_x[nb[q]];
+                avg_vy += m->vel_y[nb[q]];
+            }
+            if (n > 0) {
+                m->acc_x[i] += strength * (avg_vx / n - m->vel_x[i]);
+                m->acc_y[i] += strength * (avg_vy / n - m->vel_y[i]);
+            }
+        }
+        return;
+    }
+    for (int i = SIMD_DONE(move_flock_alignment, m, radius, strength); i < m->count; i++) {
         float avg_vx = 0.0f, avg_vy = 0.0f;
         int   n      = 0;
         for (int j = 0; j < m->count; j++) {
@@ -806,10 +1218,26 @@ void move_flock_alignment(MoveSoA *m, float radius, float strength)
 /*
  * move_flock_cohesion — Steer toward the centre of mass of neighbours.
  */
-void move_flock_cohesion(MoveSoA *m, float radius, float strength)
+void move_flock_cohesion(MoveSoA *m, MoveGrid *g, float radius, float strength)
 {
     float r2 = radius * radius;
-    for (int i = 0; i < m->count; i++) {
+    if (grid_usable(g, m, radius)) {
+        for (int i = 0; i < m->count; i++) {
+            const int *nb;
+            int   n  = grid_neighbours(g, m, i, r2, -1.0f, &nb);
+            float cx = 0.0f, cy = 0.0f;
+            for (int q = 0; q < n; q++) {
+                cx += m->pos_x[nb[q]];
+                cy += m->pos_y[nb[q]];
+            }
+            if (n > 0) {
+                m->acc_x[i] += strength * (cx / n - m->pos_x[i]);
+                m->acc_y[i] += strength * (cy / n - m->pos_y[i]);
+            }
+        }
+        return;
+    }
+    for (int i = SIMD_DONE(move_flock_cohesion, m, radius, strength); i < m->count; i++) {
         float cx = 0.0f, cy = 0.0f;
         int   n  = 0;
         for (int j = 0; j < m->count; j++) {
@@ -828,6 +1256,69 @@ void move_flock_cohesion(MoveSoA *m, float radius, float strength)
     }
 }
 
+/*
+ * move_flock_combined — Separation, alignment and cohesion in one pass.
+ *   Each term keeps its own radius and strength; one distance test per
+ *   pair feeds all three.  Same result as calling move_flock_separation,
+ *   move_flock_alignment and move_flock_cohesion in that order, since
+ *   none of them reads what the others write.
+ */
+void move_flock_combined(MoveSoA *m, MoveGrid *g, float sep_radius, float sep_strength,
+                         float ali_radius, float ali_strength,
+                         float coh_radius, float coh_strength)
+{
+    float r2s = sep_radius * sep_radius;
+    float r2a = ali_radius * ali_radius;
+    float r2c = coh_radius * coh_radius;
+    int   grid = grid_usable(g, m, sep_radius) && grid_usable(g, m, ali_radius) &&
+                 grid_usable(g, m, coh_radius);
+    float r2  = r2s > r2a ? r2s : r2a;
+    if (r2c > r2) r2 = r2c;
+
+    int i = grid ? 0 : SIMD_DONE(move_flock_combined, m, sep_radius, sep_strength,
+                                 ali_radius, ali_strength, coh_radius, coh_strength);
+    for (; i < m->count; i++) {
+        const int *nb = NULL;
+        int   k = grid ? grid_neighbours(g, m, i, r2, -1.0f, &nb) : m->count;
+        float fx = 0.0f, fy = 0.0f;                 /* separation */
+        float avg_vx = 0.0f, avg_vy = 0.0f;         /* alignment  */
+        float cx = 0.0f, cy = 0.0f;                 /* cohesion   */
+        int   na = 0, nc = 0;
+        for (int q = 0; q < k; q++) {
+            int j = nb ? nb[q] : q;
+            if (i == j) continue;
+            float dx = m->pos_x[i] - m->pos_x[j];
+            float dy = m->pos_y[i] - m->pos_y[j];
+            float d2 = dx * dx + dy * dy;
+            if (!(d2 > r2s || d2 < 1e-6f)) {
+                float inv_d = fast_inv_sqrt_scalar(d2);
+                fx += dx * inv_d;
+                fy += dy * inv_d;
+            }
+            if (!(d2 > r2a)) {
+                avg_vx += m->vel_x[j];
+                avg_vy += m->vel_y[j];
+                na++;
+            }
+            if (!(d2 > r2c)) {
+                cx += m->pos_x[j];
+                cy += m->pos_y[j];
+                nc++;
+            }
+        }
+        m->acc_x[i] += sep_strength * fx;
+        m->acc_y[i] += sep_strength * fy;
+        if (na > 0) {
+            m->acc_x[i] += ali_strength * (avg_vx / na - m->vel_x[i]);
+            m->acc_y[i] += ali_strength * (avg_vy / na - m->vel_y[i]);
+        }
+        if (nc > 0) {
+            m->acc_x[i] += coh_strength * (cx / nc - m->pos_x[i]);
+            m->acc_y[i] += coh_strength * (cy / nc - m->pos_y[i]);
+        }
+    }
+}
+
 /*
  * move_seek_target — Apply a steering force toward (tx, ty).
  */
@@ -868,7 +1359,7 @@ void move_astar_heuristic(MoveSoA *m, int unit, float gx, float gy)
  */
 void move_clamp_speed(MoveSoA *m)
 {
-    for (int i = 0; i < m->count; i++) {
+    for (int i = SIMD_DONE(move_clamp_speed, m); i < m->count; i++) {
         float spd2 = m->vel_x[i] * m->vel_x[i] + m->vel_y[i] * m->vel_y[i];
         float max2 = m->max_speed[i] * m->max_speed[i];
         if (spd2 > max2 && spd2 > 1e-9f) {
@@ -917,7 +1408,7 @@ void move_arrival_brake(MoveSoA *m, int unit, float tx, float ty, float slow_rad
  */
 void divine_energy_regen(DivineSoA *d, const FaithSoA *f, float dt)
 {
-    for (int i = 0; i < d->count; i++) {
+    for (int i = SIMD_DONE(divine_energy_regen, d, f, dt); i < d->count; i++) {
         float favor = (i < f->count) ? f->divine_favor[i] : 1.0f;
         float gain  = d->regen_rate[i] * favor * dt;
         d->energy[i] = clampf(d->energy[i] + gain, 0.0f, d->energy_cap[i]);
@@ -959,7 +1450,7 @@ void divine_heal_apply(DivineSoA *d, CombatSoA *c, int god, int target_unit)
  */
 void divine_heal_decay(DivineSoA *d, float dt)
 {
-    for (int i = 0; i < d->count; i++) {
+    for (int i = SIMD_DONE(divine_heal_decay, d, dt); i < d->count; i++) {
         float target = d->energy_cap[i] * 0.1f; /* heal scales with energy cap */
         float diff   = target - d->heal_amount[i];
         d->heal_amount[i] = clampf(d->heal_amount[i] + diff * d->heal_decay[i] * dt,
@@ -1016,7 +1507,7 @@ void divine_blessing(DivineSoA *d, CombatSoA *c, int god, int target)
  */
 void divine_cooldown_tick(DivineSoA *d, float dt)
 {
-    for (int i = 0; i < d->count; i++)
+    for (int i = SIMD_DONE(divine_cooldown_tick, d, dt); i < d->count; i++)
         d->cooldown[i] = clampf(d->cooldown[i] - dt, 0.0f, 1e6f);
 }
 
@@ -1025,7 +1516,7 @@ void divine_cooldown_tick(DivineSoA *d, float dt)
  */
 void divine_energy_cap(DivineSoA *d)
 {
-    for (int i = 0; i < d->count; i++)
+    for (int i = SIMD_DONE(divine_energy_cap, d); i < d->count; i++)
         d->energy[i] = clampf(d->energy[i], 0.0f, d->energy_cap[i]);
 }
 
@@ -1034,7 +1525,7 @@ void divine_energy_cap(DivineSoA *d)
  */
 void divine_favor_scale(DivineSoA *d, const FaithSoA *f)
 {
-    for (int i = 0; i < d->count; i++) {
+    for (int i = SIMD_DONE(divine_favor_scale, d, f); i < d->count; i++) {
         if (i >= f->count) break;
         d->regen_rate[i] *= (0.5f + 0.5f * f->divine_favor[i]);
     }
@@ -1051,7 +1542,7 @@ void divine_favor_scale(DivineSoA *d, const FaithSoA *f)
  */
 void psych_utility_evaluate(PsychSoA *p)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(psych_utility_evaluate, p); i < p->count; i++) {
         float uw = p->utility_work[i];
         float uf = p->utility_fight[i];
         float ul = p->utility_flee[i];
@@ -1094,7 +1585,7 @@ void psych_loyalty_shift(PsychSoA *p, int npc, float event_loyalty_delta)
  */
 void psych_fear_decay(PsychSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(psych_fear_decay, p, dt); i < p->count; i++) {
         float k = p->memory_decay[i] * dt;
         p->fear[i] = clampf(p->fear[i] * (1.0f - k), 0.0f, 1.0f);
     }
@@ -1106,7 +1597,7 @@ void psych_fear_decay(PsychSoA *p, float dt)
  */
 void psych_happiness_update(PsychSoA *p, const EconSoA *e)
 {
-    for (int i = 0; i < p->count && i < e->count; i++) {
+    for (int i = SIMD_DONE(psych_happiness_update, p, e); i < p->count && i < e->count; i++) {
         float cap   = e->max_resource[i] > 0.0f ? e->max_resource[i] : 1.0f;
         float ratio = clampf(e->resource[i] / cap, 0.0f, 1.0f);
         float happy = 0.5f * (1.0f + ratio - p->fear[i]);
@@ -1130,7 +1621,7 @@ void psych_aggression_trigger(PsychSoA *p, int npc, float provocation)
  */
 void psych_social_bond_update(PsychSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(psych_social_bond_update, p, dt); i < p->count; i++) {
         float delta = (p->loyalty[i] - 0.5f) * 0.01f * dt;
         p->social_bond[i] = clampf(p->social_bond[i] + delta, 0.0f, 1.0f);
     }
@@ -1142,7 +1633,7 @@ void psych_social_bond_update(PsychSoA *p, float dt)
  */
 void psych_memory_fade(PsychSoA *p, float dt)
 {
-    for (int i = 0; i < p->count; i++) {
+    for (int i = SIMD_DONE(psych_memory_fade, p, dt); i < p->count; i++) {
         float k = p->memory_decay[i] * dt;
         p->fear[i]        = clampf(p->fear[i]        * (1.0f - k), 0.0f, 1.0f);
         p->aggression[i]  = clampf(p->aggression[i]  * (1.0f - k), 0.0f, 1.0f);
@@ -1157,7 +1648,7 @@ void psych_memory_fade(PsychSoA *p, float dt)
 void psych_morale_from_psych(const PsychSoA *p, CombatSoA *c)
 {
     int n = p->count < c->count ? p->count : c->count;
-    for (int i = 0; i < n; i++) {
+    for (int i = SIMD_DONE(psych_morale_from_psych, p, c); i < n; i++) {
         c->morale[i] = clampf(
             p->happiness[i] * (1.0f - p->fear[i]) * p->loyalty[i],
             0.0f, 1.0f);
@@ -1169,7 +1660,7 @@ void psych_morale_from_psych(const PsychSoA *p, CombatSoA *c)
  */
 void psych_defection_check(const PsychSoA *p, int *defect_flags)
 {
-    for (int i = 0; i < p->count; i++)
+    for (int i = SIMD_DONE(psych_defection_check, p, defect_flags); i < p->count; i++)
         defect_flags[i] = (p->loyalty[i] < 0.2f) ? 1 : 0;
 }
 
@@ -1183,7 +1674,7 @@ void psych_defection_check(const PsychSoA *p, int *defect_flags)
  */
 void tech_research_tick(TechSoA *t, const PopSoA *p, float dt)
 {
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_research_tick, t, p, dt); i < t->count; i++) {
         float bonus  = (i < p->count) ? t->pop_bonus[i] : 1.0f;
         float mult   = t->golden_age_timer[i] > 0.0f ? t->golden_age_mult[i] : 1.0f;
         float gained = t->research_rate[i] * bonus * mult * dt;
@@ -1211,7 +1702,7 @@ void tech_cost_scale(TechSoA *t)
  */
 void tech_unlock_check(TechSoA *t, int *unlock_flags)
 {
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_unlock_check, t, unlock_flags); i < t->count; i++) {
         unlock_flags[i] = 0;
         if (t->research_pts[i] >= t->tech_cost[i]) {
             t->research_pts[i] -= t->tech_cost[i];
@@ -1226,7 +1717,7 @@ void tech_unlock_check(TechSoA *t, int *unlock_flags)
  */
 void tech_golden_age_tick(TechSoA *t, float dt)
 {
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_golden_age_tick, t, dt); i < t->count; i++) {
         if (t->golden_age_timer[i] > 0.0f)
             t->golden_age_timer[i] = clampf(t->golden_age_timer[i] - dt, 0.0f, 1e6f);
     }
@@ -1252,7 +1743,7 @@ void tech_golden_age_trigger(TechSoA *t, int nation, float threshold)
 void tech_culture_spread(TechSoA *t, float dt)
 {
     const float cap = 1000.0f;
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_culture_spread, t, dt); i < t->count; i++) {
         float c = t->culture[i];
         float dc = t->culture_spread[i] * c * (1.0f - c / cap);
         t->culture[i] = clampf(c + dc * dt, 0.0f, cap);
@@ -1264,7 +1755,7 @@ void tech_culture_spread(TechSoA *t, float dt)
  */
 void tech_era_advance(TechSoA *t)
 {
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_era_advance, t); i < t->count; i++) {
         float expected_era = floorf(t->tech_level[i] / 10.0f);
         if (expected_era > t->era[i])
             t->era[i] = expected_era;
@@ -1287,7 +1778,7 @@ void tech_pop_research_bonus(TechSoA *t, const PopSoA *p)
  */
 void tech_decay(TechSoA *t, float dt)
 {
-    for (int i = 0; i < t->count; i++) {
+    for (int i = SIMD_DONE(tech_decay, t, dt); i < t->count; i++) {
         if (t->research_pts[i] <= 0.0f)
             t->tech_level[i] = clampf(t->tech_level[i] - 0.0001f * dt, 0.0f, 1e6f);
     }
@@ -1313,7 +1804,7 @@ void tech_diffusion(const TechSoA *src, TechSoA *dst, int si, int di, float rate
  */
 void engine_fast_inv_sqrt(EngineSoA *e)
 {
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(engine_fast_inv_sqrt, e); i < e->count; i++)
         e->inv_sqrt_out[i] = fast_inv_sqrt_scalar(e->inv_sqrt_val[i]);
 }
 
@@ -1323,7 +1814,7 @@ void engine_fast_inv_sqrt(EngineSoA *e)
  */
 void engine_entropy_increase(EngineSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(engine_entropy_increase, e, dt); i < e->count; i++) {
         e->entropy[i] = clampf(
             e->entropy[i] + e->entropy_rate[i] * e->chaos_mult[i] * dt,
             0.0f, 1.0f);
@@ -1336,9 +1827,9 @@ void engine_entropy_increase(EngineSoA *e, float dt)
  *   pop_pressure  = population / (carrying_cap + 1)  clamped to [0, 1]
  *   stability = (1 - entropy) * (0.5 + 0.5 * tech_level_norm) * (1 - 0.5 * pop_pressure)
  */
-void engine_stability_update(EngineSoA *e, const TechSoA *t)
+void engine_stability_update(EngineSoA *e, const TechSoA *t, const PopSoA *p)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(engine_stability_update, e, t, p); i < e->count; i++) {
         float tech_norm = (i < t->count)
                           ? clampf(t->tech_level[i] / 50.0f, 0.0f, 1.0f)
                           : 0.5f;
@@ -1359,7 +1850,7 @@ void engine_spatial_grid_assign(EngineSoA *e, const MoveSoA *m, float cell_size)
 {
     int n = e->count < m->count ? e->count : m->count;
     float inv = (cell_size > 0.0f) ? (1.0f / cell_size) : 1.0f;
-    for (int i = 0; i < n; i++) {
+    for (int i = SIMD_DONE(engine_spatial_grid_assign, e, m, inv); i < n; i++) {
         e->grid_x[i] = floorf(m->pos_x[i] * inv);
         e->grid_y[i] = floorf(m->pos_y[i] * inv);
     }
@@ -1370,7 +1861,7 @@ void engine_spatial_grid_assign(EngineSoA *e, const MoveSoA *m, float cell_size)
  */
 void engine_end_timer_tick(EngineSoA *e, float dt)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(engine_end_timer_tick, e, dt); i < e->count; i++) {
         if (e->stability[i] < 0.1f)
             e->end_timer[i] = clampf(e->end_timer[i] - dt, 0.0f, 1e6f);
     }
@@ -1382,7 +1873,7 @@ void engine_end_timer_tick(EngineSoA *e, float dt)
  */
 void engine_victory_pts_update(EngineSoA *e, const PopSoA *p, const TechSoA *t)
 {
-    for (int i = 0; i < e->count; i++) {
+    for (int i = SIMD_DONE(engine_victory_pts_update, e, p, t); i < e->count; i++) {
         float pop_contrib  = (i < p->count) ? p->population[i] * 0.001f : 0.0f;
         float tech_contrib = (i < t->count) ? t->tech_level[i]          : 0.0f;
         e->victory_pts[i] += (pop_contrib + tech_contrib);
@@ -1434,6 +1925,6 @@ void engine_determinism_seed(EngineSoA *e, int faction, uint32_t seed)
  */
 void engine_end_condition_check(const EngineSoA *e, int *end_flags)
 {
-    for (int i = 0; i < e->count; i++)
+    for (int i = SIMD_DONE(engine_end_condition_check, e, end_flags); i < e->count; i++)
         end_flags[i] = (e->end_timer[i] <= 0.0f) ? 1 : 0;
 }
@@ -34,176 +34,285 @@ extern uint32_t global_tick;
    1. POPULATION DYNAMICS — SoA
    ====================================================================== */
 typedef struct {
-    float *population;      /* current population count                    */
-    float *carrying_cap;    /* carrying capacity K                         */
-    float *growth_rate;     /* intrinsic growth rate r                     */
-    float *susceptible;     /* SIR model: susceptible fraction             */
-    float *infected;        /* SIR model: infected fraction                */
-    float *recovered;       /* SIR model: recovered fraction               */
-    float *beta;            /* SIR model: transmission rate                */
-    float *gamma_rec;       /* SIR model: recovery rate                    */
-    float *food_supply;     /* available food units                        */
-    float *food_threshold;  /* minimum food to avoid starvation            */
-    float *age_young;       /* fraction in young cohort                    */
-    float *age_adult;       /* fraction in adult cohort                    */
-    float *age_elder;       /* fraction in elder cohort                    */
-    int    count;           /* number of population groups                 */
+    float *restrict population;     /* current population count                */
+    float *restrict carrying_cap;   /* carrying capacity K                     */
+    float *restrict growth_rate;    /* intrinsic growth rate r                 */
+    float *restrict susceptible;    /* SIR model: susceptible fraction         */
+    float *restrict infected;       /* SIR model: infected fraction            */
+    float *restrict recovered;      /* SIR model: recovered fraction           */
+    float *restrict beta;           /* SIR model: transmission rate            */
+    float *restrict gamma_rec;      /* SIR model: recovery rate                */
+    float *restrict food_supply;    /* available food units                    */
+    float *restrict food_threshold; /* minimum food to avoid starvation        */
+    float *restrict age_young;      /* fraction in young cohort                */
+    float *restrict age_adult;      /* fraction in adult cohort                */
+    float *restrict age_elder;      /* fraction in elder cohort                */
+    int             count;          /* number of population groups             */
+    void           *arena;          /* single block behind the arrays, or NULL */
+    int             capacity;       /* elements each array has room for        */
 } PopSoA;
 
 /* ======================================================================
    2. FAITH & RELIGION — SoA
    ====================================================================== */
 typedef struct {
-    float *faith_level;     /* current faith strength (0..1)               */
-    float *mana;            /* divine mana pool                            */
-    float *mana_regen;      /* mana regen rate per tick                    */
-    float *heresy_rate;     /* rate at which heresy spreads                */
-    float *miracle_chance;  /* base probability a miracle triggers         */
-    float *devotee_count;   /* number of active devotees                   */
-    float *temple_count;    /* number of temples providing a bonus         */
-    float *schism_risk;     /* accumulated schism pressure (0..1)          */
-    float *conversion_rate; /* rate of converting non-believers            */
-    float *divine_favor;    /* current favor with the deity (0..1)         */
-    int    count;           /* number of religious factions                */
+    float *restrict faith_level;     /* current faith strength (0..1)           */
+    float *restrict mana;            /* divine mana pool                        */
+    float *restrict mana_regen;      /* mana regen rate per tick                */
+    float *restrict heresy_rate;     /* rate at which heresy spreads            */
+    float *restrict miracle_chance;  /* base probability a miracle triggers     */
+    float *restrict devotee_count;   /* number of active devotees               */
+    float *restrict temple_count;    /* number of temples providing a bonus     */
+    float *restrict schism_risk;     /* accumulated schism pressure (0..1)      */
+    float *restrict conversion_rate; /* rate of converting non-believers        */
+    float *restrict divine_favor;    /* current favor with the deity (0..1)     */
+    int             count;           /* number of religious factions            */
+    void           *arena;           /* single block behind the arrays, or NULL */
+    int             capacity;        /* elements each array has room for        */
 } FaithSoA;
 
 /* ======================================================================
    3. COMBAT & WARFARE — SoA
    ====================================================================== */
 typedef struct {
-    float *base_atk;        /* base attack power                           */
-    float *armor;           /* armor rating                                */
-    float *hp;              /* current hit points                          */
-    float *max_hp;          /* maximum hit points                          */
-    float *morale;          /* unit morale (0..1)                          */
-    float *morale_decay;    /* morale decay rate per tick                  */
-    float *hit_chance;      /* base hit probability (0..1)                 */
-    float *crit_chance;     /* critical hit probability (0..1)             */
-    float *crit_mult;       /* critical damage multiplier                  */
-    float *rout_threshold;  /* morale below which the unit routs           */
-    int    count;           /* number of combat units                      */
+    float *restrict base_atk;       /* base attack power                       */
+    float *restrict armor;          /* armor rating                            */
+    float *restrict hp;             /* current hit points                      */
+    float *restrict max_hp;         /* maximum hit points                      */
+    float *restrict morale;         /* unit morale (0..1)                      */
+    float *restrict morale_decay;   /* morale decay rate per tick              */
+    float *restrict hit_chance;     /* base hit probability (0..1)             */
+    float *restrict crit_chance;    /* critical hit probability (0..1)         */
+    float *restrict crit_mult;      /* critical damage multiplier              */
+    float *restrict rout_threshold; /* morale below which the unit routs       */
+    int             count;          /* number of combat units                  */
+    void           *arena;          /* single block behind the arrays, or NULL */
+    int             capacity;       /* elements each array has room for        */
 } CombatSoA;
 
 /* ======================================================================
    4. ECONOMY & RESOURCES — SoA
    ====================================================================== */
 typedef struct {
-    float *resource;        /* current stockpile                           */
-    float *max_resource;    /* maximum stockpile capacity                  */
-    float *gather_rate;     /* units gathered per tick                     */
-    float *depletion_rate;  /* natural depletion per tick                  */
-    float *price;           /* current market price per unit               */
-    float *demand;          /* current demand level                        */
-    float *supply;          /* current supply level                        */
-    float *tax_rate;        /* tax fraction (0..1)                         */
-    float *tax_collected;   /* accumulated tax revenue                     */
-    float *trade_volume;    /* volume of trade processed last tick         */
-    int    count;           /* number of resource pools                    */
+    float *restrict resource;       /* current stockpile                       */
+    float *restrict max_resource;   /* maximum stockpile capacity              */
+    float *restrict gather_rate;    /* units gathered per tick                 */
+    float *restrict depletion_rate; /* natural depletion per tick              */
+    float *restrict price;          /* current market price per unit           */
+    float *restrict demand;         /* current demand level                    */
+    float *restrict supply;         /* current supply level                    */
+    float *restrict tax_rate;       /* tax fraction (0..1)                     */
+    float *restrict tax_collected;  /* accumulated tax revenue                 */
+    float *restrict trade_volume;   /* volume of trade processed last tick     */
+    int             count;          /* number of resource pools                */
+    void           *arena;          /* single block behind the arrays, or NULL */
+    int             capacity;       /* elements each array has room for        */
 } EconSoA;
 
 /* ======================================================================
    5. ENVIRONMENT & WEATHER — SoA
    ====================================================================== */
 typedef struct {
-    float *temperature;     /* current temperature                         */
-    float *temp_target;     /* equilibrium temperature                     */
-    float *rainfall;        /* current rainfall level                      */
-    float *humidity;        /* humidity fraction (0..1)                    */
-    float *wind_x;          /* wind vector x-component                     */
-    float *wind_y;          /* wind vector y-component                     */
-    float *fire_intensity;  /* active fire intensity                       */
-    float *fuel;            /* combustible material remaining              */
-    float *elevation;       /* terrain elevation                           */
-    float *pressure;        /* atmospheric pressure                        */
-    int    count;           /* number of tiles/cells                       */
+    float *restrict temperature;    /* current temperature                     */
+    float *restrict temp_target;    /* equilibrium temperature                 */
+    float *restrict rainfall;       /* current rainfall level                  */
+    float *restrict humidity;       /* humidity fraction (0..1)                */
+    float *restrict wind_x;         /* wind vector x-component                 */
+    float *restrict wind_y;         /* wind vector y-component                 */
+    float *restrict fire_intensity; /* active fire intensity                   */
+    float *restrict fuel;           /* combustible material remaining          */
+    float *restrict elevation;      /* terrain elevation                       */
+    float *restrict pressure;       /* atmospheric pressure                    */
+    int             count;          /* number of tiles/cells                   */
+    void           *arena;          /* single block behind the arrays, or NULL */
+    int             capacity;       /* elements each array has room for        */
 } EnvSoA;
 
 /* ======================================================================
    6. MOVEMENT & AI — SoA
    ====================================================================== */
 typedef struct {
-    float *pos_x;           /* x world position                            */
-    float *pos_y;           /* y world position                            */
-    float *vel_x;           /* x velocity component                        */
-    float *vel_y;           /* y velocity component                        */
-    float *acc_x;           /* x acceleration component                    */
-    float *acc_y;           /* y acceleration component                    */
-    float *heading;         /* facing angle in radians                     */
-    float *speed;           /* current scalar speed                        */
-    float *max_speed;       /* speed cap                                   */
-    float *h_cost;          /* A* heuristic cost from last evaluation      */
-    int    count;           /* number of mobile agents                     */
+    float *restrict pos_x;     /* x world position                        */
+    float *restrict pos_y;     /* y world position                        */
+    float *restrict vel_x;     /* x velocity component                    */
+    float *restrict vel_y;     /* y velocity component                    */
+    float *restrict acc_x;     /* x acceleration component                */
+    float *restrict acc_y;     /* y acceleration component                */
+    float *restrict heading;   /* facing angle in radians                 */
+    float *restrict speed;     /* current scalar speed                    */
+    float *restrict max_speed; /* speed cap                               */
+    float *restrict h_cost;    /* A* heuristic cost from last evaluation  */
+    int             count;     /* number of mobile agents                 */
+    void           *arena;     /* single block behind the arrays, or NULL */
+    int             capacity;  /* elements each array has room for        */
 } MoveSoA;
 
+/* Cell-sorted index of a MoveSoA for the flocking kernels, rebuilt from
+   the current positions by move_grid_build.  Cell c (row-major, cols x
+   rows) holds order[cell_start[c] .. cell_start[c + 1]) in ascending agent
+   index.  Agents with a non-finite position go after the last cell, in
+   order[cell_start[ncells] .. cell_start[ncells + 1]); every query visits
+   them, since the all-pairs loops would.
+
+   move_grid_update keeps Verlet lists on top: every agent within
+   reach + skin of agent i at the last build, ascending.  While no agent
+   has moved more than skin / 2 since then, those lists still hold every
+   pair now within reach, so the kernels read them instead of the cells,
+   and the (stale) cells and lists are only rebuilt once someone has.
+   Zero-initialise before the first build. */
+typedef struct {
+    int   *cell_start;      /* ncells + 2 offsets into order[]             */
+    int   *order;           /* agent indices sorted by cell                */
+    int   *cell;            /* cell of each agent, ncells if not finite    */
+    int   *scratch;         /* 2 * count ints of neighbour-list space      */
+    double origin_x;        /* lower corner of cell 0                      */
+    double origin_y;
+    double inv_cell;        /* 1 / padded cell edge                        */
+    float  cell_size;       /* queries up to this radius see 3x3 cells     */
+    int    cols, rows;
+    int    ncells;
+    int    count;           /* agents indexed, or -1 if unusable           */
+    int    agent_cap;       /* allocated agents / cells                    */
+    int    cell_cap;
+    const float *src_x;     /* position arrays indexed                     */
+    const float *src_y;
+    float *ref_x;           /* positions at the last build                 */
+    float *ref_y;
+    /* Verlet lists (move_grid_update) */
+    int   *nbr_start;       /* count + 1 offsets into nbr[]                */
+    int   *nbr;             /* candidates of each agent, ascending         */
+    float  reach;           /* radius the lists answer; 0 if no lists      */
+    float  skin;
+    int    nbr_cap;
+    int    builds;          /* list builds so far                          */
+} MoveGrid;
+
 /* ======================================================================
    7. DIVINE POWERS — SoA
    ====================================================================== */
 typedef struct {
-    float *energy;          /* divine energy stored                        */
-    float *energy_cap;      /* maximum energy capacity                     */
-    float *regen_rate;      /* energy regenerated per tick                 */
-    float *meteor_cost;     /* energy cost to call a meteor                */
-    float *heal_amount;     /* current heal strength                       */
-    float *heal_decay;      /* rate at which heal effectiveness fades      */
-    float *terraform_cost;  /* energy cost per tile terraformed            */
-    float *smite_power;     /* base smite damage                           */
-    float *blessing_mult;   /* stat multiplier applied by a blessing       */
-    float *cooldown;        /* remaining cooldown ticks before reuse       */
-    int    count;           /* number of gods / divine actors              */
+    float *restrict energy;         /* divine energy stored                    */
+    float *restrict energy_cap;     /* maximum energy capacity                 */
+    float *restrict regen_rate;     /* energy regenerated per tick             */
+    float *restrict meteor_cost;    /* energy cost to call a meteor            */
+    float *restrict heal_amount;    /* current heal strength                   */
+    float *restrict heal_decay;     /* rate at which heal effectiveness fades  */
+    float *restrict terraform_cost; /* energy cost per tile terraformed        */
+    float *restrict smite_power;    /* base smite damage                       */
+    float *restrict blessing_mult;  /* stat multiplier applied by a blessing   */
+    float *restrict cooldown;       /* remaining cooldown ticks before reuse   */
+    int             count;          /* number of gods / divine actors          */
+    void           *arena;          /* single block behind the arrays, or NULL */
+    int             capacity;       /* elements each array has room for        */
 } DivineSoA;
 
 /* ======================================================================
    8. NPC PSYCHOLOGY — SoA
    ====================================================================== */
 typedef struct {
-    float *happiness;       /* general wellbeing (0..1)                    */
-    float *fear;            /* current fear level (0..1)                   */
-    float *loyalty;         /* loyalty to current faction (0..1)           */
-    float *aggression;      /* aggression tendency (0..1)                  */
-    float *utility_work;    /* utility score for working                   */
-    float *utility_fight;   /* utility score for fighting                  */
-    float *utility_flee;    /* utility score for fleeing                   */
-    float *threat_level;    /* perceived incoming threat (0..1)            */
-    float *memory_decay;    /* rate at which events fade from memory       */
-    float *social_bond;     /* social bond strength (0..1)                 */
-    int    count;           /* number of NPCs                              */
+    float *restrict happiness;     /* general wellbeing (0..1)                */
+    float *restrict fear;          /* current fear level (0..1)               */
+    float *restrict loyalty;       /* loyalty to current faction (0..1)       */
+    float *restrict aggression;    /* aggression tendency (0..1)              */
+    float *restrict utility_work;  /* utility score for working               */
+    float *restrict utility_fight; /* utility score for fighting              */
+    float *restrict utility_flee;  /* utility score for fleeing               */
+    float *restrict threat_level;  /* perceived incoming threat (0..1)        */
+    float *restrict memory_decay;  /* rate at which events fade from memory   */
+    float *restrict social_bond;   /* social bond strength (0..1)             */
+    int             count;         /* number of NPCs                          */
+    void           *arena;         /* single block behind the arrays, or NULL */
+    int             capacity;      /* elements each array has room for        */
 } PsychSoA;
 
 /* ======================================================================
    9. PROGRESSION & TECH — SoA
    ====================================================================== */
 typedef struct {
-    float *research_pts;    /* accumulated research points                 */
-    float *research_rate;   /* research points generated per tick          */
-    float *tech_cost;       /* cost to reach next tech level               */
-    float *tech_level;      /* current integer tech level (as float)       */
-    float *golden_age_mult; /* research/culture multiplier in golden ages  */
-    float *golden_age_timer;/* ticks remaining in current golden age       */
-    float *culture;         /* cultural advancement score                  */
-    float *culture_spread;  /* rate at which culture spreads outward       */
-    float *era;             /* current era index (integer as float)        */
-    float *pop_bonus;       /* population-derived research bonus           */
-    int    count;           /* number of civilisations                     */
+    float *restrict research_pts;     /* accumulated research points                */
+    float *restrict research_rate;    /* research points generated per tick         */
+    float *restrict tech_cost;        /* cost to reach next tech level              */
+    float *restrict tech_level;       /* current integer tech level (as float)      */
+    float *restrict golden_age_mult;  /* research/culture multiplier in golden ages */
+    float *restrict golden_age_timer; /* ticks remaining in current golden age      */
+    float *restrict culture;          /* cultural advancement score                 */
+    float *restrict culture_spread;   /* rate at which culture spreads outward      */
+    float *restrict era;              /* current era index (integer as float)       */
+    float *restrict pop_bonus;        /* population-derived research bonus          */
+    int             count;            /* number of civilisations                    */
+    void           *arena;            /* single block behind the arrays, or NULL    */
+    int             capacity;         /* elements each array has room for           */
 } TechSoA;
 
 /* ======================================================================
    10. ENGINE & END GAME — SoA
    ====================================================================== */
 typedef struct {
-    float    *entropy;      /* chaos / entropy level (0..1)                */
-    float    *entropy_rate; /* rate of entropy increase per tick           */
-    float    *grid_x;       /* spatial hash grid x-bucket index            */
-    float    *grid_y;       /* spatial hash grid y-bucket index            */
-    float    *inv_sqrt_val; /* input values for fast inverse-sqrt          */
-    float    *inv_sqrt_out; /* output results from fast inverse-sqrt       */
-    float    *stability;    /* world stability (0..1)                      */
-    float    *end_timer;    /* countdown ticks to an end condition         */
-    float    *victory_pts;  /* victory points per faction                  */
-    float    *chaos_mult;   /* chaos multiplier applied to random events   */
-    uint32_t *rng_state;    /* per-faction deterministic RNG state         */
-    int       count;        /* number of factions / engine slots           */
+    float    *restrict entropy;      /* chaos / entropy level (0..1)              */
+    float    *restrict entropy_rate; /* rate of entropy increase per tick         */
+    float    *restrict grid_x;       /* spatial hash grid x-bucket index          */
+    float    *restrict grid_y;       /* spatial hash grid y-bucket index          */
+    float    *restrict inv_sqrt_val; /* input values for fast inverse-sqrt        */
+    float    *restrict inv_sqrt_out; /* output results from fast inverse-sqrt     */
+    float    *restrict stability;    /* world stability (0..1)                    */
+    float    *restrict end_timer;    /* countdown ticks to an end condition       */
+    float    *restrict victory_pts;  /* victory points per faction                */
+    float    *restrict chaos_mult;   /* chaos multiplier applied to random events */
+    uint32_t *restrict rng_state;    /* per-faction deterministic RNG state       */
+    int                count;        /* number of factions / engine slots         */
+    void              *arena;        /* single block behind the arrays, or NULL   */
+    int                capacity;     /* elements each array has room for          */
 } EngineSoA;
 
+/* ======================================================================
+   SOA LIFECYCLE (simulation_soa.c)
+   ====================================================================== */
+/* Each SoA created here keeps all of its arrays in one 64-byte aligned
+   block.  Every array starts on a cache line, has `capacity` >= count
+   elements, and everything past count is zero, so a vector loop may run
+   over the whole last vector without a scalar tail.  Arrays never overlap,
+   which is what the restrict qualifiers above promise.  Large arrays are
+   spaced so that no two start at the same offset within a page; otherwise
+   a kernel streaming a dozen of them at once keeps evicting its own lines
+   from the same L1 sets.
+
+   *_soa_create returns a zeroed SoA of `count` elements, or NULL if out of
+   memory.  *_soa_resize keeps the first min(old, new) elements, zeroes the
+   rest, and returns 0; on failure it returns -1 and leaves the SoA as it
+   was.  Array pointers move when capacity has to grow.  *_soa_destroy
+   frees the SoA; NULL is ignored.  SoAs whose arrays the caller wired up
+   by hand (arena == NULL) must not be resized or destroyed here. */
+PopSoA    *pop_soa_create(int count);
+int        pop_soa_resize(PopSoA *p, int count);
+void       pop_soa_destroy(PopSoA *p);
+FaithSoA  *faith_soa_create(int count);
+int        faith_soa_resize(FaithSoA *f, int count);
+void       faith_soa_destroy(FaithSoA *f);
+CombatSoA *combat_soa_create(int count);
+int        combat_soa_resize(CombatSoA *c, int count);
+void       combat_soa_destroy(CombatSoA *c);
+EconSoA   *econ_soa_create(int count);
+int        econ_soa_resize(EconSoA *e, int count);
+void       econ_soa_destroy(EconSoA *e);
+EnvSoA    *env_soa_create(int count);
+int        env_soa_resize(EnvSoA *e, int count);
+void       env_soa_destroy(EnvSoA *e);
+MoveSoA   *move_soa_create(int count);
+int        move_soa_resize(MoveSoA *m, int count);
+void       move_soa_destroy(MoveSoA *m);
+DivineSoA *divine_soa_create(int count);
+int        divine_soa_resize(DivineSoA *d, int count);
+void       divine_soa_destroy(DivineSoA *d);
+PsychSoA  *psych_soa_create(int count);
+int        psych_soa_resize(PsychSoA *p, int count);
+void       psych_soa_destroy(PsychSoA *p);
+TechSoA   *tech_soa_create(int count);
+int        tech_soa_resize(TechSoA *t, int count);
+void       tech_soa_destroy(TechSoA *t);
+EngineSoA *engine_soa_create(int count);
+int        engine_soa_resize(EngineSoA *e, int count);
+void       engine_soa_destroy(EngineSoA *e);
+
 /* ======================================================================
    FUNCTION DECLARATIONS — 100 total (10 per category)
    ====================================================================== */
@@ -219,6 +328,10 @@ void pop_migration(PopSoA *src, PopSoA *dst, int idx, float rate, float dt);
 void pop_carrying_cap_pressure(PopSoA *p);
 void pop_epidemic_mortality(PopSoA *p, float mortality_rate, float dt);
 void pop_recovery_bonus(PopSoA *p, float dt);
+/* Fused chain: logistic growth, SIR, starvation, age cohorts, births, deaths,
+   epidemic mortality and recovery bonus in one pass over the arrays.  Same
+   result as calling those eight in that order. */
+void pop_tick(PopSoA *p, float mortality_rate, float dt);
 
 /* --- 2. Faith & Religion --- */
 void faith_generate(FaithSoA *f, float dt);
@@ -241,8 +354,12 @@ void combat_morale_decay(CombatSoA *c, float dt);
 void combat_morale_boost(CombatSoA *c, int unit, float amount);
 void combat_rout_check(const CombatSoA *c, int *rout_flags);
 void combat_hp_regen(CombatSoA *c, float regen_rate, float dt);
+/* With a grid that still indexes these pos_x/pos_y arrays (built over
+   them, and no unit moved since move_grid_build or more than skin / 2
+   since move_grid_update), only the cells the disc can reach are visited;
+   otherwise (g may be NULL) every unit. */
 void combat_aoe_damage(CombatSoA *c, const float *pos_x, const float *pos_y,
-                       float cx, float cy, float radius, float dmg);
+                       const MoveGrid *g, float cx, float cy, float radius, float dmg);
 void combat_siege_damage(CombatSoA *c, int building, float siege_power, float dt);
 
 /* --- 4. Economy & Resources --- */
@@ -271,9 +388,32 @@ void env_flood_check(const EnvSoA *e, float threshold, int *flood_flags);
 
 /* --- 6. Movement & AI --- */
 void move_velocity_verlet(MoveSoA *m, float dt);
-void move_flock_separation(MoveSoA *m, float radius, float strength);
-void move_flock_alignment(MoveSoA *m, float radius, float strength);
-void move_flock_cohesion(MoveSoA *m, float radius, float strength);
+/* Index m by cells of at least cell_size.  Returns 0, or -1 if out of
+   memory, in which case the grid is left unusable and the flocking
+   kernels fall back to all pairs. */
+int  move_grid_build(MoveGrid *g, const MoveSoA *m, float cell_size);
+/* Keep Verlet lists for queries up to `radius`: rebuild the cells (of
+   radius + skin) and lists if this is the first call, the agents or the
+   radius changed, or an agent moved more than skin / 2 since the last
+   build.  Call once per tick, before the flocking kernels.  Returns 1 if
+   it rebuilt, 0 if the lists still hold, -1 if out of memory (the grid is
+   then unusable, as above), or -2 if radius is not positive or radius +
+   skin overflows (the grid then holds cells but no lists). */
+int  move_grid_update(MoveGrid *g, const MoveSoA *m, float radius, float skin);
+void move_grid_free(MoveGrid *g);
+/* The flocking kernels read each agent's Verlet list when `g` holds lists
+   with reach >= radius, visit only the 3x3 cells around it when g indexes
+   m's current positions with cell_size >= radius, and test every pair
+   otherwise (g may be NULL), including when the agents moved since the
+   grid was built.  All give the same result. */
+void move_flock_separation(MoveSoA *m, MoveGrid *g, float radius, float strength);
+void move_flock_alignment(MoveSoA *m, MoveGrid *g, float radius, float strength);
+void move_flock_cohesion(MoveSoA *m, MoveGrid *g, float radius, float strength);
+/* All three in one neighbour pass, each with its own radius and strength.
+   Same result as separation, alignment, cohesion called in that order. */
+void move_flock_combined(MoveSoA *m, MoveGrid *g, float sep_radius, float sep_strength,
+                         float ali_radius, float ali_strength,
+                         float coh_radius, float coh_strength);
 void move_seek_target(MoveSoA *m, int unit, float tx, float ty, float strength);
 void move_flee_target(MoveSoA *m, int unit, float tx, float ty, float strength);
 void move_astar_heuristic(MoveSoA *m, int unit, float gx, float gy);
@@ -320,7 +460,7 @@ void tech_diffusion(const TechSoA *src, TechSoA *dst, int si, int di, float rate
 /* --- 10. Engine & End Game --- */
 void engine_fast_inv_sqrt(EngineSoA *e);
 void engine_entropy_increase(EngineSoA *e, float dt);
-void engine_stability_update(EngineSoA *e, const TechSoA *t);
+void engine_stability_update(EngineSoA *e, const TechSoA *t, const PopSoA *p);
 void engine_spatial_grid_assign(EngineSoA *e, const MoveSoA *m, float cell_size);
 void engine_end_timer_tick(EngineSoA *e, float dt);
 void engine_victory_pts_update(EngineSoA *e, const PopSoA *p, const TechSoA *t);
@@ -329,4 +469,27 @@ void engine_entropy_reset(EngineSoA *e, int faction);
 void engine_determinism_seed(EngineSoA *e, int faction, uint32_t seed);
 void engine_end_condition_check(const EngineSoA *e, int *end_flags);
 
+/* ======================================================================
+   VECTOR DISPATCH
+   ====================================================================== */
+/* The sweep kernels have SSE4.2 and AVX2 paths (simulation_simd.c) that
+   give bit-identical results to the scalar loops.  The best path the CPU
+   supports is chosen once at startup; the scalar loops remain the
+   reference, run the tail each vector pass leaves, and are all there is
+   off x86 (e.g. the Emscripten build). */
+typedef enum {
+    SIM_ISA_SCALAR,
+    SIM_ISA_SSE42,
+    SIM_ISA_AVX2,
+    SIM_ISA_COUNT
+} SimIsa;
+
+/* Path the kernels use now, and the best one this CPU can run. */
+SimIsa      sim_isa_active(void);
+SimIsa      sim_isa_best(void);
+/* Use `isa`, or the best supported path below it; returns the one in use.
+   Must not be called while kernels are running on other threads. */
+SimIsa      sim_isa_select(SimIsa isa);
+const char *sim_isa_name(SimIsa isa);
+
 #endif /* SIMULATION_H */
@@ -0,0 +1,159 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * simulation_simd.c — SSE4.2 and AVX2 builds of the sweep kernels, and the
+ * startup dispatch between them.
+ *
+ * The kernel bodies live in simulation_simd_impl.h, which is compiled here
+ * once per instruction set with target() attributes, so the file needs no
+ * special compiler flags and the rest of the program stays baseline x86-64.
+ * cpuid (via __builtin_cpu_supports) picks a table once, before main; the
+ * kernels in simulation.c read it through SIMD_DONE.  Off x86, or with a
+ * compiler without target(), only the scalar reference exists.
+ */
+
+#include "simulation_simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIM_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIM_SIMD_X86 0
+#endif
+
+const SimSimd *sim_simd   = NULL;
+static SimIsa  isa_active = SIM_ISA_SCALAR;
+
+#if SIM_SIMD_X86
+
+/* ---- AVX2: 8 lanes ------------------------------------------------------ */
+#define SIMD_ISA      "avx2"
+#define SIMD_SFX      avx2
+#define VW            8
+#define vf            __m256
+#define vi            __m256i
+#define VLD(p)        _mm256_loadu_ps(p)
+#define VST(p, v)     _mm256_storeu_ps(p, v)
+#define VSET(x)       _mm256_set1_ps(x)
+#define VADD(a, b)    _mm256_add_ps(a, b)
+#define VSUB(a, b)    _mm256_sub_ps(a, b)
+#define VMUL(a, b)    _mm256_mul_ps(a, b)
+#define VDIV(a, b)    _mm256_div_ps(a, b)
+#define VMIN(a, b)    _mm256_min_ps(a, b)
+#define VSQRT(a)      _mm256_sqrt_ps(a)
+#define VFLOOR(a)     _mm256_floor_ps(a)
+#define VLT(a, b)     _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define VGT(a, b)     _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define VLE(a, b)     _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define VGE(a, b)     _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define VAND(a, b)    _mm256_and_ps(a, b)
+#define VOR(a, b)     _mm256_or_ps(a, b)
+#define VANDN(a, b)   _mm256_andnot_ps(a, b)
+#define VSEL(m, a, b) _mm256_blendv_ps(b, a, m)
+#define VISET(x)      _mm256_set1_epi32((int)(x))
+#define VIOTA         _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+#define VIADD(a, b)   _mm256_add_epi32(a, b)
+#define VISUB(a, b)   _mm256_sub_epi32(a, b)
+#define VIMUL(a, b)   _mm256_mullo_epi32(a, b)
+#define VIAND(a, b)   _mm256_and_si256(a, b)
+#define VIXOR(a, b)   _mm256_xor_si256(a, b)
+#define VISRL(a, n)   _mm256_srli_epi32(a, n)
+#define VIEQ(a, b)    _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))
+#define VI2F(a)       _mm256_cvtepi32_ps(a)
+#define VASI(a)       _mm256_castps_si256(a)
+#define VASF(a)       _mm256_castsi256_ps(a)
+#define VIST(p, v)    _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#include "simulation_simd_impl.h"
+
+/* ---- SSE4.2: 4 lanes (blendv, floor and mullo need SSE4.1) ------------- */
+#define SIMD_ISA      "sse4.2"
+#define SIMD_SFX      sse42
+#define VW            4
+#define vf            __m128
+#define vi            __m128i
+#define VLD(p)        _mm_loadu_ps(p)
+#define VST(p, v)     _mm_storeu_ps(p, v)
+#define VSET(x)       _mm_set1_ps(x)
+#define VADD(a, b)    _mm_add_ps(a, b)
+#define VSUB(a, b)    _mm_sub_ps(a, b)
+#define VMUL(a, b)    _mm_mul_ps(a, b)
+#define VDIV(a, b)    _mm_div_ps(a, b)
+#define VMIN(a, b)    _mm_min_ps(a, b)
+#define VSQRT(a)      _mm_sqrt_ps(a)
+#define VFLOOR(a)     _mm_floor_ps(a)
+#define VLT(a, b)     _mm_cmplt_ps(a, b)
+#define VGT(a, b)     _mm_cmpgt_ps(a, b)
+#define VLE(a, b)     _mm_cmple_ps(a, b)
+#define VGE(a, b)     _mm_cmpge_ps(a, b)
+#define VAND(a, b)    _mm_and_ps(a, b)
+#define VOR(a, b)     _mm_or_ps(a, b)
+#define VANDN(a, b)   _mm_andnot_ps(a, b)
+#define VSEL(m, a, b) _mm_blendv_ps(b, a, m)
+#define VISET(x)      _mm_set1_epi32((int)(x))
+#define VIOTA         _mm_setr_epi32(0, 1, 2, 3)
+#define VIADD(a, b)   _mm_add_epi32(a, b)
+#define VISUB(a, b)   _mm_sub_epi32(a, b)
+#define VIMUL(a, b)   _mm_mullo_epi32(a, b)
+#define VIAND(a, b)   _mm_and_si128(a, b)
+#define VIXOR(a, b)   _mm_xor_si128(a, b)
+#define VISRL(a, n)   _mm_srli_epi32(a, n)
+#define VIEQ(a, b)    _mm_castsi128_ps(_mm_cmpeq_epi32(a, b))
+#define VI2F(a)       _mm_cvtepi32_ps(a)
+#define VASI(a)       _mm_castps_si128(a)
+#define VASF(a)       _mm_castsi128_ps(a)
+#define VIST(p, v)    _mm_storeu_si128((__m128i *)(void *)(p), v)
+#include "simulation_simd_impl.h"
+
+#endif /* SIM_SIMD_X86 */
+
+/* ======================================================================
+   DISPATCH
+   ====================================================================== */
+SimIsa sim_isa_best(void)
+{
+#if SIM_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return SIM_ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SIM_ISA_SSE42;
+#endif
+    return SIM_ISA_SCALAR;
+}
+
+SimIsa sim_isa_select(SimIsa isa)
+{
+    SimIsa best = sim_isa_best();
+    if (isa > best) isa = best;
+    switch (isa) {
+#if SIM_SIMD_X86
+        case SIM_ISA_AVX2:  sim_simd = &sim_simd_avx2;  break;
+        case SIM_ISA_SSE42: sim_simd = &sim_simd_sse42; break;
+#endif
+        default:            isa = SIM_ISA_SCALAR; sim_simd = NULL; break;
+    }
+    isa_active = isa;
+    return isa;
+}
+
+SimIsa sim_isa_active(void)
+{
+    return isa_active;
+}
+
+const char *sim_isa_name(SimIsa isa)
+{
+    switch (isa) {
+        case SIM_ISA_SSE42: return "sse4.2";
+        case SIM_ISA_AVX2:  return "avx2";
+        default:            return "scalar";
+    }
+}
+
+#if SIM_SIMD_X86
+/* Dispatch once, before main and before any worker thread exists. */
+__attribute__((constructor)) static void sim_isa_init(void)
+{
+    sim_isa_select(SIM_ISA_COUNT);
+}
+#endif
@@ -0,0 +1,128 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * simulation_simd.h — Vector kernel table shared by simulation.c and
+ * simulation_simd.c.  Not part of the public API; see sim_isa_* in
+ * simulation.h.
+ *
+ * A vector kernel takes the same arguments as its scalar counterpart,
+ * processes the longest prefix [0, n) that fills whole vectors, and
+ * returns n.  The scalar loop in simulation.c then starts at n, so the
+ * tail (and everything, when no vector path is active) runs the reference
+ * code.  Vector kernels rewrite branches as blends: a lane that the scalar
+ * loop would skip stores back the value it loaded.
+ *
+ * tech_cost_scale, tech_pop_research_bonus and move_heading_update call
+ * expf/logf/atan2f per element and have no vector path: a vector exp, log
+ * or atan2 would not round as libm does, and every path must match the
+ * scalar one bit for bit.  The single-index event kernels touch one element
+ * per call, so they have no loop to vectorise.
+ */
+
+#ifndef SIMULATION_SIMD_H
+#define SIMULATION_SIMD_H
+
+#include "simulation.h"
+
+/* Maximum allowed market price — prevents multiplicative divergence to infinity. */
+#define MAX_PRICE 1000.0f
+
+typedef struct {
+    /* 1. Population Dynamics */
+    int (*pop_logistic_growth)(PopSoA *p, float dt);
+    int (*pop_sir_step)(PopSoA *p, float dt);
+    int (*pop_starvation)(PopSoA *p, float dt);
+    int (*pop_age_cohort_shift)(PopSoA *p, float dt);
+    int (*pop_birth_rate)(PopSoA *p, float dt);
+    int (*pop_death_rate)(PopSoA *p, float dt);
+    int (*pop_carrying_cap_pressure)(PopSoA *p);
+    int (*pop_epidemic_mortality)(PopSoA *p, float mortality_rate, float dt);
+    int (*pop_recovery_bonus)(PopSoA *p, float dt);
+    int (*pop_tick)(PopSoA *p, float mortality_rate, float dt);
+    /* 2. Faith & Religion */
+    int (*faith_generate)(FaithSoA *f, float dt);
+    int (*faith_mana_regen)(FaithSoA *f, float dt);
+    int (*faith_heresy_spread)(FaithSoA *f, float dt);
+    int (*faith_miracle_check)(FaithSoA *f, int *miracle_out);
+    int (*faith_conversion_tick)(FaithSoA *f, float dt);
+    int (*faith_schism_accumulate)(FaithSoA *f, float dt);
+    int (*faith_divine_favor_update)(FaithSoA *f, float piety_delta);
+    int (*faith_temple_bonus)(FaithSoA *f);
+    int (*faith_devotee_update)(FaithSoA *f, float dt);
+    /* 3. Combat & Warfare */
+    int (*combat_armor_mitigation)(const CombatSoA *c, float *dmg_inout);
+    int (*combat_morale_decay)(CombatSoA *c, float dt);
+    int (*combat_rout_check)(const CombatSoA *c, int *rout_flags);
+    int (*combat_hp_regen)(CombatSoA *c, float regen_rate, float dt);
+    int (*combat_aoe_damage)(CombatSoA *c, const float *pos_x, const float *pos_y,
+                             float cx, float cy, float radius, float dmg);
+    /* 4. Economy & Resources */
+    int (*econ_gather)(EconSoA *e, float dt);
+    int (*econ_deplete)(EconSoA *e, float dt);
+    int (*econ_market_price)(EconSoA *e);
+    int (*econ_collect_tax)(EconSoA *e, const float *population);
+    int (*econ_resource_cap)(EconSoA *e);
+    int (*econ_demand_update)(EconSoA *e, float population_delta);
+    int (*econ_supply_shock)(EconSoA *e, float keep);
+    int (*econ_inflation)(EconSoA *e, float factor);
+    int (*econ_scarcity_penalty)(const EconSoA *e, float *output_mult);
+    /* 5. Environment & Weather */
+    int (*env_temperature_diffuse)(EnvSoA *e, float rate, float dt);
+    int (*env_rainfall_update)(EnvSoA *e, float dt);
+    int (*env_fire_spread)(EnvSoA *e, float spread_prob, float dt);
+    int (*env_fire_consume)(EnvSoA *e, float dt);
+    int (*env_humidity_evaporate)(EnvSoA *e, float dt);
+    int (*env_wind_advect)(EnvSoA *e);
+    int (*env_pressure_gradient)(EnvSoA *e);
+    int (*env_elevation_temp_bias)(EnvSoA *e);
+    int (*env_drought_check)(const EnvSoA *e, float threshold, int *drought_flags);
+    int (*env_flood_check)(const EnvSoA *e, float threshold, int *flood_flags);
+    /* 6. Movement & AI */
+    int (*move_velocity_verlet)(MoveSoA *m, float dt, float dt2_half);
+    int (*move_flock_separation)(MoveSoA *m, float radius, float strength);
+    int (*move_flock_alignment)(MoveSoA *m, float radius, float strength);
+    int (*move_flock_cohesion)(MoveSoA *m, float radius, float strength);
+    int (*move_flock_combined)(MoveSoA *m, float sep_radius, float sep_strength,
+                               float ali_radius, float ali_strength,
+                               float coh_radius, float coh_strength);
+    int (*move_clamp_speed)(MoveSoA *m);
+    /* 7. Divine Powers */
+    int (*divine_energy_regen)(DivineSoA *d, const FaithSoA *f, float dt);
+    int (*divine_heal_decay)(DivineSoA *d, float dt);
+    int (*divine_cooldown_tick)(DivineSoA *d, float dt);
+    int (*divine_energy_cap)(DivineSoA *d);
+    int (*divine_favor_scale)(DivineSoA *d, const FaithSoA *f);
+    /* 8. NPC Psychology */
+    int (*psych_utility_evaluate)(PsychSoA *p);
+    int (*psych_fear_decay)(PsychSoA *p, float dt);
+    int (*psych_happiness_update)(PsychSoA *p, const EconSoA *e);
+    int (*psych_social_bond_update)(PsychSoA *p, float dt);
+    int (*psych_memory_fade)(PsychSoA *p, float dt);
+    int (*psych_morale_from_psych)(const PsychSoA *p, CombatSoA *c);
+    int (*psych_defection_check)(const PsychSoA *p, int *defect_flags);
+    /* 9. Progression & Tech */
+    int (*tech_research_tick)(TechSoA *t, const PopSoA *p, float dt);
+    int (*tech_unlock_check)(TechSoA *t, int *unlock_flags);
+    int (*tech_golden_age_tick)(TechSoA *t, float dt);
+    int (*tech_culture_spread)(TechSoA *t, float dt);
+    int (*tech_era_advance)(TechSoA *t);
+    int (*tech_decay)(TechSoA *t, float dt);
+    /* 10. Engine & End Game */
+    int (*engine_fast_inv_sqrt)(EngineSoA *e);
+    int (*engine_entropy_increase)(EngineSoA *e, float dt);
+    int (*engine_stability_update)(EngineSoA *e, const TechSoA *t, const PopSoA *p);
+    int (*engine_spatial_grid_assign)(EngineSoA *e, const MoveSoA *m, float inv_cell);
+    int (*engine_end_timer_tick)(EngineSoA *e, float dt);
+    int (*engine_victory_pts_update)(EngineSoA *e, const PopSoA *p, const TechSoA *t);
+    int (*engine_end_condition_check)(const EngineSoA *e, int *end_flags);
+} SimSimd;
+
+/* Active vector table, or NULL for the scalar reference. */
+extern const SimSimd *sim_simd;
+
+/* First index the scalar loop of kernel `fn` has left to do. */
+#define SIMD_DONE(fn, ...) (sim_simd ? sim_simd->fn(__VA_ARGS__) : 0)
+
+#endif /* SIMULATION_SIMD_H */
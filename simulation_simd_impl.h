@@ -0,0 +1,1238 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * simulation_simd_impl.h — Vector kernel bodies, written once against the
+ * op macros that simulation_simd.c defines for each instruction set:
+ *
+ *   SIMD_ISA, SIMD_SFX   target() string and function-name suffix
+ *   VW, vf, vi           lanes, float vector, int vector
+ *   VLD/VST/VSET, VADD/VSUB/VMUL/VDIV/VMIN/VSQRT/VFLOOR
+ *   VLT/VGT/VLE/VGE      ordered compares (all-ones lanes where true)
+ *   VAND/VOR/VANDN       mask logic; VANDN(a, b) is ~a & b
+ *   VSEL(m, a, b)        m ? a : b per lane
+ *   VI*, VASI/VASF       32-bit integer lanes and bit casts between the two
+ *
+ * Included once per instruction set, with no include guard; it undefines
+ * the op macros on the way out.
+ *
+ * Every expression keeps the operand order of the scalar loop it mirrors
+ * and no FMA is enabled, so each lane rounds exactly as the reference
+ * does.  CLAMP picks `hi` with min (which returns its first operand on
+ * hi < v, as `v > hi ? hi : v` does) and then blends `lo` in where v < lo,
+ * matching clampf for NaN and for lo > hi.
+ */
+
+#define SIMD_CAT_(a, b) a##_##b
+#define SIMD_CAT(a, b)  SIMD_CAT_(a, b)
+#define VK(name)        SIMD_CAT(name, SIMD_SFX)
+#define SIMD_FN         static __attribute__((target(SIMD_ISA)))
+
+SIMD_FN inline vf VK(clampv)(vf v, vf lo, vf hi)
+{
+    return VSEL(VLT(v, lo), lo, VMIN(hi, v));
+}
+
+/* fast_inv_sqrt_scalar, lane by lane. */
+SIMD_FN inline vf VK(finvsqrtv)(vf x)
+{
+    vf y = VASF(VISUB(VISET(0x5f3759dfu), VISRL(VASI(x), 1)));
+    return VMUL(y, VSUB(VSET(1.5f), VMUL(VMUL(VMUL(VSET(0.5f), x), y), y)));
+}
+
+/* 1/0 per lane from a compare mask. */
+#define FLAG(m)          VIAND(VASI(m), VISET(1))
+#define CLAMP(v, lo, hi) VK(clampv)(v, lo, hi)
+#define FINVSQRT(x)      VK(finvsqrtv)(x)
+
+/* ======================================================================
+   1. POPULATION DYNAMICS
+   ====================================================================== */
+SIMD_FN int VK(pop_logistic_growth)(PopSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf n = VLD(p->population + i), k = VLD(p->carrying_cap + i);
+        vf r = VLD(p->growth_rate + i);
+        vf dn = VMUL(VMUL(r, n), VSUB(VSET(1.0f), VDIV(n, k)));
+        VST(p->population + i, CLAMP(VADD(n, VMUL(dn, VSET(dt))), VSET(0.0f), k));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_sir_step)(PopSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf n  = VLD(p->population + i);
+        vf s0 = VLD(p->susceptible + i), i0 = VLD(p->infected + i);
+        vf r0 = VLD(p->recovered + i);
+        vf new_inf = VDIV(VMUL(VMUL(VLD(p->beta + i), s0), i0), n);
+        vf new_rec = VMUL(VLD(p->gamma_rec + i), i0);
+        vf s   = VSUB(s0, VMUL(new_inf, VSET(dt)));
+        vf inf = VADD(i0, VMUL(VSUB(new_inf, new_rec), VSET(dt)));
+        vf r   = VADD(r0, VMUL(new_rec, VSET(dt)));
+        vf total = VADD(VADD(s, inf), r);
+        vf keep  = VANDN(VLE(n, VSET(0.0f)), VGT(total, VSET(0.0f)));
+        VST(p->susceptible + i,
+            VSEL(keep, CLAMP(VDIV(s, total), VSET(0.0f), VSET(1.0f)), s0));
+        VST(p->infected + i,
+            VSEL(keep, CLAMP(VDIV(inf, total), VSET(0.0f), VSET(1.0f)), i0));
+        VST(p->recovered + i,
+            VSEL(keep, CLAMP(VDIV(r, total), VSET(0.0f), VSET(1.0f)), r0));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_starvation)(PopSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf thr = VLD(p->food_threshold + i), pop = VLD(p->population + i);
+        vf deficit = VSUB(thr, VLD(p->food_supply + i));
+        vf frac = VDIV(deficit, thr);
+        vf loss = VMUL(VMUL(VMUL(pop, frac), VSET(0.05f)), VSET(dt));
+        vf next = CLAMP(VSUB(pop, loss), VSET(0.0f), VLD(p->carrying_cap + i));
+        VST(p->population + i, VSEL(VLE(deficit, VSET(0.0f)), pop, next));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_age_cohort_shift)(PopSoA *p, float dt)
+{
+    const float shift_rate = 0.002f;
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf young = VLD(p->age_young + i), adult = VLD(p->age_adult + i);
+        vf elder = VLD(p->age_elder + i);
+        vf ya = VMUL(VMUL(young, VSET(shift_rate)), VSET(dt));
+        vf ae = VMUL(VMUL(adult, VSET(shift_rate)), VSET(dt));
+        VST(p->age_young + i, CLAMP(VSUB(young, ya), VSET(0.0f), VSET(1.0f)));
+        VST(p->age_adult + i, CLAMP(VSUB(VADD(adult, ya), ae), VSET(0.0f), VSET(1.0f)));
+        VST(p->age_elder + i, CLAMP(VADD(elder, ae), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_birth_rate)(PopSoA *p, float dt)
+{
+    const float birth_coeff = 0.03f;
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf pop = VLD(p->population + i);
+        vf births = VMUL(VMUL(VMUL(VSET(birth_coeff), VLD(p->age_adult + i)), pop), VSET(dt));
+        vf young = VADD(VLD(p->age_young + i), VDIV(births, VADD(pop, VSET(1.0f))));
+        VST(p->age_young + i, CLAMP(young, VSET(0.0f), VSET(1.0f)));
+        VST(p->population + i,
+            CLAMP(VADD(pop, births), VSET(0.0f), VLD(p->carrying_cap + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_death_rate)(PopSoA *p, float dt)
+{
+    const float base_death   = 0.01f;
+    const float elder_excess = 0.04f;
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf pop  = VLD(p->population + i);
+        vf rate = VADD(VSET(base_death), VMUL(VSET(elder_excess), VLD(p->age_elder + i)));
+        vf deaths = VMUL(VMUL(rate, pop), VSET(dt));
+        VST(p->population + i,
+            CLAMP(VSUB(pop, deaths), VSET(0.0f), VLD(p->carrying_cap + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_carrying_cap_pressure)(PopSoA *p)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf pop = VLD(p->population + i), cap = VLD(p->carrying_cap + i);
+        VST(p->population + i, VSEL(VGT(pop, cap), cap, pop));
+        VST(p->food_threshold + i, VMUL(cap, VSET(0.1f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_epidemic_mortality)(PopSoA *p, float mortality_rate, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf pop = VLD(p->population + i);
+        vf deaths = VMUL(VMUL(VMUL(VSET(mortality_rate), VLD(p->infected + i)), pop), VSET(dt));
+        VST(p->population + i,
+            CLAMP(VSUB(pop, deaths), VSET(0.0f), VLD(p->carrying_cap + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_recovery_bonus)(PopSoA *p, float dt)
+{
+    const float bonus = 0.005f;
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf pop = VLD(p->population + i);
+        vf gain = VMUL(VMUL(VMUL(VSET(bonus), VLD(p->recovered + i)), pop), VSET(dt));
+        VST(p->population + i,
+            CLAMP(VADD(pop, gain), VSET(0.0f), VLD(p->carrying_cap + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(pop_tick)(PopSoA *p, float mortality_rate, float dt)
+{
+    const float shift_rate   = 0.002f;
+    const float birth_coeff  = 0.03f;
+    const float base_death   = 0.01f;
+    const float elder_excess = 0.04f;
+    const float bonus        = 0.005f;
+    const vf zero = VSET(0.0f), one = VSET(1.0f), vdt = VSET(dt);
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf n     = VLD(p->population + i), k = VLD(p->carrying_cap + i);
+        vf s     = VLD(p->susceptible + i), inf = VLD(p->infected + i);
+        vf r     = VLD(p->recovered + i);
+        vf young = VLD(p->age_young + i), adult = VLD(p->age_adult + i);
+        vf elder = VLD(p->age_elder + i);
+
+        vf dn = VMUL(VMUL(VLD(p->growth_rate + i), n), VSUB(one, VDIV(n, k)));
+        n = CLAMP(VADD(n, VMUL(dn, vdt)), zero, k);
+
+        vf new_inf = VDIV(VMUL(VMUL(VLD(p->beta + i), s), inf), n);
+        vf new_rec = VMUL(VLD(p->gamma_rec + i), inf);
+        vf s2    = VSUB(s, VMUL(new_inf, vdt));
+        vf inf2  = VADD(inf, VMUL(VSUB(new_inf, new_rec), vdt));
+        vf r2    = VADD(r, VMUL(new_rec, vdt));
+        vf total = VADD(VADD(s2, inf2), r2);
+        vf sir   = VANDN(VLE(n, zero), VGT(total, zero));
+        s   = VSEL(sir, CLAMP(VDIV(s2, total),   zero, one), s);
+        inf = VSEL(sir, CLAMP(VDIV(inf2, total), zero, one), inf);
+        r   = VSEL(sir, CLAMP(VDIV(r2, total),   zero, one), r);
+
+        vf thr     = VLD(p->food_threshold + i);
+        vf deficit = VSUB(thr, VLD(p->food_supply + i));
+        vf starved = CLAMP(VSUB(n, VMUL(VMUL(VMUL(n, VDIV(deficit, thr)), VSET(0.05f)), vdt)),
+                           zero, k);
+        n = VSEL(VLE(deficit, zero), n, starved);
+
+        vf ya = VMUL(VMUL(young, VSET(shift_rate)), vdt);
+        vf ae = VMUL(VMUL(adult, VSET(shift_rate)), vdt);
+        young = CLAMP(VSUB(young, ya), zero, one);
+        adult = CLAMP(VSUB(VADD(adult, ya), ae), zero, one);
+        elder = CLAMP(VADD(elder, ae), zero, one);
+
+        vf births = VMUL(VMUL(VMUL(VSET(birth_coeff), adult), n), vdt);
+        young = CLAMP(VADD(young, VDIV(births, VADD(n, one))), zero, one);
+        n     = CLAMP(VADD(n, births), zero, k);
+
+        vf rate = VADD(VSET(base_death), VMUL(VSET(elder_excess), elder));
+        n = CLAMP(VSUB(n, VMUL(VMUL(rate, n), vdt)), zero, k);
+        n = CLAMP(VSUB(n, VMUL(VMUL(VMUL(VSET(mortality_rate), inf), n), vdt)), zero, k);
+        n = CLAMP(VADD(n, VMUL(VMUL(VMUL(VSET(bonus), r), n), vdt)), zero, k);
+
+        VST(p->population + i, n);
+        VST(p->susceptible + i, s);
+        VST(p->infected + i, inf);
+        VST(p->recovered + i, r);
+        VST(p->age_young + i, young);
+        VST(p->age_adult + i, adult);
+        VST(p->age_elder + i, elder);
+    }
+    return i;
+}
+
+/* ======================================================================
+   2. FAITH & RELIGION
+   ====================================================================== */
+SIMD_FN int VK(faith_generate)(FaithSoA *f, float dt)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf temples = VADD(VSET(1.0f), VMUL(VLD(f->temple_count + i), VSET(0.1f)));
+        vf gain = VMUL(VMUL(VMUL(VLD(f->devotee_count + i), temples), VSET(0.001f)), VSET(dt));
+        VST(f->faith_level + i,
+            CLAMP(VADD(VLD(f->faith_level + i), gain), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(faith_mana_regen)(FaithSoA *f, float dt)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf gain = VMUL(VMUL(VLD(f->mana_regen + i), VLD(f->divine_favor + i)), VSET(dt));
+        VST(f->mana + i, CLAMP(VADD(VLD(f->mana + i), gain), VSET(0.0f), VSET(1000.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(faith_heresy_spread)(FaithSoA *f, float dt)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf faith  = VLD(f->faith_level + i);
+        vf heresy = VSUB(VSET(1.0f), faith);
+        vf d = VMUL(VMUL(VMUL(VLD(f->heresy_rate + i), VSUB(VSET(1.0f), faith)), heresy),
+                    VSUB(VSET(1.0f), heresy));
+        heresy = CLAMP(VADD(heresy, VMUL(d, VSET(dt))), VSET(0.0f), VSET(1.0f));
+        VST(f->faith_level + i, VSUB(VSET(1.0f), heresy));
+    }
+    return i;
+}
+
+/* The LCG seed is keyed to the index, so lane j carries index i + j. */
+SIMD_FN int VK(faith_miracle_check)(FaithSoA *f, int *miracle_out)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vi seed = VIXOR(VIMUL(VIADD(VISET(i + 1), VIOTA), VISET(2654435761u)),
+                        VISET(global_tick));
+        vi s    = VIADD(VIMUL(seed, VISET(1664525u)), VISET(1013904223u));
+        vf roll = VDIV(VI2F(VISRL(s, 8)), VSET((float)(1u << 24)));
+        vf p    = VMUL(VLD(f->miracle_chance + i), VLD(f->divine_favor + i));
+        VIST(miracle_out + i, FLAG(VLT(roll, p)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(faith_conversion_tick)(FaithSoA *f, float dt)
+{
+    const float pop_cap = 1000.0f;
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf dev    = VLD(f->devotee_count + i);
+        vf target = VMUL(VSET(pop_cap), VLD(f->faith_level + i));
+        vf delta  = VMUL(VMUL(VLD(f->conversion_rate + i), VSUB(target, dev)), VSET(dt));
+        VST(f->devotee_count + i, CLAMP(VADD(dev, delta), VSET(0.0f), VSET(pop_cap)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(faith_schism_accumulate)(FaithSoA *f, float dt)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf rise = VMUL(VMUL(VSUB(VSET(1.0f), VLD(f->faith_level + i)), VSET(0.01f)), VSET(dt));
+        VST(f->schism_risk + i,
+            CLAMP(VADD(VLD(f->schism_risk + i), rise), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(faith_divine_favor_update)(FaithSoA *f, float piety_delta)
+{
+    int i = 0;
+    for (; i + VW <= f->count; i += VW)
+        VST(f->divine_favor + i, CLAMP(VADD(VLD(f->divine_favor + i), VSET(piety_delta)),
+                                       VSET(0.0f), VSET(1.0f)));
+    return i;
+}
+
+SIMD_FN int VK(faith_temple_bonus)(FaithSoA *f)
+{
+    const float base_miracle = 0.01f;
+    int i = 0;
+    for (; i + VW <= f->count; i += VW)
+        VST(f->miracle_chance + i,
+            VMUL(VSET(base_miracle),
+                 VADD(VSET(1.0f), VMUL(VLD(f->temple_count + i), VSET(0.05f)))));
+    return i;
+}
+
+SIMD_FN int VK(faith_devotee_update)(FaithSoA *f, float dt)
+{
+    const float target_scale = 1000.0f;
+    const float drift_rate   = 0.05f;
+    int i = 0;
+    for (; i + VW <= f->count; i += VW) {
+        vf dev    = VLD(f->devotee_count + i);
+        vf target = VMUL(VLD(f->faith_level + i), VSET(target_scale));
+        dev = VADD(dev, VMUL(VMUL(VSET(drift_rate), VSUB(target, dev)), VSET(dt)));
+        VST(f->devotee_count + i, CLAMP(dev, VSET(0.0f), VSET(target_scale)));
+    }
+    return i;
+}
+
+/* ======================================================================
+   3. COMBAT & WARFARE
+   ====================================================================== */
+SIMD_FN int VK(combat_armor_mitigation)(const CombatSoA *c, float *dmg_inout)
+{
+    int i = 0;
+    for (; i + VW <= c->count; i += VW) {
+        vf armor = VLD(c->armor + i);
+        vf mit = VDIV(armor, VADD(armor, VSET(100.0f)));
+        VST(dmg_inout + i, VMUL(VLD(dmg_inout + i), VSUB(VSET(1.0f), mit)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(combat_morale_decay)(CombatSoA *c, float dt)
+{
+    int i = 0;
+    for (; i + VW <= c->count; i += VW)
+        VST(c->morale + i,
+            CLAMP(VSUB(VLD(c->morale + i), VMUL(VLD(c->morale_decay + i), VSET(dt))),
+                  VSET(0.0f), VSET(1.0f)));
+    return i;
+}
+
+SIMD_FN int VK(combat_rout_check)(const CombatSoA *c, int *rout_flags)
+{
+    int i = 0;
+    for (; i + VW <= c->count; i += VW)
+        VIST(rout_flags + i, FLAG(VLT(VLD(c->morale + i), VLD(c->rout_threshold + i))));
+    return i;
+}
+
+SIMD_FN int VK(combat_hp_regen)(CombatSoA *c, float regen_rate, float dt)
+{
+    int i = 0;
+    for (; i + VW <= c->count; i += VW) {
+        vf max_hp = VLD(c->max_hp + i);
+        vf heal = VMUL(VMUL(VSET(regen_rate), max_hp), VSET(dt));
+        VST(c->hp + i, CLAMP(VADD(VLD(c->hp + i), heal), VSET(0.0f), max_hp));
+    }
+    return i;
+}
+
+SIMD_FN int VK(combat_aoe_damage)(CombatSoA *c, const float *pos_x, const float *pos_y,
+                                  float cx, float cy, float radius, float dmg)
+{
+    float r2 = radius * radius;
+    int i = 0;
+    for (; i + VW <= c->count; i += VW) {
+        vf dx = VSUB(VLD(pos_x + i), VSET(cx));
+        vf dy = VSUB(VLD(pos_y + i), VSET(cy));
+        vf d2 = VADD(VMUL(dx, dx), VMUL(dy, dy));
+        vf falloff = VSUB(VSET(1.0f), VDIV(VSQRT(d2), VSET(radius)));
+        vf actual  = VMUL(VSET(dmg), falloff);
+        actual = VSEL(VLT(actual, VSET(1.0f)), VSET(1.0f), actual);
+        vf hp   = VLD(c->hp + i);
+        vf next = CLAMP(VSUB(hp, actual), VSET(0.0f), VLD(c->max_hp + i));
+        VST(c->hp + i, VSEL(VGE(d2, VSET(r2)), hp, next));
+    }
+    return i;
+}
+
+/* ======================================================================
+   4. ECONOMY & RESOURCES
+   ====================================================================== */
+SIMD_FN int VK(econ_gather)(EconSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->resource + i,
+            CLAMP(VADD(VLD(e->resource + i), VMUL(VLD(e->gather_rate + i), VSET(dt))),
+                  VSET(0.0f), VLD(e->max_resource + i)));
+    return i;
+}
+
+SIMD_FN int VK(econ_deplete)(EconSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf res = CLAMP(VSUB(VLD(e->resource + i), VMUL(VLD(e->depletion_rate + i), VSET(dt))),
+                       VSET(0.0f), VLD(e->max_resource + i));
+        VST(e->resource + i, res);
+        VST(e->supply + i, res);
+    }
+    return i;
+}
+
+SIMD_FN int VK(econ_market_price)(EconSoA *e)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf supply = VLD(e->supply + i), price = VLD(e->price + i);
+        vf sup  = VSEL(VGT(supply, VSET(1.0f)), supply, VSET(1.0f));
+        vf base = VSEL(VGT(price, VSET(0.0f)), price, VSET(1.0f));
+        VST(e->price + i, CLAMP(VMUL(base, VSQRT(VDIV(VLD(e->demand + i), sup))),
+                                VSET(0.01f), VSET(MAX_PRICE)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(econ_collect_tax)(EconSoA *e, const float *population)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf res = VLD(e->resource + i);
+        vf tax = VMUL(VMUL(VMUL(res, VLD(e->tax_rate + i)), VLD(population + i)), VSET(0.001f));
+        VST(e->tax_collected + i, VADD(VLD(e->tax_collected + i), tax));
+        VST(e->resource + i, CLAMP(VSUB(res, tax), VSET(0.0f), VLD(e->max_resource + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(econ_resource_cap)(EconSoA *e)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->resource + i,
+            CLAMP(VLD(e->resource + i), VSET(0.0f), VLD(e->max_resource + i)));
+    return i;
+}
+
+SIMD_FN int VK(econ_demand_update)(EconSoA *e, float population_delta)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->demand + i, CLAMP(VADD(VLD(e->demand + i), VSET(0.01f * population_delta)),
+                                 VSET(0.0f), VSET(1e9f)));
+    return i;
+}
+
+SIMD_FN int VK(econ_supply_shock)(EconSoA *e, float keep)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf res = VMUL(VLD(e->resource + i), VSET(keep));
+        VST(e->resource + i, res);
+        VST(e->supply + i, res);
+    }
+    return i;
+}
+
+SIMD_FN int VK(econ_inflation)(EconSoA *e, float factor)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->price + i, CLAMP(VMUL(VLD(e->price + i), VSET(factor)),
+                                VSET(0.01f), VSET(1e6f)));
+    return i;
+}
+
+SIMD_FN int VK(econ_scarcity_penalty)(const EconSoA *e, float *output_mult)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf max = VLD(e->max_resource + i);
+        vf cap = VSEL(VGT(max, VSET(0.0f)), max, VSET(1.0f));
+        VST(output_mult + i,
+            CLAMP(VDIV(VLD(e->resource + i), cap), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+/* ======================================================================
+   5. ENVIRONMENT & WEATHER
+   ====================================================================== */
+SIMD_FN int VK(env_temperature_diffuse)(EnvSoA *e, float rate, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf temp = VLD(e->temperature + i);
+        vf diff = VSUB(VLD(e->temp_target + i), temp);
+        VST(e->temperature + i, VADD(temp, VMUL(VMUL(VSET(rate), diff), VSET(dt))));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_rainfall_update)(EnvSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf wx = VLD(e->wind_x + i), wy = VLD(e->wind_y + i);
+        vf wind_mag = VSQRT(VADD(VMUL(wx, wx), VMUL(wy, wy)));
+        vf target   = VMUL(VMUL(VLD(e->humidity + i), wind_mag), VSET(0.5f));
+        vf rain     = VLD(e->rainfall + i);
+        vf diff     = VSUB(target, rain);
+        VST(e->rainfall + i,
+            CLAMP(VADD(rain, VMUL(diff, VSET(dt))), VSET(0.0f), VSET(100.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_fire_spread)(EnvSoA *e, float spread_prob, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf fire = VLD(e->fire_intensity + i);
+        vf spread = VMUL(VMUL(VMUL(VSET(spread_prob), VLD(e->fuel + i)), fire), VSET(dt));
+        vf next = CLAMP(VADD(fire, spread), VSET(0.0f), VSET(1.0f));
+        VST(e->fire_intensity + i, VSEL(VLE(fire, VSET(0.0f)), fire, next));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_fire_consume)(EnvSoA *e, float dt)
+{
+    const float consume_rate = 0.1f;
+    const float decay_rate   = 0.01f;
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf fire = VLD(e->fire_intensity + i), fuel = VLD(e->fuel + i);
+        vf out  = VLE(fire, VSET(0.0f));
+        vf burned = VMUL(VMUL(VSET(consume_rate), fire), VSET(dt));
+        vf left = CLAMP(VSUB(fuel, burned), VSET(0.0f), VSET(1.0f));
+        vf next = VSEL(VLE(left, VSET(0.0f)), VSET(0.0f),
+                       CLAMP(VSUB(fire, VSET(decay_rate * dt)), VSET(0.0f), VSET(1.0f)));
+        VST(e->fuel + i, VSEL(out, fuel, left));
+        VST(e->fire_intensity + i, VSEL(out, fire, next));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_humidity_evaporate)(EnvSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf loss = VMUL(VMUL(VLD(e->temperature + i), VSET(0.001f)), VSET(dt));
+        VST(e->humidity + i,
+            CLAMP(VSUB(VLD(e->humidity + i), loss), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_wind_advect)(EnvSoA *e)
+{
+    const float dampen = 0.99f;
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        VST(e->wind_x + i, VMUL(VLD(e->wind_x + i), VSET(dampen)));
+        VST(e->wind_y + i, VMUL(VLD(e->wind_y + i), VSET(dampen)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_pressure_gradient)(EnvSoA *e)
+{
+    const float base_pressure = 1013.25f;
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf excess = VMUL(VSUB(VLD(e->pressure + i), VSET(base_pressure)), VSET(0.01f));
+        VST(e->wind_x + i, VADD(VLD(e->wind_x + i), excess));
+        VST(e->wind_y + i, VADD(VLD(e->wind_y + i), excess));
+    }
+    return i;
+}
+
+SIMD_FN int VK(env_elevation_temp_bias)(EnvSoA *e)
+{
+    const float lapse = 0.5f;
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->temp_target + i,
+            VSUB(VLD(e->temp_target + i), VMUL(VLD(e->elevation + i), VSET(lapse))));
+    return i;
+}
+
+SIMD_FN int VK(env_drought_check)(const EnvSoA *e, float threshold, int *drought_flags)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VIST(drought_flags + i, FLAG(VLT(VLD(e->rainfall + i), VSET(threshold))));
+    return i;
+}
+
+SIMD_FN int VK(env_flood_check)(const EnvSoA *e, float threshold, int *flood_flags)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VIST(flood_flags + i, FLAG(VGT(VLD(e->rainfall + i), VSET(threshold))));
+    return i;
+}
+
+/* ======================================================================
+   6. MOVEMENT & AI
+   ====================================================================== */
+SIMD_FN int VK(move_velocity_verlet)(MoveSoA *m, float dt, float dt2_half)
+{
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf ax = VLD(m->acc_x + i), ay = VLD(m->acc_y + i);
+        vf vx = VLD(m->vel_x + i), vy = VLD(m->vel_y + i);
+        VST(m->pos_x + i, VADD(VLD(m->pos_x + i),
+                               VADD(VMUL(vx, VSET(dt)), VMUL(ax, VSET(dt2_half)))));
+        VST(m->pos_y + i, VADD(VLD(m->pos_y + i),
+                               VADD(VMUL(vy, VSET(dt)), VMUL(ay, VSET(dt2_half)))));
+        VST(m->vel_x + i, VADD(vx, VMUL(ax, VSET(dt))));
+        VST(m->vel_y + i, VADD(vy, VMUL(ay, VSET(dt))));
+    }
+    return i;
+}
+
+/*
+ * The flocking kernels put VW agents i in the lanes and walk every j with
+ * a broadcast, so each lane sums its neighbours in the same order as the
+ * scalar loop.  A skipped neighbour adds +0, which leaves a sum that
+ * started at +0 unchanged.
+ */
+SIMD_FN int VK(move_flock_separation)(MoveSoA *m, float radius, float strength)
+{
+    float r2 = radius * radius;
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf px = VLD(m->pos_x + i), py = VLD(m->pos_y + i);
+        vi self = VIADD(VISET(i), VIOTA);
+        vf fx = VSET(0.0f), fy = VSET(0.0f);
+        for (int j = 0; j < m->count; j++) {
+            vf dx = VSUB(px, VSET(m->pos_x[j]));
+            vf dy = VSUB(py, VSET(m->pos_y[j]));
+            vf d2 = VADD(VMUL(dx, dx), VMUL(dy, dy));
+            vf skip = VOR(VOR(VIEQ(self, VISET(j)), VGT(d2, VSET(r2))),
+                          VLT(d2, VSET(1e-6f)));
+            vf inv_d = FINVSQRT(d2);
+            fx = VADD(fx, VSEL(skip, VSET(0.0f), VMUL(dx, inv_d)));
+            fy = VADD(fy, VSEL(skip, VSET(0.0f), VMUL(dy, inv_d)));
+        }
+        VST(m->acc_x + i, VADD(VLD(m->acc_x + i), VMUL(VSET(strength), fx)));
+        VST(m->acc_y + i, VADD(VLD(m->acc_y + i), VMUL(VSET(strength), fy)));
+    }
+    return i;
+}
+
+/* `n` counts in a float lane: exact far beyond any agent count. */
+SIMD_FN int VK(move_flock_alignment)(MoveSoA *m, float radius, float strength)
+{
+    float r2 = radius * radius;
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf px = VLD(m->pos_x + i), py = VLD(m->pos_y + i);
+        vi self = VIADD(VISET(i), VIOTA);
+        vf sx = VSET(0.0f), sy = VSET(0.0f), n = VSET(0.0f);
+        for (int j = 0; j < m->count; j++) {
+            vf dx = VSUB(px, VSET(m->pos_x[j]));
+            vf dy = VSUB(py, VSET(m->pos_y[j]));
+            vf skip = VOR(VIEQ(self, VISET(j)),
+                          VGT(VADD(VMUL(dx, dx), VMUL(dy, dy)), VSET(r2)));
+            sx = VADD(sx, VSEL(skip, VSET(0.0f), VSET(m->vel_x[j])));
+            sy = VADD(sy, VSEL(skip, VSET(0.0f), VSET(m->vel_y[j])));
+            n  = VADD(n,  VSEL(skip, VSET(0.0f), VSET(1.0f)));
+        }
+        vf any = VGT(n, VSET(0.0f));
+        vf ax = VLD(m->acc_x + i), ay = VLD(m->acc_y + i);
+        vf tx = VADD(ax, VMUL(VSET(strength), VSUB(VDIV(sx, n), VLD(m->vel_x + i))));
+        vf ty = VADD(ay, VMUL(VSET(strength), VSUB(VDIV(sy, n), VLD(m->vel_y + i))));
+        VST(m->acc_x + i, VSEL(any, tx, ax));
+        VST(m->acc_y + i, VSEL(any, ty, ay));
+    }
+    return i;
+}
+
+SIMD_FN int VK(move_flock_cohesion)(MoveSoA *m, float radius, float strength)
+{
+    float r2 = radius * radius;
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf px = VLD(m->pos_x + i), py = VLD(m->pos_y + i);
+        vi self = VIADD(VISET(i), VIOTA);
+        vf cx = VSET(0.0f), cy = VSET(0.0f), n = VSET(0.0f);
+        for (int j = 0; j < m->count; j++) {
+            vf qx = VSET(m->pos_x[j]), qy = VSET(m->pos_y[j]);
+            vf dx = VSUB(px, qx), dy = VSUB(py, qy);
+            vf skip = VOR(VIEQ(self, VISET(j)),
+                          VGT(VADD(VMUL(dx, dx), VMUL(dy, dy)), VSET(r2)));
+            cx = VADD(cx, VSEL(skip, VSET(0.0f), qx));
+            cy = VADD(cy, VSEL(skip, VSET(0.0f), qy));
+            n  = VADD(n,  VSEL(skip, VSET(0.0f), VSET(1.0f)));
+        }
+        vf any = VGT(n, VSET(0.0f));
+        vf ax = VLD(m->acc_x + i), ay = VLD(m->acc_y + i);
+        vf tx = VADD(ax, VMUL(VSET(strength), VSUB(VDIV(cx, n), px)));
+        vf ty = VADD(ay, VMUL(VSET(strength), VSUB(VDIV(cy, n), py)));
+        VST(m->acc_x + i, VSEL(any, tx, ax));
+        VST(m->acc_y + i, VSEL(any, ty, ay));
+    }
+    return i;
+}
+
+SIMD_FN int VK(move_flock_combined)(MoveSoA *m, float sep_radius, float sep_strength,
+                                    float ali_radius, float ali_strength,
+                                    float coh_radius, float coh_strength)
+{
+    vf r2s = VSET(sep_radius * sep_radius);
+    vf r2a = VSET(ali_radius * ali_radius);
+    vf r2c = VSET(coh_radius * coh_radius);
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf px = VLD(m->pos_x + i), py = VLD(m->pos_y + i);
+        vi self = VIADD(VISET(i), VIOTA);
+        vf fx = VSET(0.0f), fy = VSET(0.0f);
+        vf sx = VSET(0.0f), sy = VSET(0.0f), na = VSET(0.0f);
+        vf cx = VSET(0.0f), cy = VSET(0.0f), nc = VSET(0.0f);
+        for (int j = 0; j < m->count; j++) {
+            vf qx = VSET(m->pos_x[j]), qy = VSET(m->pos_y[j]);
+            vf dx = VSUB(px, qx), dy = VSUB(py, qy);
+            vf d2 = VADD(VMUL(dx, dx), VMUL(dy, dy));
+            vf me = VIEQ(self, VISET(j));
+            vf skip = VOR(VOR(me, VGT(d2, r2s)), VLT(d2, VSET(1e-6f)));
+            vf inv_d = FINVSQRT(d2);
+            fx = VADD(fx, VSEL(skip, VSET(0.0f), VMUL(dx, inv_d)));
+            fy = VADD(fy, VSEL(skip, VSET(0.0f), VMUL(dy, inv_d)));
+            skip = VOR(me, VGT(d2, r2a));
+            sx = VADD(sx, VSEL(skip, VSET(0.0f), VSET(m->vel_x[j])));
+            sy = VADD(sy, VSEL(skip, VSET(0.0f), VSET(m->vel_y[j])));
+            na = VADD(na, VSEL(skip, VSET(0.0f), VSET(1.0f)));
+            skip = VOR(me, VGT(d2, r2c));
+            cx = VADD(cx, VSEL(skip, VSET(0.0f), qx));
+            cy = VADD(cy, VSEL(skip, VSET(0.0f), qy));
+            nc = VADD(nc, VSEL(skip, VSET(0.0f), VSET(1.0f)));
+        }
+        vf ax = VADD(VLD(m->acc_x + i), VMUL(VSET(sep_strength), fx));
+        vf ay = VADD(VLD(m->acc_y + i), VMUL(VSET(sep_strength), fy));
+        vf any = VGT(na, VSET(0.0f));
+        vf tx = VADD(ax, VMUL(VSET(ali_strength), VSUB(VDIV(sx, na), VLD(m->vel_x + i))));
+        vf ty = VADD(ay, VMUL(VSET(ali_strength), VSUB(VDIV(sy, na), VLD(m->vel_y + i))));
+        ax = VSEL(any, tx, ax);
+        ay = VSEL(any, ty, ay);
+        any = VGT(nc, VSET(0.0f));
+        tx = VADD(ax, VMUL(VSET(coh_strength), VSUB(VDIV(cx, nc), px)));
+        ty = VADD(ay, VMUL(VSET(coh_strength), VSUB(VDIV(cy, nc), py)));
+        VST(m->acc_x + i, VSEL(any, tx, ax));
+        VST(m->acc_y + i, VSEL(any, ty, ay));
+    }
+    return i;
+}
+
+SIMD_FN int VK(move_clamp_speed)(MoveSoA *m)
+{
+    int i = 0;
+    for (; i + VW <= m->count; i += VW) {
+        vf vx = VLD(m->vel_x + i), vy = VLD(m->vel_y + i);
+        vf max_speed = VLD(m->max_speed + i);
+        vf spd2 = VADD(VMUL(vx, vx), VMUL(vy, vy));
+        vf fast = VAND(VGT(spd2, VMUL(max_speed, max_speed)), VGT(spd2, VSET(1e-9f)));
+        vf scale = VMUL(max_speed, FINVSQRT(spd2));
+        vx = VSEL(fast, VMUL(vx, scale), vx);
+        vy = VSEL(fast, VMUL(vy, scale), vy);
+        VST(m->vel_x + i, vx);
+        VST(m->vel_y + i, vy);
+        VST(m->speed + i, VSQRT(VADD(VMUL(vx, vx), VMUL(vy, vy))));
+    }
+    return i;
+}
+
+/* ======================================================================
+   7. DIVINE POWERS
+   ====================================================================== */
+/* Only the indices that have a FaithSoA entry; the scalar loop does the rest. */
+SIMD_FN int VK(divine_energy_regen)(DivineSoA *d, const FaithSoA *f, float dt)
+{
+    int n = d->count < f->count ? d->count : f->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf gain = VMUL(VMUL(VLD(d->regen_rate + i), VLD(f->divine_favor + i)), VSET(dt));
+        VST(d->energy + i, CLAMP(VADD(VLD(d->energy + i), gain),
+                                 VSET(0.0f), VLD(d->energy_cap + i)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(divine_heal_decay)(DivineSoA *d, float dt)
+{
+    int i = 0;
+    for (; i + VW <= d->count; i += VW) {
+        vf heal   = VLD(d->heal_amount + i);
+        vf target = VMUL(VLD(d->energy_cap + i), VSET(0.1f));
+        vf diff   = VSUB(target, heal);
+        VST(d->heal_amount + i,
+            CLAMP(VADD(heal, VMUL(VMUL(diff, VLD(d->heal_decay + i)), VSET(dt))),
+                  VSET(1.0f), VSET(1e6f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(divine_cooldown_tick)(DivineSoA *d, float dt)
+{
+    int i = 0;
+    for (; i + VW <= d->count; i += VW)
+        VST(d->cooldown + i, CLAMP(VSUB(VLD(d->cooldown + i), VSET(dt)),
+                                   VSET(0.0f), VSET(1e6f)));
+    return i;
+}
+
+SIMD_FN int VK(divine_energy_cap)(DivineSoA *d)
+{
+    int i = 0;
+    for (; i + VW <= d->count; i += VW)
+        VST(d->energy + i, CLAMP(VLD(d->energy + i), VSET(0.0f), VLD(d->energy_cap + i)));
+    return i;
+}
+
+SIMD_FN int VK(divine_favor_scale)(DivineSoA *d, const FaithSoA *f)
+{
+    int n = d->count < f->count ? d->count : f->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW)
+        VST(d->regen_rate + i,
+            VMUL(VLD(d->regen_rate + i),
+                 VADD(VSET(0.5f), VMUL(VSET(0.5f), VLD(f->divine_favor + i)))));
+    return i;
+}
+
+/* ======================================================================
+   8. NPC PSYCHOLOGY
+   ====================================================================== */
+SIMD_FN int VK(psych_utility_evaluate)(PsychSoA *p)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf uw = VLD(p->utility_work + i), uf = VLD(p->utility_fight + i);
+        vf ul = VLD(p->utility_flee + i), a = VLD(p->aggression + i);
+        vf flee  = VAND(VGT(ul, uf), VGT(ul, uw));
+        vf fight = VGT(uf, uw);
+        vf calm  = CLAMP(VSUB(a, VSET(0.1f)),  VSET(0.0f), VSET(1.0f));
+        vf angry = CLAMP(VADD(a, VSET(0.05f)), VSET(0.0f), VSET(1.0f));
+        VST(p->aggression + i, VSEL(flee, calm, VSEL(fight, angry, a)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_fear_decay)(PsychSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf k = VMUL(VLD(p->memory_decay + i), VSET(dt));
+        VST(p->fear + i, CLAMP(VMUL(VLD(p->fear + i), VSUB(VSET(1.0f), k)),
+                               VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_happiness_update)(PsychSoA *p, const EconSoA *e)
+{
+    int n = p->count < e->count ? p->count : e->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf max   = VLD(e->max_resource + i);
+        vf cap   = VSEL(VGT(max, VSET(0.0f)), max, VSET(1.0f));
+        vf ratio = CLAMP(VDIV(VLD(e->resource + i), cap), VSET(0.0f), VSET(1.0f));
+        vf happy = VMUL(VSET(0.5f), VSUB(VADD(VSET(1.0f), ratio), VLD(p->fear + i)));
+        vf h = VADD(VMUL(VLD(p->happiness + i), VSET(0.9f)), VMUL(happy, VSET(0.1f)));
+        VST(p->happiness + i, CLAMP(h, VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_social_bond_update)(PsychSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf delta = VMUL(VMUL(VSUB(VLD(p->loyalty + i), VSET(0.5f)), VSET(0.01f)), VSET(dt));
+        VST(p->social_bond + i,
+            CLAMP(VADD(VLD(p->social_bond + i), delta), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_memory_fade)(PsychSoA *p, float dt)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW) {
+        vf keep = VSUB(VSET(1.0f), VMUL(VLD(p->memory_decay + i), VSET(dt)));
+        VST(p->fear + i, CLAMP(VMUL(VLD(p->fear + i), keep), VSET(0.0f), VSET(1.0f)));
+        VST(p->aggression + i,
+            CLAMP(VMUL(VLD(p->aggression + i), keep), VSET(0.0f), VSET(1.0f)));
+        VST(p->threat_level + i,
+            CLAMP(VMUL(VLD(p->threat_level + i), keep), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_morale_from_psych)(const PsychSoA *p, CombatSoA *c)
+{
+    int n = p->count < c->count ? p->count : c->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf m = VMUL(VMUL(VLD(p->happiness + i), VSUB(VSET(1.0f), VLD(p->fear + i))),
+                    VLD(p->loyalty + i));
+        VST(c->morale + i, CLAMP(m, VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(psych_defection_check)(const PsychSoA *p, int *defect_flags)
+{
+    int i = 0;
+    for (; i + VW <= p->count; i += VW)
+        VIST(defect_flags + i, FLAG(VLT(VLD(p->loyalty + i), VSET(0.2f))));
+    return i;
+}
+
+/* ======================================================================
+   9. PROGRESSION & TECH
+   ====================================================================== */
+SIMD_FN int VK(tech_research_tick)(TechSoA *t, const PopSoA *p, float dt)
+{
+    int n = t->count < p->count ? t->count : p->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf mult = VSEL(VGT(VLD(t->golden_age_timer + i), VSET(0.0f)),
+                       VLD(t->golden_age_mult + i), VSET(1.0f));
+        vf gained = VMUL(VMUL(VMUL(VLD(t->research_rate + i), VLD(t->pop_bonus + i)), mult),
+                         VSET(dt));
+        VST(t->research_pts + i, VADD(VLD(t->research_pts + i), gained));
+    }
+    return i;
+}
+
+SIMD_FN int VK(tech_unlock_check)(TechSoA *t, int *unlock_flags)
+{
+    int i = 0;
+    for (; i + VW <= t->count; i += VW) {
+        vf pts = VLD(t->research_pts + i), cost = VLD(t->tech_cost + i);
+        vf level = VLD(t->tech_level + i);
+        vf up = VGE(pts, cost);
+        VST(t->research_pts + i, VSEL(up, VSUB(pts, cost), pts));
+        VST(t->tech_level + i, VSEL(up, VADD(level, VSET(1.0f)), level));
+        VIST(unlock_flags + i, FLAG(up));
+    }
+    return i;
+}
+
+SIMD_FN int VK(tech_golden_age_tick)(TechSoA *t, float dt)
+{
+    int i = 0;
+    for (; i + VW <= t->count; i += VW) {
+        vf timer = VLD(t->golden_age_timer + i);
+        vf next  = CLAMP(VSUB(timer, VSET(dt)), VSET(0.0f), VSET(1e6f));
+        VST(t->golden_age_timer + i, VSEL(VGT(timer, VSET(0.0f)), next, timer));
+    }
+    return i;
+}
+
+SIMD_FN int VK(tech_culture_spread)(TechSoA *t, float dt)
+{
+    const float cap = 1000.0f;
+    int i = 0;
+    for (; i + VW <= t->count; i += VW) {
+        vf c  = VLD(t->culture + i);
+        vf dc = VMUL(VMUL(VLD(t->culture_spread + i), c),
+                     VSUB(VSET(1.0f), VDIV(c, VSET(cap))));
+        VST(t->culture + i, CLAMP(VADD(c, VMUL(dc, VSET(dt))), VSET(0.0f), VSET(cap)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(tech_era_advance)(TechSoA *t)
+{
+    int i = 0;
+    for (; i + VW <= t->count; i += VW) {
+        vf era = VLD(t->era + i);
+        vf expected = VFLOOR(VDIV(VLD(t->tech_level + i), VSET(10.0f)));
+        VST(t->era + i, VSEL(VGT(expected, era), expected, era));
+    }
+    return i;
+}
+
+SIMD_FN int VK(tech_decay)(TechSoA *t, float dt)
+{
+    int i = 0;
+    for (; i + VW <= t->count; i += VW) {
+        vf level = VLD(t->tech_level + i);
+        vf next  = CLAMP(VSUB(level, VSET(0.0001f * dt)), VSET(0.0f), VSET(1e6f));
+        VST(t->tech_level + i, VSEL(VLE(VLD(t->research_pts + i), VSET(0.0f)), next, level));
+    }
+    return i;
+}
+
+/* ======================================================================
+   10. ENGINE & END GAME
+   ====================================================================== */
+SIMD_FN int VK(engine_fast_inv_sqrt)(EngineSoA *e)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VST(e->inv_sqrt_out + i, FINVSQRT(VLD(e->inv_sqrt_val + i)));
+    return i;
+}
+
+SIMD_FN int VK(engine_entropy_increase)(EngineSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf rise = VMUL(VMUL(VLD(e->entropy_rate + i), VLD(e->chaos_mult + i)), VSET(dt));
+        VST(e->entropy + i, CLAMP(VADD(VLD(e->entropy + i), rise), VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(engine_stability_update)(EngineSoA *e, const TechSoA *t, const PopSoA *p)
+{
+    int n = e->count;
+    if (t->count < n) n = t->count;
+    if (p->count < n) n = p->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf tech_norm = CLAMP(VDIV(VLD(t->tech_level + i), VSET(50.0f)), VSET(0.0f), VSET(1.0f));
+        vf pressure  = CLAMP(VDIV(VLD(p->population + i),
+                                  VADD(VLD(p->carrying_cap + i), VSET(1.0f))),
+                             VSET(0.0f), VSET(1.0f));
+        vf s = VMUL(VMUL(VSUB(VSET(1.0f), VLD(e->entropy + i)),
+                         VADD(VSET(0.5f), VMUL(VSET(0.5f), tech_norm))),
+                    VSUB(VSET(1.0f), VMUL(VSET(0.5f), pressure)));
+        VST(e->stability + i, CLAMP(s, VSET(0.0f), VSET(1.0f)));
+    }
+    return i;
+}
+
+SIMD_FN int VK(engine_spatial_grid_assign)(EngineSoA *e, const MoveSoA *m, float inv_cell)
+{
+    int n = e->count < m->count ? e->count : m->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        VST(e->grid_x + i, VFLOOR(VMUL(VLD(m->pos_x + i), VSET(inv_cell))));
+        VST(e->grid_y + i, VFLOOR(VMUL(VLD(m->pos_y + i), VSET(inv_cell))));
+    }
+    return i;
+}
+
+SIMD_FN int VK(engine_end_timer_tick)(EngineSoA *e, float dt)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW) {
+        vf timer = VLD(e->end_timer + i);
+        vf next  = CLAMP(VSUB(timer, VSET(dt)), VSET(0.0f), VSET(1e6f));
+        VST(e->end_timer + i, VSEL(VLT(VLD(e->stability + i), VSET(0.1f)), next, timer));
+    }
+    return i;
+}
+
+SIMD_FN int VK(engine_victory_pts_update)(EngineSoA *e, const PopSoA *p, const TechSoA *t)
+{
+    int n = e->count;
+    if (p->count < n) n = p->count;
+    if (t->count < n) n = t->count;
+    int i = 0;
+    for (; i + VW <= n; i += VW) {
+        vf pts = VADD(VMUL(VLD(p->population + i), VSET(0.001f)), VLD(t->tech_level + i));
+        VST(e->victory_pts + i, VADD(VLD(e->victory_pts + i), pts));
+    }
+    return i;
+}
+
+SIMD_FN int VK(engine_end_condition_check)(const EngineSoA *e, int *end_flags)
+{
+    int i = 0;
+    for (; i + VW <= e->count; i += VW)
+        VIST(end_flags + i, FLAG(VLE(VLD(e->end_timer + i), VSET(0.0f))));
+    return i;
+}
+
+/* ======================================================================
+   TABLE
+   ====================================================================== */
+static const SimSimd SIMD_CAT(sim_simd, SIMD_SFX) = {
+    .pop_logistic_growth        = VK(pop_logistic_growth),
+    .pop_sir_step               = VK(pop_sir_step),
+    .pop_starvation             = VK(pop_starvation),
+    .pop_age_cohort_shift       = VK(pop_age_cohort_shift),
+    .pop_birth_rate             = VK(pop_birth_rate),
+    .pop_death_rate             = VK(pop_death_rate),
+    .pop_carrying_cap_pressure  = VK(pop_carrying_cap_pressure),
+    .pop_epidemic_mortality     = VK(pop_epidemic_mortality),
+    .pop_recovery_bonus         = VK(pop_recovery_bonus),
+    .pop_tick                   = VK(pop_tick),
+    .faith_generate             = VK(faith_generate),
+    .faith_mana_regen           = VK(faith_mana_regen),
+    .faith_heresy_spread        = VK(faith_heresy_spread),
+    .faith_miracle_check        = VK(faith_miracle_check),
+    .faith_conversion_tick      = VK(faith_conversion_tick),
+    .faith_schism_accumulate    = VK(faith_schism_accumulate),
+    .faith_divine_favor_update  = VK(faith_divine_favor_update),
+    .faith_temple_bonus         = VK(faith_temple_bonus),
+    .faith_devotee_update       = VK(faith_devotee_update),
+    .combat_armor_mitigation    = VK(combat_armor_mitigation),
+    .combat_morale_decay        = VK(combat_morale_decay),
+    .combat_rout_check          = VK(combat_rout_check),
+    .combat_hp_regen            = VK(combat_hp_regen),
+    .combat_aoe_damage          = VK(combat_aoe_damage),
+    .econ_gather                = VK(econ_gather),
+    .econ_deplete               = VK(econ_deplete),
+    .econ_market_price          = VK(econ_market_price),
+    .econ_collect_tax           = VK(econ_collect_tax),
+    .econ_resource_cap          = VK(econ_resource_cap),
+    .econ_demand_update         = VK(econ_demand_update),
+    .econ_supply_shock          = VK(econ_supply_shock),
+    .econ_inflation             = VK(econ_inflation),
+    .econ_scarcity_penalty      = VK(econ_scarcity_penalty),
+    .env_temperature_diffuse    = VK(env_temperature_diffuse),
+    .env_rainfall_update        = VK(env_rainfall_update),
+    .env_fire_spread            = VK(env_fire_spread),
+    .env_fire_consume           = VK(env_fire_consume),
+    .env_humidity_evaporate     = VK(env_humidity_evaporate),
+    .env_wind_advect            = VK(env_wind_advect),
+    .env_pressure_gradient      = VK(env_pressure_gradient),
+    .env_elevation_temp_bias    = VK(env_elevation_temp_bias),
+    .env_drought_check          = VK(env_drought_check),
+    .env_flood_check            = VK(env_flood_check),
+    .move_velocity_verlet       = VK(move_velocity_verlet),
+    .move_flock_separation      = VK(move_flock_separation),
+    .move_flock_alignment       = VK(move_flock_alignment),
+    .move_flock_cohesion        = VK(move_flock_cohesion),
+    .move_flock_combined        = VK(move_flock_combined),
+    .move_clamp_speed           = VK(move_clamp_speed),
+    .divine_energy_regen        = VK(divine_energy_regen),
+    .divine_heal_decay          = VK(divine_heal_decay),
+    .divine_cooldown_tick       = VK(divine_cooldown_tick),
+    .divine_energy_cap          = VK(divine_energy_cap),
+    .divine_favor_scale         = VK(divine_favor_scale),
+    .psych_utility_evaluate     = VK(psych_utility_evaluate),
+    .psych_fear_decay           = VK(psych_fear_decay),
+    .psych_happiness_update     = VK(psych_happiness_update),
+    .psych_social_bond_update   = VK(psych_social_bond_update),
+    .psych_memory_fade          = VK(psych_memory_fade),
+    .psych_morale_from_psych    = VK(psych_morale_from_psych),
+    .psych_defection_check      = VK(psych_defection_check),
+    .tech_research_tick         = VK(tech_research_tick),
+    .tech_unlock_check          = VK(tech_unlock_check),
+    .tech_golden_age_tick       = VK(tech_golden_age_tick),
+    .tech_culture_spread        = VK(tech_culture_spread),
+    .tech_era_advance           = VK(tech_era_advance),
+    .tech_decay                 = VK(tech_decay),
+    .engine_fast_inv_sqrt       = VK(engine_fast_inv_sqrt),
+    .engine_entropy_increase    = VK(engine_entropy_increase),
+    .engine_stability_update    = VK(engine_stability_update),
+    .engine_spatial_grid_assign = VK(engine_spatial_grid_assign),
+    .engine_end_timer_tick      = VK(engine_end_timer_tick),
+    .engine_victory_pts_update  = VK(engine_victory_pts_update),
+    .engine_end_condition_check = VK(engine_end_condition_check),
+};
+
+#undef FLAG
+#undef CLAMP
+#undef FINVSQRT
+#undef SIMD_FN
+#undef VK
+#undef SIMD_CAT
+#undef SIMD_CAT_
+#undef SIMD_ISA
+#undef SIMD_SFX
+#undef VW
+#undef vf
+#undef vi
+#undef VLD
+#undef VST
+#undef VSET
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VDIV
+#undef VMIN
+#undef VSQRT
+#undef VFLOOR
+#undef VLT
+#undef VGT
+#undef VLE
+#undef VGE
+#undef VAND
+#undef VOR
+#undef VANDN
+#undef VSEL
+#undef VISET
+#undef VIOTA
+#undef VIADD
+#undef VISUB
+#undef VIMUL
+#undef VIAND
+#undef VIXOR
+#undef VISRL
+#undef VIEQ
+#undef VI2F
+#undef VASI
+#undef VASF
+#undef VIST
@@ -0,0 +1,245 @@
+// Copyright (c) dobbypr. All rights reserved.
+// Unauthorized copying or distribution of this file, via any medium, is strictly prohibited.
+// See the LICENSE file for permitted use.
+
+/*
+ * simulation_soa.c — Create, resize and destroy for the ten SoAs.
+ *
+ * A SoA is two allocations: the struct itself, which callers hold on to,
+ * and one aligned block holding every array back to back at a fixed
+ * stride.  Array k starts at arena + k * stride, so resizing can copy and
+ * zero arrays without reading the pointers back out of the struct.  The
+ * per-SoA code below is only a table of member offsets; one generic
+ * implementation does the work for all of them.
+ */
+
+#include "simulation.h"
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SOA_ALIGN  64                    /* cache line; also the AVX-512 width   */
+#define SOA_LANES  (SOA_ALIGN / 4)       /* elements per cache line              */
+#define SOA_PAGE   4096
+
+/* Every SoA array holds 4-byte elements; the stride maths relies on it. */
+_Static_assert(sizeof(float) == 4 && sizeof(uint32_t) == 4, "SoA elements must be 4 bytes");
+
+typedef struct {
+    size_t        size;                  /* sizeof the SoA struct                */
+    const size_t *fields;                /* offsetof each array pointer          */
+    int           nfields;
+    size_t        count, arena, capacity;/* offsetof the bookkeeping members     */
+} SoaLayout;
+
+#define SOA_LAYOUT(T, fields) \
+    { sizeof(T), fields, (int)(sizeof(fields) / sizeof(fields[0])), \
+      offsetof(T, count), offsetof(T, arena), offsetof(T, capacity) }
+
+/* ======================================================================
+   GENERIC IMPLEMENTATION
+   ====================================================================== */
+
+/* Bytes from one array to the next for `count` elements, and the capacity
+   that gives each array.  Rounded up to whole cache lines; arrays of a
+   page or more are rounded up to whole pages plus one line, so array k
+   sits k lines further into its page than array 0 and no two of a SoA's
+   arrays compete for the same cache sets.  Returns -1 if too large. */
+static int soa_stride(int count, size_t *stride, int *capacity)
+{
+    if (count < 0 || count > INT_MAX / 2) return -1;
+    size_t bytes = ((size_t)(count > 0 ? count : 1) + SOA_LANES - 1) / SOA_LANES * SOA_ALIGN;
+    if (bytes >= SOA_PAGE) bytes = (bytes + SOA_PAGE - 1) / SOA_PAGE * SOA_PAGE + SOA_ALIGN;
+    *stride   = bytes;
+    *capacity = (int)(bytes / 4);
+    return 0;
+}
+
+static int  *soa_count(const SoaLayout *L, void *s)    { return (int *)((char *)s + L->count); }
+static void **soa_arena(const SoaLayout *L, void *s)   { return (void **)((char *)s + L->arena); }
+static int  *soa_capacity(const SoaLayout *L, void *s) { return (int *)((char *)s + L->capacity); }
+
+/* Point every array member of `s` into `block`.  The members are float *
+   or uint32_t *; both have the representation of the char * written. */
+static void soa_place(const SoaLayout *L, void *s, char *block, size_t stride)
+{
+    for (int k = 0; k < L->nfields; k++) {
+        char *a = block + (size_t)k * stride;
+        memcpy((char *)s + L->fields[k], &a, sizeof(a));
+    }
+}
+
+static char *soa_block(const SoaLayout *L, size_t stride)
+{
+    char *block = aligned_alloc(SOA_ALIGN, stride * (size_t)L->nfields);
+    if (block) memset(block, 0, stride * (size_t)L->nfields);
+    return block;
+}
+
+static void *soa_create(const SoaLayout *L, int count)
+{
+    size_t stride;
+    int    cap;
+    if (soa_stride(count, &stride, &cap) != 0) return NULL;
+    void *s     = calloc(1, L->size);
+    char *block = soa_block(L, stride);
+    if (!s || !block) {
+        free(s);
+        free(block);
+        return NULL;
+    }
+    soa_place(L, s, block, stride);
+    *soa_count(L, s)    = count;
+    *soa_arena(L, s)    = block;
+    *soa_capacity(L, s) = cap;
+    return s;
+}
+
+static int soa_resize(const SoaLayout *L, void *s, int count)
+{
+    char  *old = *soa_arena(L, s);
+    int    n   = *soa_count(L, s);
+    int    cap = *soa_capacity(L, s);
+    size_t old_stride = (size_t)cap * 4;
+    if (!old || count < 0) return -1;
+
+    if (count <= cap) {
+        /* Fits: keep the block, just clear what falls off the end. */
+        if (count < n)
+            for (int k = 0; k < L->nfields; k++)
+                memset(old + (size_t)k * old_stride + (size_t)count * 4, 0,
+                       (size_t)(n - count) * 4);
+        *soa_count(L, s) = count;
+        return 0;
+    }
+
+    size_t stride;
+    if (soa_stride(count, &stride, &cap) != 0) return -1;
+    char *block = soa_block(L, stride);
+    if (!block) return -1;
+    for (int k = 0; k < L->nfields; k++)
+        memcpy(block + (size_t)k * stride, old + (size_t)k * old_stride, (size_t)n * 4);
+    free(old);
+    soa_place(L, s, block, stride);
+    *soa_count(L, s)    = count;
+    *soa_arena(L, s)    = block;
+    *soa_capacity(L, s) = cap;
+    return 0;
+}
+
+static void soa_destroy(const SoaLayout *L, void *s)
+{
+    if (!s) return;
+    free(*soa_arena(L, s));
+    free(s);
+}
+
+/* ======================================================================
+   LAYOUTS — array members of each SoA, in declaration order
+   ====================================================================== */
+static const size_t pop_fields[] = {
+    offsetof(PopSoA, population),   offsetof(PopSoA, carrying_cap),
+    offsetof(PopSoA, growth_rate),  offsetof(PopSoA, susceptible),
+    offsetof(PopSoA, infected),     offsetof(PopSoA, recovered),
+    offsetof(PopSoA, beta),         offsetof(PopSoA, gamma_rec),
+    offsetof(PopSoA, food_supply),  offsetof(PopSoA, food_threshold),
+    offsetof(PopSoA, age_young),    offsetof(PopSoA, age_adult),
+    offsetof(PopSoA, age_elder),
+};
+static const size_t faith_fields[] = {
+    offsetof(FaithSoA, faith_level),    offsetof(FaithSoA, mana),
+    offsetof(FaithSoA, mana_regen),     offsetof(FaithSoA, heresy_rate),
+    offsetof(FaithSoA, miracle_chance), offsetof(FaithSoA, devotee_count),
+    offsetof(FaithSoA, temple_count),   offsetof(FaithSoA, schism_risk),
+    offsetof(FaithSoA, conversion_rate), offsetof(FaithSoA, divine_favor),
+};
+static const size_t combat_fields[] = {
+    offsetof(CombatSoA, base_atk),     offsetof(CombatSoA, armor),
+    offsetof(CombatSoA, hp),           offsetof(CombatSoA, max_hp),
+    offsetof(CombatSoA, morale),       offsetof(CombatSoA, morale_decay),
+    offsetof(CombatSoA, hit_chance),   offsetof(CombatSoA, crit_chance),
+    offsetof(CombatSoA, crit_mult),    offsetof(CombatSoA, rout_threshold),
+};
+static const size_t econ_fields[] = {
+    offsetof(EconSoA, resource),       offsetof(EconSoA, max_resource),
+    offsetof(EconSoA, gather_rate),    offsetof(EconSoA, depletion_rate),
+    offsetof(EconSoA, price),          offsetof(EconSoA, demand),
+    offsetof(EconSoA, supply),         offsetof(EconSoA, tax_rate),
+    offsetof(EconSoA, tax_collected),  offsetof(EconSoA, trade_volume),
+};
+static const size_t env_fields[] = {
+    offsetof(EnvSoA, temperature),     offsetof(EnvSoA, temp_target),
+    offsetof(EnvSoA, rainfall),        offsetof(EnvSoA, humidity),
+    offsetof(EnvSoA, wind_x),          offsetof(EnvSoA, wind_y),
+    offsetof(EnvSoA, fire_intensity),  offsetof(EnvSoA, fuel),
+    offsetof(EnvSoA, elevation),       offsetof(EnvSoA, pressure),
+};
+static const size_t move_fields[] = {
+    offsetof(MoveSoA, pos_x),          offsetof(MoveSoA, pos_y),
+    offsetof(MoveSoA, vel_x),          offsetof(MoveSoA, vel_y),
+    offsetof(MoveSoA, acc_x),          offsetof(MoveSoA, acc_y),
+    offsetof(MoveSoA, heading),        offsetof(MoveSoA, speed),
+    offsetof(MoveSoA, max_speed),      offsetof(MoveSoA, h_cost),
+};
+static const size_t divine_fields[] = {
+    offsetof(DivineSoA, energy),         offsetof(DivineSoA, energy_cap),
+    offsetof(DivineSoA, regen_rate),     offsetof(DivineSoA, meteor_cost),
+    offsetof(DivineSoA, heal_amount),    offsetof(DivineSoA, heal_decay),
+    offsetof(DivineSoA, terraform_cost), offsetof(DivineSoA, smite_power),
+    offsetof(DivineSoA, blessing_mult),  offsetof(DivineSoA, cooldown),
+};
+static const size_t psych_fields[] = {
+    offsetof(PsychSoA, happiness),     offsetof(PsychSoA, fear),
+    offsetof(PsychSoA, loyalty),       offsetof(PsychSoA, aggression),
+    offsetof(PsychSoA, utility_work),  offsetof(PsychSoA, utility_fight),
+    offsetof(PsychSoA, utility_flee),  offsetof(PsychSoA, threat_level),
+    offsetof(PsychSoA, memory_decay),  offsetof(PsychSoA, social_bond),
+};
+static const size_t tech_fields[] = {
+    offsetof(TechSoA, research_pts),    offsetof(TechSoA, research_rate),
+    offsetof(TechSoA, tech_cost),       offsetof(TechSoA, tech_level),
+    offsetof(TechSoA, golden_age_mult), offsetof(TechSoA, golden_age_timer),
+    offsetof(TechSoA, culture),         offsetof(TechSoA, culture_spread),
+    offsetof(TechSoA, era),             offsetof(TechSoA, pop_bonus),
+};
+static const size_t engine_fields[] = {
+    offsetof(EngineSoA, entropy),      offsetof(EngineSoA, entropy_rate),
+    offsetof(EngineSoA, grid_x),       offsetof(EngineSoA, grid_y),
+    offsetof(EngineSoA, inv_sqrt_val), offsetof(EngineSoA, inv_sqrt_out),
+    offsetof(EngineSoA, stability),    offsetof(EngineSoA, end_timer),
+    offsetof(EngineSoA, victory_pts),  offsetof(EngineSoA, chaos_mult),
+    offsetof(EngineSoA, rng_state),
+};
+
+static const SoaLayout pop_layout    = SOA_LAYOUT(PopSoA,    pop_fields);
+static const SoaLayout faith_layout  = SOA_LAYOUT(FaithSoA,  faith_fields);
+static const SoaLayout combat_layout = SOA_LAYOUT(CombatSoA, combat_fields);
+static const SoaLayout econ_layout   = SOA_LAYOUT(EconSoA,   econ_fields);
+static const SoaLayout env_layout    = SOA_LAYOUT(EnvSoA,    env_fields);
+static const SoaLayout move_layout   = SOA_LAYOUT(MoveSoA,   move_fields);
+static const SoaLayout divine_layout = SOA_LAYOUT(DivineSoA, divine_fields);
+static const SoaLayout psych_layout  = SOA_LAYOUT(PsychSoA,  psych_fields);
+static const SoaLayout tech_layout   = SOA_LAYOUT(TechSoA,   tech_fields);
+static const SoaLayout engine_layout = SOA_LAYOUT(EngineSoA, engine_fields);
+
+/* ======================================================================
+   PUBLIC API
+   ====================================================================== */
+#define SOA_API(T, name)                                                       \
+    T   *name##_soa_create(int count)    { return soa_create(&name##_layout, count); } \
+    int  name##_soa_resize(T *s, int count) { return soa_resize(&name##_layout, s, count); } \
+    void name##_soa_destroy(T *s)        { soa_destroy(&name##_layout, s); }
+
+SOA_API(PopSoA,    pop)
+SOA_API(FaithSoA,  faith)
+SOA_API(CombatSoA, combat)
+SOA_API(EconSoA,   econ)
+SOA_API(EnvSoA,    env)
+SOA_API(MoveSoA,   move)
+SOA_API(DivineSoA, divine)
+SOA_API(PsychSoA,  psych)
+SOA_API(TechSoA,   tech)
+SOA_API(EngineSoA, engine)